@@ -8,16 +8,18 @@
 #ifndef BEAST_EXAMPLE_HTTP_ASYNC_SERVER_H_INCLUDED
 #define BEAST_EXAMPLE_HTTP_ASYNC_SERVER_H_INCLUDED
 
-#include "file_body.hpp"
 #include "mime_type.hpp"
 
 #include <beast/http.hpp>
+#include <beast/http/file_body.hpp>
 #include <beast/core/handler_helpers.hpp>
 #include <beast/core/handler_ptr.hpp>
 #include <beast/core/placeholders.hpp>
 #include <beast/core/streambuf.hpp>
 #include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
 #include <memory>
@@ -86,6 +88,69 @@ public:
     }
 
 private:
+    enum class range
+    {
+        none,
+        satisfiable,
+        unsatisfiable
+    };
+
+    // Parse a Range field holding a single byte range, one of
+    // "bytes=first-last", "bytes=first-" or "bytes=-suffix".
+    // Anything else is ignored and the whole file is sent.
+    static
+    range
+    parse_range(boost::string_ref s, std::uint64_t size,
+        std::uint64_t& first, std::uint64_t& count)
+    {
+        if(! s.starts_with("bytes="))
+            return range::none;
+        s.remove_prefix(6);
+        auto const parse =
+            [&](std::uint64_t& v)
+            {
+                if(s.empty() || s.front() < '0' || s.front() > '9')
+                    return false;
+                v = 0;
+                while(! s.empty() && s.front() >= '0' && s.front() <= '9')
+                {
+                    if(v > (std::uint64_t(-1) - 9) / 10)
+                        return false;
+                    v = v * 10 + (s.front() - '0');
+                    s.remove_prefix(1);
+                }
+                return true;
+            };
+        std::uint64_t last;
+        if(s.starts_with("-"))
+        {
+            s.remove_prefix(1);
+            std::uint64_t suffix;
+            if(! parse(suffix) || ! s.empty())
+                return range::none;
+            if(suffix == 0 || size == 0)
+                return range::unsatisfiable;
+            if(suffix > size)
+                suffix = size;
+            first = size - suffix;
+            count = suffix;
+            return range::satisfiable;
+        }
+        if(! parse(first) || ! s.starts_with("-"))
+            return range::none;
+        s.remove_prefix(1);
+        if(s.empty())
+            last = size - 1;
+        else if(! parse(last) || ! s.empty() || last < first)
+            return range::none;
+        if(first >= size)
+            return range::unsatisfiable;
+        if(last >= size)
+            last = size - 1;
+        count = last - first + 1;
+        return range::satisfiable;
+    }
+
     template<class Stream, class Handler,
         bool isRequest, class Body, class Fields>
     class write_op
@@ -247,12 +312,40 @@ private:
             try
             {
                 resp_type res;
-                res.status = 200;
-                res.reason = "OK";
                 res.version = req_.version;
                 res.fields.insert("Server", "http_async_server");
                 res.fields.insert("Content-Type", mime_type(path));
-                res.body = path;
+                res.fields.insert("Accept-Ranges", "bytes");
+                res.body.open(path);
+                auto const size = res.body.file_size();
+                std::uint64_t first;
+                std::uint64_t count;
+                switch(parse_range(
+                    req_.fields["Range"], size, first, count))
+                {
+                case range::none:
+                    res.status = 200;
+                    res.reason = "OK";
+                    break;
+
+                case range::satisfiable:
+                    res.status = 206;
+                    res.reason = "Partial Content";
+                    res.fields.insert("Content-Range", "bytes " +
+                        std::to_string(first) + "-" +
+                        std::to_string(first + count - 1) + "/" +
+                        std::to_string(size));
+                    res.body.range(first, count);
+                    break;
+
+                case range::unsatisfiable:
+                    res.status = 416;
+                    res.reason = "Range Not Satisfiable";
+                    res.fields.insert("Content-Range",
+                        "bytes */" + std::to_string(size));
+                    res.body.range(0, 0);
+                    break;
+                }
                 prepare(res);
                 async_write(sock_, std::move(res),
                     std::bind(&peer::on_write, shared_from_this(),
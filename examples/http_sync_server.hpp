@@ -8,13 +8,14 @@
 #ifndef BEAST_EXAMPLE_HTTP_SYNC_SERVER_H_INCLUDED
 #define BEAST_EXAMPLE_HTTP_SYNC_SERVER_H_INCLUDED
 
-#include "file_body.hpp"
 #include "mime_type.hpp"
 
 #include <beast/http.hpp>
+#include <beast/http/file_body.hpp>
 #include <beast/core/placeholders.hpp>
 #include <beast/core/streambuf.hpp>
 #include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
 #include <cstdint>
 #include <cstdio>
 #include <functional>
@@ -185,7 +186,7 @@ private:
                 res.version = req.version;
                 res.fields.insert("Server", "http_sync_server");
                 res.fields.insert("Content-Type", mime_type(path));
-                res.body = path;
+                res.body.open(path);
                 prepare(res);
                 write(sock, res, ec);
                 if(ec)
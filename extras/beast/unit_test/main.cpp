@@ -92,6 +92,7 @@ int main(int ac, char const* av[])
        ("help,h",  "Produce a help message")
        ("print,p", "Print the list of available test suites")
        ("suites,s", po::value<string>(), "suites to run")
+       ("arg,a", po::value<string>(), "argument string for the suites")
         ;
 
     po::positional_options_description p;
@@ -116,6 +117,8 @@ int main(int ac, char const* av[])
         if(vm.count("suites") > 0)
             suites = vm["suites"].as<string>();
         reporter r(log);
+        if(vm.count("arg") > 0)
+            r.arg(vm["arg"].as<string>());
         bool failed;
         if(! suites.empty())
             failed = r.run_each_if(global_suites(),
@@ -100,6 +100,20 @@ ci_equal(S1 const& lhs, S2 const& rhs)
             ci_equal_pred{});
 }
 
+// Case-insensitive hash (FNV-1a on the lower case octets)
+inline
+std::uint32_t
+ci_hash(boost::string_ref const& s) noexcept
+{
+    std::uint32_t h = 2166136261u;
+    for(auto const c : s)
+    {
+        h ^= static_cast<std::uint8_t>(tolower(c));
+        h *= 16777619u;
+    }
+    return h;
+}
+
 } // detail
 } // beast
 
@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_CORE_DETAIL_CPU_INFO_HPP
+#define BEAST_CORE_DETAIL_CPU_INFO_HPP
+
+#include <cstdint>
+
+/*  Vectorized code paths are compiled in only on x86/x64 and only
+    when BEAST_NO_SIMD is not defined. SSE2 is part of the x64 ABI;
+    everything else is chosen at run time using cpu_info, so binaries
+    built without -mavx2 still get the wide kernels when the CPU has
+    them.
+*/
+#if ! defined(BEAST_NO_SIMD) && ( \
+    defined(__x86_64__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+# define BEAST_DETAIL_X86 1
+#else
+# define BEAST_DETAIL_X86 0
+#endif
+
+#if BEAST_DETAIL_X86
+# if defined(_MSC_VER)
+#  include <intrin.h>
+#  define BEAST_DETAIL_TARGET(isa)
+# else
+#  include <cpuid.h>
+#  define BEAST_DETAIL_TARGET(isa) __attribute__((target(isa)))
+# endif
+# include <immintrin.h>
+#endif
+
+namespace beast {
+namespace detail {
+
+/*  Instruction set extensions available at run time.
+
+    The value is computed once, on first use.
+*/
+struct cpu_info
+{
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool sse42 = false;
+    bool pclmul = false;
+    bool avx2 = false;
+
+    cpu_info()
+    {
+#if BEAST_DETAIL_X86
+        std::uint32_t r[4];
+        cpuid(r, 0);
+        auto const max = r[0];
+        if(max < 1)
+            return;
+        cpuid(r, 1);
+        sse2   = (r[3] & (1u << 26)) != 0;
+        ssse3  = (r[2] & (1u <<  9)) != 0;
+        sse41  = (r[2] & (1u << 19)) != 0;
+        sse42  = (r[2] & (1u << 20)) != 0;
+        pclmul = (r[2] & (1u <<  1)) != 0;
+        // AVX state must be enabled by the OS
+        bool const osxsave = (r[2] & (1u << 27)) != 0;
+        bool const avx = (r[2] & (1u << 28)) != 0;
+        if(max < 7 || ! osxsave || ! avx ||
+                (xgetbv() & 6) != 6)
+            return;
+        cpuid(r, 7);
+        avx2   = (r[1] & (1u <<  5)) != 0;
+#endif
+    }
+
+private:
+#if BEAST_DETAIL_X86
+    static
+    void
+    cpuid(std::uint32_t (&r)[4], std::uint32_t leaf)
+    {
+#if defined(_MSC_VER)
+        int v[4];
+        __cpuidex(v, static_cast<int>(leaf), 0);
+        for(int i = 0; i < 4; ++i)
+            r[i] = static_cast<std::uint32_t>(v[i]);
+#else
+        __cpuid_count(leaf, 0, r[0], r[1], r[2], r[3]);
+#endif
+    }
+
+    static
+    std::uint64_t
+    xgetbv()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        std::uint32_t lo, hi;
+        __asm__ __volatile__ ("xgetbv" :
+            "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<std::uint64_t>(hi) << 32) | lo;
+#endif
+    }
+#endif
+};
+
+/// Returns the instruction set extensions of the running CPU
+inline
+cpu_info const&
+get_cpu_info()
+{
+    static cpu_info const ci;
+    return ci;
+}
+
+} // detail
+} // beast
+
+#endif
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_CORE_DETAIL_CTZ_HPP
+#define BEAST_CORE_DETAIL_CTZ_HPP
+
+#include <boost/assert.hpp>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+namespace beast {
+namespace detail {
+
+// Returns the number of trailing zero bits, x must not be zero
+//
+inline
+unsigned
+ctz(std::uint32_t x)
+{
+    BOOST_ASSERT(x != 0);
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, x);
+    return static_cast<unsigned>(i);
+#elif defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctz(x));
+#else
+    unsigned n = 0;
+    while(! (x & 1))
+    {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline
+unsigned
+ctz(std::uint64_t x)
+{
+    BOOST_ASSERT(x != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<unsigned>(i);
+#elif defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    auto const lo = static_cast<std::uint32_t>(x);
+    if(lo)
+        return ctz(lo);
+    return 32 + ctz(static_cast<std::uint32_t>(x >> 32));
+#endif
+}
+
+} // detail
+} // beast
+
+#endif
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_DETAIL_MEMORY_HANDLER_HPP
+#define BEAST_DETAIL_MEMORY_HANDLER_HPP
+
+#include <beast/core/handler_helpers.hpp>
+#include <beast/core/handler_memory.hpp>
+#include <cstddef>
+#include <utility>
+
+namespace beast {
+namespace detail {
+
+/*  Handler that allocates from a handler_memory.
+
+    Memory which the handler_memory cannot provide comes from the
+    allocation hooks of the wrapped handler. The wrapper provides
+    the same io_service execution guarantees as the original handler.
+*/
+template<class Handler>
+class memory_handler
+{
+    handler_memory* m_;
+    Handler h_;
+
+public:
+    using result_type = void;
+
+    template<class DeducedHandler>
+    memory_handler(handler_memory& m,
+            DeducedHandler&& handler)
+        : m_(&m)
+        , h_(std::forward<DeducedHandler>(handler))
+    {
+    }
+
+    template<class... Args>
+    void
+    operator()(Args&&... args)
+    {
+        h_(std::forward<Args>(args)...);
+    }
+
+    friend
+    void*
+    asio_handler_allocate(
+        std::size_t size, memory_handler* h)
+    {
+        if(auto const p = h->m_->allocate(size))
+            return p;
+        return beast_asio_helpers::
+            allocate(size, h->h_);
+    }
+
+    friend
+    void
+    asio_handler_deallocate(
+        void* p, std::size_t size, memory_handler* h)
+    {
+        if(h->m_->deallocate(p))
+            return;
+        beast_asio_helpers::
+            deallocate(p, size, h->h_);
+    }
+
+    friend
+    bool
+    asio_handler_is_continuation(memory_handler* h)
+    {
+        return beast_asio_helpers::
+            is_continuation(h->h_);
+    }
+
+    template<class F>
+    friend
+    void
+    asio_handler_invoke(F&& f, memory_handler* h)
+    {
+        beast_asio_helpers::
+            invoke(f, h->h_);
+    }
+};
+
+} // detail
+} // beast
+
+#endif
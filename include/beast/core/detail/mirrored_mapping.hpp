@@ -0,0 +1,255 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_DETAIL_MIRRORED_MAPPING_HPP
+#define BEAST_DETAIL_MIRRORED_MAPPING_HPP
+
+#include <beast/core/error.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#if ! defined(BEAST_MIRRORED_MAPPING_POSIX)
+# if defined(__unix__) || defined(__APPLE__)
+#  define BEAST_MIRRORED_MAPPING_POSIX 1
+# else
+#  define BEAST_MIRRORED_MAPPING_POSIX 0
+# endif
+#endif
+
+#if BEAST_MIRRORED_MAPPING_POSIX
+# include <atomic>
+# include <cstdio>
+# include <cstdlib>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+# if ! defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+#else
+# include <memory>
+#endif
+
+namespace beast {
+namespace detail {
+
+#if BEAST_MIRRORED_MAPPING_POSIX
+
+// Memory of `size` bytes mapped twice, back to back, so
+// that data()[i] and data()[i + size] are the same byte.
+//
+class mirrored_mapping
+{
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+public:
+    // True if data() is followed by its mirror
+    static bool constexpr mirrored = true;
+
+    mirrored_mapping() = default;
+    mirrored_mapping(mirrored_mapping const&) = delete;
+    mirrored_mapping& operator=(mirrored_mapping const&) = delete;
+
+    ~mirrored_mapping()
+    {
+        unmap();
+    }
+
+    mirrored_mapping(mirrored_mapping&& other)
+        : data_(other.data_)
+        , size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    mirrored_mapping&
+    operator=(mirrored_mapping&& other)
+    {
+        if(this != &other)
+        {
+            unmap();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    static
+    std::size_t
+    granularity()
+    {
+        auto const n = ::sysconf(_SC_PAGESIZE);
+        return n > 0 ? static_cast<std::size_t>(n) : 4096;
+    }
+
+    char*
+    data() const
+    {
+        return data_;
+    }
+
+    // `size` must be a multiple of granularity()
+    void
+    map(std::size_t size, error_code& ec)
+    {
+        unmap();
+        int const fd = open_shared(ec);
+        if(ec)
+            return;
+        if(::ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            ec = last_error();
+            ::close(fd);
+            return;
+        }
+        // Reserve twice the size, then map the
+        // same pages over each half of the range.
+        auto const base = static_cast<char*>(::mmap(nullptr,
+            2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if(base == MAP_FAILED)
+        {
+            ec = last_error();
+            ::close(fd);
+            return;
+        }
+        for(int i = 0; i < 2; ++i)
+        {
+            auto const p = ::mmap(base + i * size, size,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            if(p == MAP_FAILED)
+            {
+                ec = last_error();
+                ::munmap(base, 2 * size);
+                ::close(fd);
+                return;
+            }
+        }
+        ::close(fd);
+        data_ = base;
+        size_ = size;
+    }
+
+    void
+    unmap()
+    {
+        if(data_)
+        {
+            ::munmap(data_, 2 * size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+private:
+    static
+    error_code
+    last_error()
+    {
+        return error_code{errno,
+            boost::system::generic_category()};
+    }
+
+    // Returns an anonymous shared memory descriptor
+    static
+    int
+    open_shared(error_code& ec)
+    {
+    #if defined(__linux__)
+    # if defined(MFD_CLOEXEC)
+        int const fd = ::memfd_create("beast", MFD_CLOEXEC);
+        if(fd != -1)
+            return fd;
+        if(errno != ENOSYS)
+        {
+            ec = last_error();
+            return -1;
+        }
+    # endif
+        // Older kernels, use an unlinked file in tmpfs
+        char name[] = "/dev/shm/beast.XXXXXX";
+        int const tfd = ::mkstemp(name);
+        if(tfd == -1)
+        {
+            ec = last_error();
+            return -1;
+        }
+        ::unlink(name);
+        return tfd;
+    #else
+        static std::atomic<unsigned> seq{0};
+        for(;;)
+        {
+            char name[64];
+            std::snprintf(name, sizeof(name), "/beast.%ld.%u",
+                static_cast<long>(::getpid()), ++seq);
+            int const fd = ::shm_open(name,
+                O_RDWR | O_CREAT | O_EXCL, 0600);
+            if(fd != -1)
+            {
+                ::shm_unlink(name);
+                return fd;
+            }
+            if(errno != EEXIST)
+            {
+                ec = last_error();
+                return -1;
+            }
+        }
+    #endif
+    }
+};
+
+#else
+
+// Fallback with no mirror. The buffer using it must
+// move its contents rather than wrap around the end.
+//
+class mirrored_mapping
+{
+    std::unique_ptr<char[]> p_;
+
+public:
+    // True if data() is followed by its mirror
+    static bool constexpr mirrored = false;
+
+    static
+    std::size_t
+    granularity()
+    {
+        return 4096;
+    }
+
+    char*
+    data() const
+    {
+        return p_.get();
+    }
+
+    void
+    map(std::size_t size, error_code&)
+    {
+        p_.reset(new char[size]);
+    }
+
+    void
+    unmap()
+    {
+        p_.reset();
+    }
+};
+
+#endif
+
+} // detail
+} // beast
+
+#endif
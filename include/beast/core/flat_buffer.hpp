@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_FLAT_BUFFER_HPP
+#define BEAST_FLAT_BUFFER_HPP
+
+#include <beast/core/detail/empty_base_optimization.hpp>
+#include <boost/asio/buffer.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace beast {
+
+/** A @b `DynamicBuffer` that uses a single contiguous buffer.
+
+    The input sequence is always represented by a single buffer,
+    so algorithms which must see a complete piece of data, such as
+    a header line presented to a parser, never have to accumulate
+    fragments. This is also what @ref http::header_view_parser_v1
+    requires of the octets it indexes.
+
+    When the output sequence does not fit after the input, the
+    input is moved to the front of the storage. If it still does
+    not fit, a larger buffer is allocated and the input is copied
+    into it.
+
+    Unlike @ref basic_streambuf, @ref prepare invalidates buffers
+    representing the input sequence which were obtained earlier.
+
+    @note Meets the requirements of @b DynamicBuffer.
+
+    @tparam Allocator The allocator to use for managing memory.
+*/
+template<class Allocator>
+class basic_flat_buffer
+#if ! GENERATING_DOCS
+    : private detail::empty_base_optimization<
+        typename std::allocator_traits<Allocator>::
+            template rebind_alloc<char>>
+#endif
+{
+public:
+#if GENERATING_DOCS
+    /// The type of allocator used.
+    using allocator_type = Allocator;
+#else
+    using allocator_type = typename
+        std::allocator_traits<Allocator>::
+            template rebind_alloc<char>;
+#endif
+
+private:
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    char* begin_ = nullptr;
+    char* in_ = nullptr;
+    char* out_ = nullptr;
+    char* last_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t max_;
+
+public:
+    /// The type used to represent the input sequence as a list of buffers.
+    using const_buffers_type = boost::asio::const_buffers_1;
+
+    /// The type used to represent the output sequence as a list of buffers.
+    using mutable_buffers_type = boost::asio::mutable_buffers_1;
+
+    /// Destructor.
+    ~basic_flat_buffer();
+
+    /** Move constructor.
+
+        The new object will have the input sequence of
+        the other stream buffer, and an empty output sequence.
+
+        @note After the move, the moved-from object will have
+        an empty input and output sequence, with no internal
+        buffers allocated.
+    */
+    basic_flat_buffer(basic_flat_buffer&&);
+
+    /** Move assignment.
+
+        This object will have the input sequence of
+        the other stream buffer, and an empty output sequence.
+
+        @note After the move, the moved-from object will have
+        an empty input and output sequence, with no internal
+        buffers allocated.
+    */
+    basic_flat_buffer&
+    operator=(basic_flat_buffer&&);
+
+    /** Copy constructor.
+
+        This object will have a copy of the other stream
+        buffer's input sequence, and an empty output sequence.
+    */
+    basic_flat_buffer(basic_flat_buffer const&);
+
+    /** Copy assignment.
+
+        This object will have a copy of the other stream
+        buffer's input sequence, and an empty output sequence.
+    */
+    basic_flat_buffer&
+    operator=(basic_flat_buffer const&);
+
+    /** Copy constructor.
+
+        This object will have a copy of the other stream
+        buffer's input sequence, and an empty output sequence.
+    */
+    template<class OtherAlloc>
+    basic_flat_buffer(basic_flat_buffer<OtherAlloc> const&);
+
+    /** Construct a flat stream buffer.
+
+        No memory is allocated until the first call to @ref prepare.
+
+        @param limit The maximum sum of the sizes of the input and
+        output sequences. Calls to @ref prepare which would exceed
+        this limit throw `std::length_error`.
+
+        @param alloc The allocator to use. If this parameter is
+        unspecified, a default constructed allocator will be used.
+    */
+    explicit
+    basic_flat_buffer(std::size_t limit =
+        (std::numeric_limits<std::size_t>::max)(),
+            Allocator const& alloc = allocator_type{});
+
+    /// Returns a copy of the associated allocator.
+    allocator_type
+    get_allocator() const
+    {
+        return this->member();
+    }
+
+    /// Returns the size of the input sequence.
+    std::size_t
+    size() const
+    {
+        return out_ - in_;
+    }
+
+    /// Returns the permitted maximum sum of the sizes of the input and output sequence.
+    std::size_t
+    max_size() const
+    {
+        return max_;
+    }
+
+    /// Returns the maximum sum of the sizes of the input sequence and output sequence the buffer can hold without requiring reallocation.
+    std::size_t
+    capacity() const
+    {
+        return end_ - begin_;
+    }
+
+    /// Get a list of buffers that represents the input sequence.
+    const_buffers_type
+    data() const
+    {
+        return {in_, size()};
+    }
+
+    /** Get a list of buffers that represents the output sequence, with the given size.
+
+        @throws std::length_error if the sum of the sizes of the
+        input sequence and the output sequence would exceed the
+        maximum size.
+
+        @note Buffers representing the input sequence acquired prior
+        to this call are invalidated.
+    */
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Move bytes from the output sequence to the input sequence.
+
+        @note Buffers representing the input sequence acquired prior to
+        this call remain valid.
+    */
+    void
+    commit(std::size_t n)
+    {
+        out_ += (std::min)(n,
+            static_cast<std::size_t>(last_ - out_));
+    }
+
+    /// Remove bytes from the input sequence.
+    void
+    consume(std::size_t n);
+
+    /** Reallocate the buffer to fit the input sequence.
+
+        The output sequence is emptied. If the input sequence
+        is empty, all memory is released.
+    */
+    void
+    shrink_to_fit();
+
+private:
+    void
+    move_from(basic_flat_buffer& other);
+
+    void
+    copy_from(char const* p, std::size_t n);
+
+    void
+    move_assign(basic_flat_buffer& other, std::false_type);
+
+    void
+    move_assign(basic_flat_buffer& other, std::true_type);
+
+    void
+    copy_assign(basic_flat_buffer const& other, std::false_type);
+
+    void
+    copy_assign(basic_flat_buffer const& other, std::true_type);
+
+    void
+    release();
+};
+
+/** A @b `DynamicBuffer` that uses a single contiguous buffer.
+
+    @note Meets the requirements of @b `DynamicBuffer`.
+*/
+using flat_buffer = basic_flat_buffer<std::allocator<char>>;
+
+// Helper for reading into a flat buffer
+template<class Allocator>
+std::size_t
+read_size_helper(basic_flat_buffer<
+    Allocator> const& buffer, std::size_t max_size);
+
+} // beast
+
+#include <beast/core/impl/flat_buffer.ipp>
+
+#endif
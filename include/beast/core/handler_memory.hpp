@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HANDLER_MEMORY_HPP
+#define BEAST_HANDLER_MEMORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace beast {
+
+namespace detail {
+template<class Handler>
+class memory_handler;
+} // detail
+
+/** Recycled memory for the operations of one stream.
+
+    Composed operations allocate their state, and the state of the
+    operations they start on the next layer, through the allocation
+    hooks of the completion handler. Unless the handler customizes
+    the hooks, every allocation goes to the global heap.
+
+    This class keeps a small number of memory blocks which are handed
+    out by @ref allocate and returned by @ref deallocate. A block grows
+    to the largest size requested of it, so once a stream has run each
+    of its operations the blocks are large enough for all of them,
+    and further operations do not allocate.
+
+    Use @ref bind_memory to create a completion handler whose
+    allocation hooks use an object of this type first, and the hooks
+    of the original handler when no block is available.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Safe. Memory may be returned from a
+    different thread than the one which allocated it, as happens
+    when an operation completes on an `io_service` thread.
+*/
+class handler_memory
+{
+    struct block
+    {
+        std::atomic<bool> busy;
+        std::atomic<void*> p;
+        std::size_t size = 0;
+
+        block()
+            : busy(false)
+            , p(nullptr)
+        {
+        }
+    };
+
+    static std::size_t constexpr block_count = 8;
+
+    block blocks_[block_count];
+
+public:
+    /// Constructor.
+    handler_memory() = default;
+
+    /// Destructor. All memory must have been returned.
+    ~handler_memory();
+
+    /** Move constructor.
+
+        The blocks of the other object are transferred. All memory
+        must have been returned to the other object.
+    */
+    handler_memory(handler_memory&& other);
+
+    /** Move assignment.
+
+        The blocks of this object are released, and the blocks of
+        the other object are transferred. All memory must have been
+        returned to both objects.
+    */
+    handler_memory&
+    operator=(handler_memory&& other);
+
+    handler_memory(handler_memory const&) = delete;
+    handler_memory& operator=(handler_memory const&) = delete;
+
+    /** Allocate memory from a free block.
+
+        @return A pointer to at least `size` bytes, or `nullptr`
+        if every block is in use.
+    */
+    void*
+    allocate(std::size_t size);
+
+    /** Return memory to its block.
+
+        @return `true` if the memory came from this object, in which
+        case its block becomes available. Otherwise nothing is done.
+    */
+    bool
+    deallocate(void* p);
+};
+
+/** Use recycled memory for the operations of a completion handler.
+
+    This function returns a new handler which calls the original
+    handler, and which provides the same `io_service` execution
+    guarantees. Memory requested through its allocation hooks comes
+    from `memory` when a block is available, otherwise from the
+    allocation hooks of the original handler.
+
+    The @ref handler_memory must remain valid until the handler is
+    invoked or destroyed.
+
+    @par Example
+    @code
+        struct connection
+        {
+            boost::asio::ip::tcp::socket sock;
+            beast::handler_memory memory;
+            ...
+
+            void do_write()
+            {
+                beast::http::async_write(sock, res,
+                    beast::bind_memory(memory,
+                        [this](beast::error_code ec)
+                        {
+                            ...
+                        }));
+            }
+        };
+    @endcode
+
+    @param memory The memory to use.
+
+    @param handler The handler to wrap. It is forwarded into the
+    returned handler.
+*/
+template<class Handler>
+#if GENERATING_DOCS
+implementation_defined
+#else
+detail::memory_handler<typename std::decay<Handler>::type>
+#endif
+bind_memory(handler_memory& memory, Handler&& handler);
+
+} // beast
+
+#include <beast/core/impl/handler_memory.ipp>
+
+#endif
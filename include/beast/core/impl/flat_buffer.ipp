@@ -0,0 +1,311 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_IMPL_FLAT_BUFFER_IPP
+#define BEAST_IMPL_FLAT_BUFFER_IPP
+
+#include <beast/core/detail/type_traits.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace beast {
+
+/*  Layout:
+
+      begin_     in_         out_        last_       end_
+        |<------->|<---------->|<---------->|<------->|
+                  |  input     |  output    |
+*/
+
+template<class Allocator>
+basic_flat_buffer<Allocator>::
+~basic_flat_buffer()
+{
+    release();
+}
+
+template<class Allocator>
+basic_flat_buffer<Allocator>::
+basic_flat_buffer(basic_flat_buffer&& other)
+    : detail::empty_base_optimization<allocator_type>(
+        std::move(other.member()))
+    , max_(other.max_)
+{
+    move_from(other);
+}
+
+template<class Allocator>
+auto
+basic_flat_buffer<Allocator>::
+operator=(basic_flat_buffer&& other) ->
+    basic_flat_buffer&
+{
+    if(this == &other)
+        return *this;
+    max_ = other.max_;
+    move_assign(other, std::integral_constant<bool,
+        alloc_traits::propagate_on_container_move_assignment::value>{});
+    return *this;
+}
+
+template<class Allocator>
+basic_flat_buffer<Allocator>::
+basic_flat_buffer(basic_flat_buffer const& other)
+    : basic_flat_buffer(other.max_,
+        alloc_traits::select_on_container_copy_construction(
+            other.member()))
+{
+    copy_from(other.in_, other.size());
+}
+
+template<class Allocator>
+auto
+basic_flat_buffer<Allocator>::
+operator=(basic_flat_buffer const& other) ->
+    basic_flat_buffer&
+{
+    if(this == &other)
+        return *this;
+    max_ = other.max_;
+    copy_assign(other, std::integral_constant<bool,
+        alloc_traits::propagate_on_container_copy_assignment::value>{});
+    return *this;
+}
+
+template<class Allocator>
+template<class OtherAlloc>
+basic_flat_buffer<Allocator>::
+basic_flat_buffer(basic_flat_buffer<OtherAlloc> const& other)
+    : basic_flat_buffer(other.max_size())
+{
+    using boost::asio::buffer_cast;
+    using boost::asio::buffer_size;
+    auto const b = *other.data().begin();
+    copy_from(buffer_cast<char const*>(b), buffer_size(b));
+}
+
+template<class Allocator>
+basic_flat_buffer<Allocator>::
+basic_flat_buffer(std::size_t limit, Allocator const& alloc)
+    : detail::empty_base_optimization<allocator_type>(alloc)
+    , max_(limit)
+{
+    if(limit == 0)
+        throw detail::make_exception<std::invalid_argument>(
+            "invalid limit", __FILE__, __LINE__);
+}
+
+template<class Allocator>
+auto
+basic_flat_buffer<Allocator>::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    if(n <= static_cast<std::size_t>(end_ - out_))
+    {
+        // Fits after the input
+        last_ = out_ + n;
+        return {out_, n};
+    }
+    auto const len = size();
+    if(n > max_ - len)
+        throw detail::make_exception<std::length_error>(
+            "flat_buffer overflow", __FILE__, __LINE__);
+    if(n <= capacity() - len)
+    {
+        // Fits after moving the input to the front
+        if(len > 0)
+            std::memmove(begin_, in_, len);
+        in_ = begin_;
+        out_ = in_ + len;
+        last_ = out_ + n;
+        return {out_, n};
+    }
+    // Grow geometrically, within the limit
+    auto const new_size = (std::min)(max_,
+        (std::max)(2 * capacity(), len + n));
+    auto const p = alloc_traits::allocate(this->member(), new_size);
+    if(len > 0)
+        std::memcpy(p, in_, len);
+    release();
+    begin_ = p;
+    in_ = begin_;
+    out_ = in_ + len;
+    last_ = out_ + n;
+    end_ = begin_ + new_size;
+    return {out_, n};
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+consume(std::size_t n)
+{
+    if(n < size())
+    {
+        in_ += n;
+    }
+    else if(last_ == out_)
+    {
+        // Input and output sequences are empty, reuse buffer.
+        in_ = begin_;
+        out_ = begin_;
+        last_ = begin_;
+    }
+    else
+    {
+        in_ = out_;
+    }
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+shrink_to_fit()
+{
+    auto const len = size();
+    if(len == capacity())
+    {
+        last_ = out_;
+        return;
+    }
+    char* p = nullptr;
+    if(len > 0)
+    {
+        p = alloc_traits::allocate(this->member(), len);
+        std::memcpy(p, in_, len);
+    }
+    release();
+    begin_ = p;
+    in_ = begin_;
+    out_ = begin_ + len;
+    last_ = out_;
+    end_ = out_;
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+move_from(basic_flat_buffer& other)
+{
+    begin_ = other.begin_;
+    in_ = other.in_;
+    out_ = other.out_;
+    last_ = out_;
+    end_ = other.end_;
+    other.begin_ = nullptr;
+    other.in_ = nullptr;
+    other.out_ = nullptr;
+    other.last_ = nullptr;
+    other.end_ = nullptr;
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+copy_from(char const* p, std::size_t n)
+{
+    consume(size());
+    if(n > 0)
+    {
+        auto const b = prepare(n);
+        std::memcpy(boost::asio::buffer_cast<char*>(b), p, n);
+        commit(n);
+    }
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+move_assign(basic_flat_buffer& other, std::false_type)
+{
+    if(this->member() != other.member())
+    {
+        copy_from(other.in_, other.size());
+        other.release();
+        other.begin_ = nullptr;
+        other.in_ = nullptr;
+        other.out_ = nullptr;
+        other.last_ = nullptr;
+        other.end_ = nullptr;
+    }
+    else
+    {
+        move_assign(other, std::true_type{});
+    }
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+move_assign(basic_flat_buffer& other, std::true_type)
+{
+    release();
+    this->member() = std::move(other.member());
+    move_from(other);
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+copy_assign(basic_flat_buffer const& other, std::false_type)
+{
+    copy_from(other.in_, other.size());
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+copy_assign(basic_flat_buffer const& other, std::true_type)
+{
+    if(this->member() != other.member())
+    {
+        release();
+        begin_ = nullptr;
+        in_ = nullptr;
+        out_ = nullptr;
+        last_ = nullptr;
+        end_ = nullptr;
+        this->member() = other.member();
+    }
+    copy_from(other.in_, other.size());
+}
+
+template<class Allocator>
+void
+basic_flat_buffer<Allocator>::
+release()
+{
+    if(begin_)
+        alloc_traits::deallocate(
+            this->member(), begin_, capacity());
+}
+
+template<class Allocator>
+std::size_t
+read_size_helper(basic_flat_buffer<
+    Allocator> const& buffer, std::size_t max_size)
+{
+    BOOST_ASSERT(max_size >= 1);
+    // Fill the space we already have first
+    auto const avail = buffer.capacity() - buffer.size();
+    if(avail > 0)
+        return (std::min)(avail, max_size);
+    // Otherwise grow by at least 512 bytes,
+    // staying within the limit if possible.
+    auto const limit = buffer.max_size() - buffer.size();
+    auto const n = (std::min)(max_size, std::max<std::size_t>(
+        512, buffer.capacity()));
+    return std::max<std::size_t>(1, (std::min)(n, limit));
+}
+
+} // beast
+
+#endif
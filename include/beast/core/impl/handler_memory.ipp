@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_IMPL_HANDLER_MEMORY_IPP
+#define BEAST_IMPL_HANDLER_MEMORY_IPP
+
+#include <beast/core/detail/memory_handler.hpp>
+#include <boost/assert.hpp>
+#include <new>
+#include <utility>
+
+namespace beast {
+
+/*  A block is claimed by exchanging `busy` from false to true, after
+    which only the claiming thread touches `p` and `size` until the
+    block is released by storing false. Memory may be returned on
+    another thread, so `deallocate` only compares against `p`, which
+    cannot change while the memory being returned is outstanding.
+*/
+
+inline
+handler_memory::
+~handler_memory()
+{
+    for(auto& b : blocks_)
+    {
+        BOOST_ASSERT(! b.busy.load());
+        ::operator delete(b.p.load());
+    }
+}
+
+inline
+handler_memory::
+handler_memory(handler_memory&& other)
+{
+    for(std::size_t i = 0; i < block_count; ++i)
+    {
+        auto& b = other.blocks_[i];
+        BOOST_ASSERT(! b.busy.load());
+        blocks_[i].p.store(b.p.exchange(nullptr));
+        blocks_[i].size = b.size;
+        b.size = 0;
+    }
+}
+
+inline
+auto
+handler_memory::
+operator=(handler_memory&& other) ->
+    handler_memory&
+{
+    if(this == &other)
+        return *this;
+    for(std::size_t i = 0; i < block_count; ++i)
+    {
+        auto& b = other.blocks_[i];
+        BOOST_ASSERT(! blocks_[i].busy.load());
+        BOOST_ASSERT(! b.busy.load());
+        ::operator delete(blocks_[i].p.exchange(
+            b.p.exchange(nullptr)));
+        blocks_[i].size = b.size;
+        b.size = 0;
+    }
+    return *this;
+}
+
+inline
+void*
+handler_memory::
+allocate(std::size_t size)
+{
+    for(auto& b : blocks_)
+    {
+        if(b.busy.exchange(true, std::memory_order_acquire))
+            continue;
+        if(b.size < size)
+        {
+            void* p;
+            try
+            {
+                p = ::operator new(size);
+            }
+            catch(...)
+            {
+                b.busy.store(false, std::memory_order_release);
+                throw;
+            }
+            ::operator delete(b.p.exchange(p));
+            b.size = size;
+        }
+        return b.p.load(std::memory_order_relaxed);
+    }
+    return nullptr;
+}
+
+inline
+bool
+handler_memory::
+deallocate(void* p)
+{
+    if(! p)
+        return false;
+    for(auto& b : blocks_)
+    {
+        if(b.p.load(std::memory_order_relaxed) != p)
+            continue;
+        BOOST_ASSERT(b.busy.load());
+        b.busy.store(false, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+template<class Handler>
+detail::memory_handler<typename std::decay<Handler>::type>
+bind_memory(handler_memory& memory, Handler&& handler)
+{
+    return detail::memory_handler<typename std::decay<
+        Handler>::type>(memory, std::forward<Handler>(handler));
+}
+
+} // beast
+
+#endif
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_IMPL_MIRRORED_BUFFER_IPP
+#define BEAST_IMPL_MIRRORED_BUFFER_IPP
+
+#include <beast/core/detail/type_traits.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace beast {
+
+/*  Layout, showing the first mapping followed by its mirror:
+
+    0                in_            capacity_
+    |<---------------+------------------>|<------------------>|
+                     |<--input-->|<-output->|
+
+    The input starts in the first mapping. The input and output
+    may extend into the mirror, where they continue with the bytes
+    at the start of the first mapping.
+*/
+
+inline
+mirrored_buffer::
+mirrored_buffer(mirrored_buffer&& other)
+    : m_(std::move(other.m_))
+    , capacity_(other.capacity_)
+    , in_(other.in_)
+    , size_(other.size_)
+{
+    other.in_ = 0;
+    other.size_ = 0;
+    other.out_ = 0;
+}
+
+inline
+auto
+mirrored_buffer::
+operator=(mirrored_buffer&& other) ->
+    mirrored_buffer&
+{
+    if(this == &other)
+        return *this;
+    m_ = std::move(other.m_);
+    capacity_ = other.capacity_;
+    in_ = other.in_;
+    size_ = other.size_;
+    out_ = 0;
+    other.in_ = 0;
+    other.size_ = 0;
+    other.out_ = 0;
+    return *this;
+}
+
+inline
+mirrored_buffer::
+mirrored_buffer(std::size_t capacity)
+{
+    if(capacity == 0)
+        throw detail::make_exception<std::invalid_argument>(
+            "invalid capacity", __FILE__, __LINE__);
+    auto const g = detail::mirrored_mapping::granularity();
+    capacity_ = (capacity + g - 1) / g * g;
+}
+
+inline
+auto
+mirrored_buffer::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    if(n > capacity_ - size_)
+        throw detail::make_exception<std::length_error>(
+            "mirrored_buffer overflow", __FILE__, __LINE__);
+    if(! m_.data())
+    {
+        error_code ec;
+        m_.map(capacity_, ec);
+        if(ec)
+            throw system_error{ec};
+    }
+    if(! detail::mirrored_mapping::mirrored &&
+        in_ + size_ + n > capacity_)
+    {
+        // No mirror, move the input to the front
+        std::memmove(m_.data(), m_.data() + in_, size_);
+        in_ = 0;
+    }
+    out_ = n;
+    return {m_.data() + in_ + size_, n};
+}
+
+inline
+void
+mirrored_buffer::
+commit(std::size_t n)
+{
+    n = (std::min)(n, out_);
+    size_ += n;
+    out_ -= n;
+}
+
+inline
+void
+mirrored_buffer::
+consume(std::size_t n)
+{
+    n = (std::min)(n, size_);
+    in_ += n;
+    size_ -= n;
+    if(detail::mirrored_mapping::mirrored)
+    {
+        // Continue in the first mapping
+        if(in_ >= capacity_)
+            in_ -= capacity_;
+    }
+    else if(size_ == 0 && out_ == 0)
+    {
+        in_ = 0;
+    }
+}
+
+inline
+std::size_t
+read_size_helper(mirrored_buffer const& buffer, std::size_t max_size)
+{
+    BOOST_ASSERT(max_size >= 1);
+    auto const avail = buffer.capacity() - buffer.size();
+    // When full, return one so that prepare reports the overflow
+    return std::max<std::size_t>(1, (std::min)(avail, max_size));
+}
+
+} // beast
+
+#endif
@@ -412,6 +412,7 @@ basic_streambuf(basic_streambuf&& other)
     auto const at_end =
         other.out_ == other.list_.end();
     list_ = std::move(other.list_);
+    free_ = std::move(other.free_);
     out_ = at_end ? list_.end() : other.out_;
     other.in_size_ = 0;
     other.out_ = other.list_.end();
@@ -597,11 +598,7 @@ basic_streambuf<Allocator>::prepare(size_type n) ->
     }
     while(n > 0)
     {
-        auto const size = std::max(alloc_size_, n);
-        auto& e = *reinterpret_cast<element*>(static_cast<
-            void*>(alloc_traits::allocate(this->member(),
-                sizeof(element) + size)));
-        alloc_traits::construct(this->member(), &e, size);
+        auto& e = alloc_element(std::max(alloc_size_, n));
         list_.push_back(e);
         if(out_ == list_.end())
             out_ = list_.iterator_to(e);
@@ -617,14 +614,11 @@ basic_streambuf<Allocator>::prepare(size_type n) ->
         }
         debug_check();
     }
-    for(auto it = reuse.begin(); it != reuse.end();)
+    while(! reuse.empty())
     {
-        auto& e = *it++;
-        reuse.erase(list_.iterator_to(e));
-        auto const len = e.size() + sizeof(e);
-        alloc_traits::destroy(this->member(), &e);
-        alloc_traits::deallocate(this->member(),
-            reinterpret_cast<char*>(&e), len);
+        auto& e = reuse.front();
+        reuse.erase(reuse.iterator_to(e));
+        release_element(e);
     }
     return mutable_buffers_type(*this);
 }
@@ -693,10 +687,7 @@ basic_streambuf<Allocator>::consume(size_type n)
             in_pos_ = 0;
             auto& e = list_.front();
             list_.erase(list_.iterator_to(e));
-            auto const len = e.size() + sizeof(e);
-            alloc_traits::destroy(this->member(), &e);
-            alloc_traits::deallocate(this->member(),
-                reinterpret_cast<char*>(&e), len);
+            release_element(e);
             debug_check();
         }
         else
@@ -730,6 +721,21 @@ basic_streambuf<Allocator>::consume(size_type n)
     }
 }
 
+template<class Allocator>
+void
+basic_streambuf<Allocator>::shrink_to_fit()
+{
+    if(in_size_ == 0)
+    {
+        clear();
+        return;
+    }
+    for(auto iter = free_.begin(); iter != free_.end();)
+        free_element(*iter++);
+    free_.clear();
+    debug_check();
+}
+
 template<class Allocator>
 void
 basic_streambuf<Allocator>::
@@ -737,6 +743,7 @@ clear()
 {
     delete_list();
     list_.clear();
+    free_.clear();
     out_ = list_.begin();
     in_size_ = 0;
     in_pos_ = 0;
@@ -768,6 +775,7 @@ move_assign(basic_streambuf& other, std::true_type)
     auto const at_end =
         other.out_ == other.list_.end();
     list_ = std::move(other.list_);
+    free_ = std::move(other.free_);
     out_ = at_end ? list_.end() : other.out_;
 
     in_size_ = other.in_size_;
@@ -798,18 +806,59 @@ copy_assign(basic_streambuf const& other, std::true_type)
     this->member() = other.member();
 }
 
+template<class Allocator>
+auto
+basic_streambuf<Allocator>::
+alloc_element(size_type n) ->
+    element&
+{
+    // Reuse a released buffer if it meets the minimum
+    // size, otherwise release it for good.
+    while(! free_.empty())
+    {
+        auto& e = free_.front();
+        free_.erase(free_.iterator_to(e));
+        if(e.size() >= alloc_size_)
+            return e;
+        free_element(e);
+    }
+    auto& e = *reinterpret_cast<element*>(static_cast<
+        void*>(alloc_traits::allocate(this->member(),
+            sizeof(element) + n)));
+    alloc_traits::construct(this->member(), &e, n);
+    return e;
+}
+
+template<class Allocator>
+void
+basic_streambuf<Allocator>::
+free_element(element& e)
+{
+    auto const n = e.size() + sizeof(e);
+    alloc_traits::destroy(this->member(), &e);
+    alloc_traits::deallocate(this->member(),
+        reinterpret_cast<char*>(&e), n);
+}
+
+template<class Allocator>
+void
+basic_streambuf<Allocator>::
+release_element(element& e)
+{
+    if(free_.size() < max_free)
+        free_.push_back(e);
+    else
+        free_element(e);
+}
+
 template<class Allocator>
 void
 basic_streambuf<Allocator>::delete_list()
 {
     for(auto iter = list_.begin(); iter != list_.end();)
-    {
-        auto& e = *iter++;
-        auto const n = e.size() + sizeof(e);
-        alloc_traits::destroy(this->member(), &e);
-        alloc_traits::deallocate(this->member(),
-            reinterpret_cast<char*>(&e), n);
-    }
+        free_element(*iter++);
+    for(auto iter = free_.begin(); iter != free_.end();)
+        free_element(*iter++);
 }
 
 template<class Allocator>
@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_MIRRORED_BUFFER_HPP
+#define BEAST_MIRRORED_BUFFER_HPP
+
+#include <beast/core/detail/mirrored_mapping.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+
+namespace beast {
+
+/** A @b `DynamicBuffer` using a fixed size circular buffer.
+
+    The storage is mapped into memory twice, back to back, so that
+    a sequence which wraps around the end of the storage continues
+    into the second mapping. Both the input sequence and the output
+    sequence are therefore always a single contiguous buffer, and
+    bytes are never moved or reallocated. This suits long-lived
+    connections, whose buffer is repeatedly filled and drained.
+
+    The capacity is rounded up to a multiple of the page size, and
+    the memory is mapped on the first call to @ref prepare. On
+    platforms without POSIX shared memory the storage is mapped once,
+    and the input sequence is moved to the front when the output
+    sequence would otherwise wrap around.
+
+    @note Meets the requirements of @b DynamicBuffer.
+*/
+class mirrored_buffer
+{
+    detail::mirrored_mapping m_;
+    std::size_t capacity_;
+    std::size_t in_ = 0;    // offset of the input
+    std::size_t size_ = 0;  // size of the input
+    std::size_t out_ = 0;   // size of the output
+
+public:
+    /// The type used to represent the input sequence as a list of buffers.
+    using const_buffers_type = boost::asio::const_buffers_1;
+
+    /// The type used to represent the output sequence as a list of buffers.
+    using mutable_buffers_type = boost::asio::mutable_buffers_1;
+
+    /// The default capacity.
+    static std::size_t constexpr default_capacity = 65536;
+
+    /** Move constructor.
+
+        The new object will have the input sequence of the other
+        stream buffer, and an empty output sequence.
+
+        @note After the move, the moved-from object will have an
+        empty input and output sequence, with no memory mapped.
+    */
+    mirrored_buffer(mirrored_buffer&& other);
+
+    /** Move assignment.
+
+        This object will have the input sequence of the other
+        stream buffer, and an empty output sequence.
+
+        @note After the move, the moved-from object will have an
+        empty input and output sequence, with no memory mapped.
+    */
+    mirrored_buffer&
+    operator=(mirrored_buffer&& other);
+
+    mirrored_buffer(mirrored_buffer const&) = delete;
+    mirrored_buffer& operator=(mirrored_buffer const&) = delete;
+
+    /** Construct a stream buffer.
+
+        @param capacity The size of the circular buffer. This is
+        rounded up to a multiple of the page size.
+    */
+    explicit
+    mirrored_buffer(std::size_t capacity = default_capacity);
+
+    /// Returns the size of the input sequence.
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+    /// Returns the permitted maximum sum of the sizes of the input and output sequence.
+    std::size_t
+    max_size() const
+    {
+        return capacity_;
+    }
+
+    /// Returns the maximum sum of the sizes of the input sequence and output sequence the buffer can hold without requiring reallocation.
+    std::size_t
+    capacity() const
+    {
+        return capacity_;
+    }
+
+    /// Get a list of buffers that represents the input sequence.
+    const_buffers_type
+    data() const
+    {
+        return {m_.data() + in_, size_};
+    }
+
+    /** Get a list of buffers that represents the output sequence, with the given size.
+
+        @throws std::length_error if the sum of the sizes of the
+        input sequence and the output sequence would exceed the
+        capacity.
+
+        @throws system_error if the memory could not be mapped.
+    */
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Move bytes from the output sequence to the input sequence.
+
+        @note Buffers representing the input sequence acquired prior to
+        this call remain valid.
+    */
+    void
+    commit(std::size_t n);
+
+    /// Remove bytes from the input sequence.
+    void
+    consume(std::size_t n);
+};
+
+// Helper for reading into a mirrored buffer
+std::size_t
+read_size_helper(mirrored_buffer const& buffer, std::size_t max_size);
+
+} // beast
+
+#include <beast/core/impl/mirrored_buffer.ipp>
+
+#endif
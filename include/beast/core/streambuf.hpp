@@ -25,6 +25,11 @@ namespace beast {
     the sequence to accommodate changes in the size of the character
     sequence.
 
+    Character arrays released by @ref consume are kept on a small
+    free list and reused by later calls to @ref prepare, so a stream
+    buffer which is repeatedly filled and drained reaches a steady
+    state where it performs no allocations.
+
     @note Meets the requirements of @b DynamicBuffer.
 
     @tparam Allocator The allocator to use for managing memory.
@@ -71,7 +76,11 @@ private:
         typename std::iterator_traits<const_iterator>::iterator_category>::value,
             "BidirectionalIterator requirements not met");
 
+    // The number of released buffers kept for reuse
+    static std::size_t constexpr max_free = 4;
+
     list_type list_;        // list of allocated buffers
+    list_type free_;        // released buffers kept for reuse
     iterator out_;          // element that contains out_pos_
     size_type alloc_size_;  // min amount to allocate
     size_type in_size_ = 0; // size of the input sequence
@@ -284,6 +293,15 @@ public:
     void
     consume(size_type n);
 
+    /** Release memory kept for reuse.
+
+        Released buffers kept for reuse are deallocated. If the
+        input sequence is empty, all memory is deallocated and the
+        output sequence is emptied.
+    */
+    void
+    shrink_to_fit();
+
     // Helper for boost::asio::read_until
     template<class OtherAllocator>
     friend
@@ -307,6 +325,15 @@ private:
     void
     copy_assign(basic_streambuf const& other, std::true_type);
 
+    element&
+    alloc_element(size_type n);
+
+    void
+    free_element(element& e);
+
+    void
+    release_element(element& e);
+
     void
     delete_list();
 
@@ -9,11 +9,20 @@
 #define BEAST_HTTP_HPP
 
 #include <beast/http/basic_fields.hpp>
+#include <beast/http/basic_flat_fields.hpp>
 #include <beast/http/basic_parser_v1.hpp>
 #include <beast/http/chunk_encode.hpp>
+#include <beast/http/compressed_body.hpp>
 #include <beast/http/empty_body.hpp>
+#include <beast/http/field.hpp>
 #include <beast/http/fields.hpp>
+#include <beast/http/file_body.hpp>
+#include <beast/http/file_mapping.hpp>
+#include <beast/http/flat_fields.hpp>
+#include <beast/http/header_block.hpp>
+#include <beast/http/header_view_parser_v1.hpp>
 #include <beast/http/message.hpp>
+#include <beast/http/mmap_body.hpp>
 #include <beast/http/parse.hpp>
 #include <beast/http/parse_error.hpp>
 #include <beast/http/parser_v1.hpp>
@@ -9,7 +9,9 @@
 #define BEAST_HTTP_BASIC_FIELDS_HPP
 
 #include <beast/core/detail/empty_base_optimization.hpp>
+#include <beast/http/field.hpp>
 #include <beast/http/detail/basic_fields.hpp>
+#include <boost/assert.hpp>
 #include <boost/lexical_cast.hpp>
 #include <algorithm>
 #include <cctype>
@@ -34,6 +36,12 @@ namespace http {
     as a `std::multiset`; there will be a separate value for each occurrence
     of the field name.
 
+    The overloads taking a @ref field are provided so that generic
+    code may use identifiers with any container. Here they look up
+    the canonical name of the field, at the same logarithmic cost
+    as a lookup by name. Use @ref basic_flat_fields where lookups
+    by identifier should compare identifiers instead of strings.
+
     @note Meets the requirements of @b FieldSequence.
 */
 template<class Allocator>
@@ -296,6 +304,59 @@ public:
         replace(name,
             boost::lexical_cast<std::string>(value));
     }
+
+    /// Returns `true` if the specified well-known field exists.
+    bool
+    exists(field f) const
+    {
+        return exists(to_string(f));
+    }
+
+    /// Returns the number of values for the specified well-known field.
+    std::size_t
+    count(field f) const
+    {
+        return count(to_string(f));
+    }
+
+    /// Returns an iterator to the first matching well-known field.
+    iterator
+    find(field f) const
+    {
+        return find(to_string(f));
+    }
+
+    /// Returns the value for a matching well-known field, or `""`.
+    boost::string_ref
+    operator[](field f) const
+    {
+        return (*this)[to_string(f)];
+    }
+
+    /// Remove all values of a well-known field.
+    std::size_t
+    erase(field f)
+    {
+        return erase(to_string(f));
+    }
+
+    /// Insert a well-known field using its canonical name.
+    template<class T>
+    void
+    insert(field f, T const& value)
+    {
+        BOOST_ASSERT(f != field::unknown);
+        insert(to_string(f), value);
+    }
+
+    /// Replace a well-known field using its canonical name.
+    template<class T>
+    void
+    replace(field f, T const& value)
+    {
+        BOOST_ASSERT(f != field::unknown);
+        replace(to_string(f), value);
+    }
 };
 
 } // http
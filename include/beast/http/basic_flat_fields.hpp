@@ -0,0 +1,422 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_BASIC_FLAT_FIELDS_HPP
+#define BEAST_HTTP_BASIC_FLAT_FIELDS_HPP
+
+#include <beast/http/field.hpp>
+#include <boost/assert.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace beast {
+namespace http {
+
+/** A flat container for storing HTTP header fields.
+
+    This container holds the same field value pairs as @ref basic_fields
+    and offers the same interface, so it may be used as the `Fields`
+    template argument of @ref message, @ref header, @ref parser_v1 and
+    the `write` functions.
+
+    The representation is chosen for speed rather than for cheap
+    removal. All names and values are stored back to back in a single
+    character buffer, and the fields are kept in insertion order in
+    a vector of small fixed size records. Each record holds a
+    case-insensitive hash of the field name, computed on insertion,
+    and lookups go through an open-addressed hash table indexed by
+    that hash. Names of well-known fields are identified on insertion,
+    so lookups by @ref field compare identifiers instead of strings,
+    and fields inserted by identifier use the canonical name from
+    static storage. Inserting a field is amortized allocation-free, and
+    @ref clear keeps all capacity so a container reused for every
+    message on a connection stops allocating after the first few.
+
+    Removing fields is linear in the size of the container.
+
+    Field names are stored as-is, but comparisons are case-insensitive.
+    When the container is iterated, the fields are presented in the order
+    of insertion. For fields with the same name, the container behaves
+    as a `std::multiset`; there will be a separate value for each occurrence
+    of the field name. Iterators remain valid when fields are inserted,
+    but the strings they refer to do not.
+
+    @note Meets the requirements of @b FieldSequence.
+*/
+template<class Allocator>
+class basic_flat_fields
+{
+    template<class OtherAlloc>
+    friend class basic_flat_fields;
+
+    struct entry
+    {
+        std::uint32_t hash;
+        std::uint32_t pos;          // name, then value, in arena_
+        std::uint32_t value_len;
+        std::uint16_t name_len;     // zero if the name is static
+        field id;
+    };
+
+    template<class T>
+    using rebind_alloc = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<T>;
+
+    std::vector<char, rebind_alloc<char>> arena_;
+    std::vector<entry, rebind_alloc<entry>> list_;
+    std::vector<std::uint32_t, rebind_alloc<std::uint32_t>> table_;
+
+    boost::string_ref
+    name_of(entry const& e) const
+    {
+        if(e.name_len == 0)
+            return to_string(e.id);
+        return {arena_.data() + e.pos, e.name_len};
+    }
+
+    boost::string_ref
+    value_of(entry const& e) const
+    {
+        return {arena_.data() + e.pos + e.name_len, e.value_len};
+    }
+
+    bool
+    in_arena(boost::string_ref const& s) const;
+
+    template<class Pred>
+    std::size_t
+    find_index(std::uint32_t hash, Pred const& pred) const;
+
+    template<class Pred>
+    std::size_t
+    count_if(std::uint32_t hash, Pred const& pred) const;
+
+    template<class Pred>
+    std::size_t
+    erase_if(Pred const& pred);
+
+    std::size_t
+    find_index(boost::string_ref const& name) const;
+
+    void
+    insert(std::uint32_t hash, field id,
+        boost::string_ref const& name, boost::string_ref value);
+
+    void
+    place(std::size_t i);
+
+    void
+    rehash(std::size_t n);
+
+    template<class FieldSequence>
+    void
+    copy_from(FieldSequence const& fs)
+    {
+        for(auto const& e : fs)
+            insert(e.name(), e.value());
+    }
+
+public:
+    /// The type of allocator used.
+    using allocator_type = Allocator;
+
+    /** The value type of the field sequence.
+
+        Meets the requirements of @b Field.
+    */
+    struct value_type
+    {
+        boost::string_ref first;
+        boost::string_ref second;
+
+        boost::string_ref
+        name() const
+        {
+            return first;
+        }
+
+        boost::string_ref
+        value() const
+        {
+            return second;
+        }
+    };
+
+    /// A const iterator to the field sequence
+#if GENERATING_DOCS
+    using const_iterator = implementation_defined;
+#else
+    class const_iterator;
+#endif
+
+    /// A const iterator to the field sequence
+    using iterator = const_iterator;
+
+    /// Default constructor.
+    basic_flat_fields() = default;
+
+    /** Construct the fields.
+
+        @param alloc The allocator to use.
+    */
+    explicit
+    basic_flat_fields(Allocator const& alloc);
+
+    /** Move constructor.
+
+        The moved-from object becomes an empty field sequence.
+
+        @param other The object to move from.
+    */
+    basic_flat_fields(basic_flat_fields&& other);
+
+    /** Move assignment.
+
+        The moved-from object becomes an empty field sequence.
+
+        @param other The object to move from.
+    */
+    basic_flat_fields& operator=(basic_flat_fields&& other);
+
+    /// Copy constructor.
+    basic_flat_fields(basic_flat_fields const&) = default;
+
+    /// Copy assignment.
+    basic_flat_fields& operator=(basic_flat_fields const&) = default;
+
+    /// Copy constructor.
+    template<class OtherAlloc>
+    basic_flat_fields(basic_flat_fields<OtherAlloc> const&);
+
+    /// Copy assignment.
+    template<class OtherAlloc>
+    basic_flat_fields& operator=(basic_flat_fields<OtherAlloc> const&);
+
+    /// Construct from a field sequence.
+    template<class FwdIt>
+    basic_flat_fields(FwdIt first, FwdIt last);
+
+    /// Returns `true` if the field sequence contains no elements.
+    bool
+    empty() const
+    {
+        return list_.empty();
+    }
+
+    /// Returns the number of elements in the field sequence.
+    std::size_t
+    size() const
+    {
+        return list_.size();
+    }
+
+    /// Returns a const iterator to the beginning of the field sequence.
+    const_iterator
+    begin() const;
+
+    /// Returns a const iterator to the end of the field sequence.
+    const_iterator
+    end() const;
+
+    /// Returns a const iterator to the beginning of the field sequence.
+    const_iterator
+    cbegin() const
+    {
+        return begin();
+    }
+
+    /// Returns a const iterator to the end of the field sequence.
+    const_iterator
+    cend() const
+    {
+        return end();
+    }
+
+    /// Returns `true` if the specified field exists.
+    bool
+    exists(boost::string_ref const& name) const;
+
+    /// Returns the number of values for the specified field.
+    std::size_t
+    count(boost::string_ref const& name) const;
+
+    /** Returns an iterator to the case-insensitive matching field name.
+
+        If more than one field with the specified name exists, the
+        first field defined by insertion order is returned.
+    */
+    iterator
+    find(boost::string_ref const& name) const;
+
+    /** Returns the value for a case-insensitive matching header, or `""`.
+
+        If more than one field with the specified name exists, the
+        first field defined by insertion order is returned.
+    */
+    boost::string_ref
+    operator[](boost::string_ref const& name) const;
+
+    /** Clear the contents of the basic_flat_fields.
+
+        All allocated memory is retained.
+    */
+    void
+    clear() noexcept;
+
+    /** Reserve space for fields.
+
+        @param fields The number of fields to reserve space for.
+
+        @param bytes The number of bytes to reserve space for,
+        counting the names and values of all fields.
+    */
+    void
+    reserve(std::size_t fields, std::size_t bytes);
+
+    /** Remove a field.
+
+        If more than one field with the specified name exists, all
+        matching fields will be removed.
+
+        @param name The name of the field(s) to remove.
+
+        @return The number of fields removed.
+    */
+    std::size_t
+    erase(boost::string_ref const& name);
+
+    /** Insert a field value.
+
+        If a field with the same name already exists, the
+        existing field is untouched and a new field value pair
+        is inserted into the container.
+
+        @param name The name of the field.
+
+        @param value A string holding the value of the field.
+    */
+    void
+    insert(boost::string_ref const& name, boost::string_ref value);
+
+    /** Insert a field value.
+
+        If a field with the same name already exists, the
+        existing field is untouched and a new field value pair
+        is inserted into the container.
+
+        @param name The name of the field
+
+        @param value The value of the field. The object will be
+        converted to a string using `boost::lexical_cast`.
+    */
+    template<class T>
+    typename std::enable_if<
+        ! std::is_constructible<boost::string_ref, T>::value>::type
+    insert(boost::string_ref name, T const& value)
+    {
+        insert(name, boost::lexical_cast<std::string>(value));
+    }
+
+    /** Replace a field value.
+
+        First removes any values with matching field names, then
+        inserts the new field value.
+
+        @param name The name of the field.
+
+        @param value A string holding the value of the field.
+    */
+    void
+    replace(boost::string_ref const& name, boost::string_ref value);
+
+    /** Replace a field value.
+
+        First removes any values with matching field names, then
+        inserts the new field value.
+
+        @param name The name of the field
+
+        @param value The value of the field. The object will be
+        converted to a string using `boost::lexical_cast`.
+    */
+    template<class T>
+    typename std::enable_if<
+        ! std::is_constructible<boost::string_ref, T>::value>::type
+    replace(boost::string_ref const& name, T const& value)
+    {
+        replace(name,
+            boost::lexical_cast<std::string>(value));
+    }
+
+    /// Returns `true` if the specified well-known field exists.
+    bool
+    exists(field f) const;
+
+    /// Returns the number of values for the specified well-known field.
+    std::size_t
+    count(field f) const;
+
+    /// Returns an iterator to the first matching well-known field.
+    iterator
+    find(field f) const;
+
+    /// Returns the value for a matching well-known field, or `""`.
+    boost::string_ref
+    operator[](field f) const;
+
+    /// Remove all values of a well-known field.
+    std::size_t
+    erase(field f);
+
+    /** Insert a well-known field.
+
+        The canonical name of the field is used, and is not copied
+        into the container.
+    */
+    void
+    insert(field f, boost::string_ref value);
+
+    /** Insert a well-known field.
+
+        The canonical name of the field is used, and is not copied
+        into the container.
+    */
+    template<class T>
+    typename std::enable_if<
+        ! std::is_constructible<boost::string_ref, T>::value>::type
+    insert(field f, T const& value)
+    {
+        insert(f, boost::lexical_cast<std::string>(value));
+    }
+
+    /// Replace a well-known field using its canonical name.
+    void
+    replace(field f, boost::string_ref value);
+
+    /// Replace a well-known field using its canonical name.
+    template<class T>
+    typename std::enable_if<
+        ! std::is_constructible<boost::string_ref, T>::value>::type
+    replace(field f, T const& value)
+    {
+        replace(f, boost::lexical_cast<std::string>(value));
+    }
+};
+
+} // http
+} // beast
+
+#include <beast/http/impl/basic_flat_fields.ipp>
+
+#endif
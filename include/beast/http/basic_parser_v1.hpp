@@ -489,6 +489,13 @@ protected:
     void
     reset();
 
+    /// Returns the body maximum size, zero means no limit.
+    std::size_t
+    body_limit() const
+    {
+        return b_max_;
+    }
+
 private:
     Derived&
     impl()
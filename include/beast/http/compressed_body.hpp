@@ -0,0 +1,737 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_COMPRESSED_BODY_HPP
+#define BEAST_HTTP_COMPRESSED_BODY_HPP
+
+#include <beast/core/error.hpp>
+#include <beast/core/detail/ci_char_traits.hpp>
+#include <beast/http/basic_parser_v1.hpp>
+#include <beast/http/fields.hpp>
+#include <beast/http/message.hpp>
+#include <beast/http/parse_error.hpp>
+#include <beast/http/resume_context.hpp>
+#include <beast/zlib/deflate_stream.hpp>
+#include <beast/zlib/inflate_stream.hpp>
+#include <beast/zlib/detail/adler32.hpp>
+#include <beast/zlib/detail/crc32.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/logic/tribool.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace beast {
+namespace http {
+
+/// The content codings supported by @ref compressed_body
+enum class content_coding
+{
+    /// The "gzip" coding, the gzip file format (rfc1952)
+    gzip,
+
+    /// The "deflate" coding, the zlib data format (rfc1950)
+    deflate,
+
+    /// No coding, the body is sent or received unchanged
+    identity
+};
+
+/** A Body which compresses another Body as it is sent.
+
+    The buffers produced by the writer of `Body` are passed through
+    @ref zlib::deflate_stream in bounded pieces, and the compressed
+    output is sent as it becomes available. The body is never held
+    in memory in compressed form, so large or generated bodies may
+    be sent with constant memory.
+
+    The compressed size is not known in advance, so the writer does
+    not provide a content length, and @ref prepare applies the
+    chunked transfer coding. The caller is responsible for setting
+    the Content-Encoding field to match the selected coding.
+
+    The reader and writer of `Body` work on a message held inside
+    @ref value_type, with an empty header and @ref value_type::inner
+    as its body, so the body is not copied when sending or receiving.
+
+    When parsing, the coding is taken from the Content-Encoding
+    field, and the body is decompressed into the reader of `Body`
+    as it arrives, using no more memory than the decompression
+    window and one buffer of output. The @ref body_max_size limit
+    of the parser applies to the decompressed octets. Bodies
+    without a Content-Encoding are received unchanged.
+
+    Meets the requirements of @b `Body`.
+
+    @par Example
+    @code
+        response<compressed_body<file_body>> res;
+        res.status = 200;
+        res.reason = "OK";
+        res.version = 11;
+        res.fields.insert("Content-Encoding", "gzip");
+        res.body.inner.open("index.html");
+        prepare(res);
+        write(sock, res);
+    @endcode
+
+    @par Example
+    @code
+        response<compressed_body<string_body>> res;
+        read(sock, sb, res);
+        std::cout << res.body.inner;
+    @endcode
+
+    @tparam Body The body to compress or decompress.
+*/
+template<class Body>
+struct compressed_body
+{
+    /// The type of the `message::body` member
+    class value_type
+    {
+        friend struct compressed_body;
+
+        // Given to the reader and writer of Body
+        message<false, Body, fields> m_;
+
+    public:
+        /// The uncompressed body.
+        typename Body::value_type& inner;
+
+        /** The content coding.
+
+            When parsing, this is set from the Content-Encoding field.
+        */
+        content_coding coding = content_coding::gzip;
+
+        /// The compression level, from 0 (none) to 9 (best).
+        int level = 6;
+
+        /// Constructor
+        value_type()
+            : inner(m_.body)
+        {
+        }
+
+        /// Move constructor
+        value_type(value_type&& other)
+            : m_(std::move(other.m_))
+            , inner(m_.body)
+            , coding(other.coding)
+            , level(other.level)
+        {
+        }
+
+        /// Copy constructor
+        value_type(value_type const& other)
+            : m_(other.m_)
+            , inner(m_.body)
+            , coding(other.coding)
+            , level(other.level)
+        {
+        }
+
+        /// Move assignment
+        value_type&
+        operator=(value_type&& other)
+        {
+            m_ = std::move(other.m_);
+            coding = other.coding;
+            level = other.level;
+            return *this;
+        }
+
+        /// Copy assignment
+        value_type&
+        operator=(value_type const& other)
+        {
+            m_ = other.m_;
+            coding = other.coding;
+            level = other.level;
+            return *this;
+        }
+    };
+
+#if GENERATING_DOCS
+private:
+#endif
+
+    class writer
+    {
+        // Appends the non-empty buffers of a sequence
+        struct append_buffers
+        {
+            std::vector<boost::asio::const_buffer>& v;
+
+            template<class ConstBufferSequence>
+            void
+            operator()(ConstBufferSequence const& buffers) const
+            {
+                for(boost::asio::const_buffer b : buffers)
+                    if(boost::asio::buffer_size(b) > 0)
+                        v.push_back(b);
+            }
+        };
+
+        value_type const& body_;
+        boost::optional<typename Body::writer> w_;
+        zlib::deflate_stream zo_;
+        std::vector<boost::asio::const_buffer> in_;
+        std::size_t pos_ = 0;       // next buffer in in_
+        std::unique_ptr<std::uint8_t[]> buf_;
+        std::size_t size_ = 0;      // bytes of output in buf_
+        std::uint32_t check_;       // CRC-32 or Adler-32
+        std::uint32_t total_ = 0;   // input size modulo 2^32
+        bool more_ = true;          // inner writer is not done
+        bool end_ = false;          // deflate stream is finished
+        bool done_ = false;         // trailer is in buf_
+
+    public:
+        /// The size of the buffer holding compressed output.
+        static std::size_t constexpr buffer_size = 16384;
+
+        template<bool isRequest, class Fields>
+        explicit
+        writer(message<isRequest,
+                compressed_body, Fields> const& m) noexcept
+            : body_(m.body)
+        {
+        }
+
+        void
+        init(error_code& ec) noexcept
+        {
+            try
+            {
+                zo_.reset(body_.level, 15, 8, zlib::Strategy::normal);
+                w_.emplace(body_.m_);
+                if(body_.coding != content_coding::identity)
+                    buf_.reset(new std::uint8_t[buffer_size]);
+            }
+            catch(std::invalid_argument const&)
+            {
+                ec = boost::system::errc::make_error_code(
+                    boost::system::errc::invalid_argument);
+                return;
+            }
+            catch(std::bad_alloc const&)
+            {
+                ec = boost::system::errc::make_error_code(
+                    boost::system::errc::not_enough_memory);
+                return;
+            }
+            catch(...)
+            {
+                // Thrown by the writer of Body
+                ec = boost::system::errc::make_error_code(
+                    boost::system::errc::io_error);
+                return;
+            }
+            w_->init(ec);
+            if(ec)
+                return;
+            auto p = buf_.get();
+            if(body_.coding == content_coding::identity)
+            {
+                return;
+            }
+            else if(body_.coding == content_coding::gzip)
+            {
+                // ID1 ID2 CM FLG MTIME(4) XFL OS
+                *p++ = 0x1f;
+                *p++ = 0x8b;
+                *p++ = 8;
+                *p++ = 0;
+                *p++ = 0;
+                *p++ = 0;
+                *p++ = 0;
+                *p++ = 0;
+                *p++ = body_.level == 9 ? 2 :
+                    (body_.level == 1 ? 4 : 0);
+                *p++ = 255;
+                check_ = 0;
+            }
+            else
+            {
+                // CMF FLG, with FLG a multiple of 31 when appended
+                std::uint32_t const cmf = 0x78;
+                std::uint32_t flg =
+                    body_.level < 2 ? 0 :
+                    body_.level < 6 ? 1 :
+                    body_.level == 6 ? 2 : 3;
+                flg <<= 6;
+                flg += 31 - (cmf * 256 + flg) % 31;
+                *p++ = static_cast<std::uint8_t>(cmf);
+                *p++ = static_cast<std::uint8_t>(flg);
+                check_ = 1;
+            }
+            size_ = p - buf_.get();
+        }
+
+        template<class WriteFunction>
+        boost::tribool
+        write(resume_context&& resume, error_code& ec,
+            WriteFunction&& wf) noexcept
+        {
+            if(body_.coding == content_coding::identity)
+                return w_->write(std::move(resume), ec,
+                    std::forward<WriteFunction>(wf));
+            for(;;)
+            {
+                // Compress the buffers from the inner body
+                while(pos_ < in_.size() && size_ < buffer_size)
+                {
+                    auto& b = in_[pos_];
+                    auto const data = boost::asio::buffer_cast<
+                        std::uint8_t const*>(b);
+                    auto const avail = boost::asio::buffer_size(b);
+                    zlib::z_params zs;
+                    zs.next_in = data;
+                    zs.avail_in = avail;
+                    zs.next_out = buf_.get() + size_;
+                    zs.avail_out = buffer_size - size_;
+                    zo_.write(zs, zlib::Flush::none, ec);
+                    if(ec)
+                        return true;
+                    update(data, avail - zs.avail_in);
+                    if(zs.avail_in == 0)
+                        ++pos_;
+                    else
+                        b = b + (avail - zs.avail_in);
+                    size_ = buffer_size - zs.avail_out;
+                }
+                if(size_ == buffer_size)
+                    break;
+                if(! more_)
+                {
+                    finish(ec);
+                    if(ec)
+                        return true;
+                    break;
+                }
+                in_.clear();
+                pos_ = 0;
+                boost::tribool const result =
+                    w_->write(std::move(resume), ec,
+                        append_buffers{in_});
+                if(ec)
+                    return true;
+                if(boost::indeterminate(result))
+                    return boost::indeterminate;
+                if(result)
+                    more_ = false;
+            }
+            wf(boost::asio::buffer(buf_.get(), size_));
+            size_ = 0;
+            return done_;
+        }
+
+    private:
+        void
+        update(std::uint8_t const* data, std::size_t size)
+        {
+            if(body_.coding == content_coding::gzip)
+                check_ = zlib::detail::crc32(check_, data, size);
+            else
+                check_ = zlib::detail::adler32(check_, data, size);
+            total_ += static_cast<std::uint32_t>(size);
+        }
+
+        // Finish the deflate stream, then append the trailer
+        void
+        finish(error_code& ec)
+        {
+            if(! end_)
+            {
+                zlib::z_params zs;
+                zs.next_in = nullptr;
+                zs.avail_in = 0;
+                zs.next_out = buf_.get() + size_;
+                zs.avail_out = buffer_size - size_;
+                zo_.write(zs, zlib::Flush::finish, ec);
+                size_ = buffer_size - zs.avail_out;
+                if(ec != zlib::error::end_of_stream)
+                    return;
+                ec = {};
+                end_ = true;
+            }
+            auto p = buf_.get() + size_;
+            if(body_.coding == content_coding::gzip)
+            {
+                if(buffer_size - size_ < 8)
+                    return;
+                // CRC32 ISIZE, little endian
+                for(int i = 0; i < 4; ++i)
+                    *p++ = static_cast<std::uint8_t>(
+                        check_ >> (8 * i));
+                for(int i = 0; i < 4; ++i)
+                    *p++ = static_cast<std::uint8_t>(
+                        total_ >> (8 * i));
+            }
+            else
+            {
+                if(buffer_size - size_ < 4)
+                    return;
+                // ADLER32, big endian
+                for(int i = 3; i >= 0; --i)
+                    *p++ = static_cast<std::uint8_t>(
+                        check_ >> (8 * i));
+            }
+            size_ = p - buf_.get();
+            done_ = true;
+        }
+    };
+
+    class reader
+    {
+        enum class state
+        {
+            header,
+            extra_len,
+            extra,
+            name,
+            comment,
+            header_crc,
+            body,
+            trailer,
+            done
+        };
+
+        value_type& body_;
+        boost::optional<typename Body::reader> r_;
+        zlib::inflate_stream zi_;
+        std::unique_ptr<std::uint8_t[]> buf_;
+        state state_ = state::header;
+        std::uint8_t hdr_[10];      // fixed size fields
+        std::size_t n_ = 0;         // bytes in hdr_
+        std::size_t skip_ = 0;      // bytes of FEXTRA left
+        std::uint8_t flags_ = 0;    // gzip FLG
+        bool known_;                // coding is supported
+        bool raw_ = false;          // deflate without zlib header
+        std::uint32_t check_;       // CRC-32 or Adler-32
+        std::uint32_t total_ = 0;   // output size modulo 2^32
+        std::uint64_t size_ = 0;    // output size
+        std::uint64_t limit_ = 0;   // maximum output size
+
+    public:
+        /// The size of the buffer holding decompressed output.
+        static std::size_t constexpr buffer_size = 16384;
+
+        template<bool isRequest, class Fields>
+        explicit
+        reader(message<isRequest,
+                compressed_body, Fields>& m) noexcept
+            : body_(m.body)
+            , known_(true)
+        {
+            auto const s = m.fields["Content-Encoding"];
+            if(s.empty() ||
+                    beast::detail::ci_equal(s, "identity"))
+                body_.coding = content_coding::identity;
+            else if(beast::detail::ci_equal(s, "gzip") ||
+                    beast::detail::ci_equal(s, "x-gzip"))
+                body_.coding = content_coding::gzip;
+            else if(beast::detail::ci_equal(s, "deflate"))
+                body_.coding = content_coding::deflate;
+            else
+                known_ = false;
+            check_ = body_.coding == content_coding::gzip ? 0 : 1;
+        }
+
+        void
+        set_option(body_max_size const& o) noexcept
+        {
+            limit_ = o.value;
+        }
+
+        void
+        init(error_code& ec) noexcept
+        {
+            if(! known_)
+            {
+                ec = parse_error::unknown_content_coding;
+                return;
+            }
+            try
+            {
+                r_.emplace(body_.m_);
+                if(body_.coding != content_coding::identity)
+                    buf_.reset(new std::uint8_t[buffer_size]);
+            }
+            catch(std::bad_alloc const&)
+            {
+                ec = boost::system::errc::make_error_code(
+                    boost::system::errc::not_enough_memory);
+                return;
+            }
+            catch(...)
+            {
+                // Thrown by the reader of Body
+                ec = boost::system::errc::make_error_code(
+                    boost::system::errc::io_error);
+                return;
+            }
+            r_->init(ec);
+        }
+
+        void
+        write(void const* data,
+            std::size_t size, error_code& ec) noexcept
+        {
+            auto p = static_cast<std::uint8_t const*>(data);
+            auto const end = p + size;
+            if(body_.coding == content_coding::identity)
+            {
+                put(p, size, ec);
+                return;
+            }
+            while(p < end)
+            {
+                switch(state_)
+                {
+                case state::header:
+                    if(body_.coding == content_coding::gzip)
+                    {
+                        // ID1 ID2 CM FLG MTIME(4) XFL OS
+                        if(! fill(p, end, 10))
+                            return;
+                        if(hdr_[0] != 0x1f || hdr_[1] != 0x8b ||
+                            hdr_[2] != 8 || (hdr_[3] & 0xe0) != 0)
+                        {
+                            ec = parse_error::bad_content_coding;
+                            return;
+                        }
+                        flags_ = hdr_[3];
+                        state_ = state::extra_len;
+                        break;
+                    }
+                    // CMF FLG
+                    if(! fill(p, end, 2))
+                        return;
+                    if((hdr_[0] & 0x0f) == 8 && (hdr_[0] >> 4) <= 7 &&
+                        (hdr_[0] * 256 + hdr_[1]) % 31 == 0 &&
+                            (hdr_[1] & 0x20) == 0)
+                    {
+                        zi_.reset((hdr_[0] >> 4) + 8);
+                        state_ = state::body;
+                        break;
+                    }
+                    // Some servers send "deflate" as
+                    // raw deflate, without the zlib wrapper.
+                    raw_ = true;
+                    state_ = state::body;
+                    inflate(hdr_, 2, ec);
+                    if(ec)
+                        return;
+                    break;
+
+                case state::extra_len:
+                    if(flags_ & 4)
+                    {
+                        // XLEN
+                        if(! fill(p, end, 2))
+                            return;
+                        skip_ = hdr_[0] + 256 * hdr_[1];
+                    }
+                    state_ = state::extra;
+                    break;
+
+                case state::extra:
+                {
+                    auto const n = std::min<std::size_t>(
+                        skip_, end - p);
+                    p += n;
+                    skip_ -= n;
+                    if(skip_ > 0)
+                        return;
+                    state_ = state::name;
+                    break;
+                }
+
+                case state::name:
+                case state::comment:
+                    if(flags_ & (state_ == state::name ? 8 : 16))
+                    {
+                        // zero-terminated
+                        auto const z = static_cast<std::uint8_t const*>(
+                            std::memchr(p, 0, end - p));
+                        if(! z)
+                            return;
+                        p = z + 1;
+                    }
+                    state_ = state_ == state::name ?
+                        state::comment : state::header_crc;
+                    break;
+
+                case state::header_crc:
+                    if(flags_ & 2)
+                    {
+                        // CRC16, not checked
+                        if(! fill(p, end, 2))
+                            return;
+                    }
+                    state_ = state::body;
+                    break;
+
+                case state::body:
+                    p += inflate(p, end - p, ec);
+                    if(ec)
+                        return;
+                    break;
+
+                case state::trailer:
+                    if(body_.coding == content_coding::gzip)
+                    {
+                        // CRC32 ISIZE, little endian
+                        if(! fill(p, end, 8))
+                            return;
+                        if(get(0, false) != check_ ||
+                            get(4, false) != total_)
+                        {
+                            ec = parse_error::bad_content_coding;
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        // ADLER32, big endian
+                        if(! fill(p, end, 4))
+                            return;
+                        if(get(0, true) != check_)
+                        {
+                            ec = parse_error::bad_content_coding;
+                            return;
+                        }
+                    }
+                    state_ = state::done;
+                    break;
+
+                case state::done:
+                    // Data after the end of the stream
+                    ec = parse_error::bad_content_coding;
+                    return;
+                }
+            }
+        }
+
+        void
+        finish(error_code& ec) noexcept
+        {
+            if(body_.coding != content_coding::identity &&
+                state_ != state::done &&
+                    ! (state_ == state::header && n_ == 0))
+            {
+                // The stream is truncated
+                ec = parse_error::bad_content_coding;
+            }
+        }
+
+    private:
+        // Collect fixed size fields into hdr_,
+        // returns true when there are n bytes.
+        bool
+        fill(std::uint8_t const*& p,
+            std::uint8_t const* end, std::size_t n)
+        {
+            auto const used = std::min<std::size_t>(
+                n - n_, end - p);
+            std::memcpy(hdr_ + n_, p, used);
+            n_ += used;
+            p += used;
+            if(n_ < n)
+                return false;
+            n_ = 0;
+            return true;
+        }
+
+        std::uint32_t
+        get(std::size_t pos, bool big) const
+        {
+            std::uint32_t v = 0;
+            for(int i = 0; i < 4; ++i)
+                v |= std::uint32_t{hdr_[pos + i]} <<
+                    (8 * (big ? 3 - i : i));
+            return v;
+        }
+
+        // Deliver decompressed octets to the inner reader
+        void
+        put(std::uint8_t const* data,
+            std::size_t size, error_code& ec)
+        {
+            if(limit_ && size > limit_ - size_)
+            {
+                ec = parse_error::body_too_big;
+                return;
+            }
+            size_ += size;
+            r_->write(data, size, ec);
+        }
+
+        // Returns the number of bytes consumed
+        std::size_t
+        inflate(std::uint8_t const* data,
+            std::size_t size, error_code& ec)
+        {
+            zlib::z_params zs;
+            zs.next_in = data;
+            zs.avail_in = size;
+            for(;;)
+            {
+                zs.next_out = buf_.get();
+                zs.avail_out = buffer_size;
+                zi_.write(zs, zlib::Flush::none, ec);
+                auto const n = buffer_size - zs.avail_out;
+                if(n > 0)
+                {
+                    if(body_.coding == content_coding::gzip)
+                        check_ = zlib::detail::crc32(
+                            check_, buf_.get(), n);
+                    else
+                        check_ = zlib::detail::adler32(
+                            check_, buf_.get(), n);
+                    total_ += static_cast<std::uint32_t>(n);
+                    error_code ev;
+                    put(buf_.get(), n, ev);
+                    if(ev)
+                    {
+                        ec = ev;
+                        break;
+                    }
+                }
+                if(ec == zlib::error::end_of_stream)
+                {
+                    ec = {};
+                    state_ = raw_ ? state::done : state::trailer;
+                    break;
+                }
+                if(ec == zlib::error::need_buffers)
+                {
+                    ec = {};
+                    break;
+                }
+                if(ec)
+                    break;
+                if(zs.avail_in == 0 && zs.avail_out > 0)
+                    break;
+            }
+            return size - zs.avail_in;
+        }
+    };
+};
+
+} // http
+} // beast
+
+#endif
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_DETAIL_FIELD_ACCESS_HPP
+#define BEAST_HTTP_DETAIL_FIELD_ACCESS_HPP
+
+#include <beast/http/field.hpp>
+#include <beast/core/detail/type_traits.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace beast {
+namespace http {
+namespace detail {
+
+/*  Access to well-known fields in a user-defined Fields container.
+
+    Containers which accept a `field` in place of a name are given
+    the identifier, everything else gets the canonical name.
+*/
+
+template<class Fields, class = beast::detail::void_t<>>
+struct has_field_ids : std::false_type {};
+
+template<class Fields>
+struct has_field_ids<Fields, beast::detail::void_t<decltype(
+    std::declval<Fields const&>().exists(field::unknown),
+    std::declval<Fields const&>()[field::unknown],
+    std::declval<Fields&>().insert(field::unknown,
+        std::declval<boost::string_ref>())
+        )> > : std::true_type {};
+
+template<class Fields>
+inline
+bool
+exists_field(Fields const& fields, field f, std::true_type)
+{
+    return fields.exists(f);
+}
+
+template<class Fields>
+inline
+bool
+exists_field(Fields const& fields, field f, std::false_type)
+{
+    return fields.exists(to_string(f));
+}
+
+template<class Fields>
+inline
+bool
+exists_field(Fields const& fields, field f)
+{
+    return exists_field(fields, f, has_field_ids<Fields>{});
+}
+
+template<class Fields>
+inline
+boost::string_ref
+get_field(Fields const& fields, field f, std::true_type)
+{
+    return fields[f];
+}
+
+template<class Fields>
+inline
+boost::string_ref
+get_field(Fields const& fields, field f, std::false_type)
+{
+    return fields[to_string(f)];
+}
+
+template<class Fields>
+inline
+boost::string_ref
+get_field(Fields const& fields, field f)
+{
+    return get_field(fields, f, has_field_ids<Fields>{});
+}
+
+template<class Fields, class T>
+inline
+void
+insert_field(Fields& fields, field f,
+    T const& value, std::true_type)
+{
+    fields.insert(f, value);
+}
+
+template<class Fields, class T>
+inline
+void
+insert_field(Fields& fields, field f,
+    T const& value, std::false_type)
+{
+    fields.insert(to_string(f), value);
+}
+
+template<class Fields, class T>
+inline
+void
+insert_field(Fields& fields, field f, T const& value)
+{
+    insert_field(fields, f, value, has_field_ids<Fields>{});
+}
+
+} // detail
+} // http
+} // beast
+
+#endif
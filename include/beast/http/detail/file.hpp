@@ -0,0 +1,280 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_DETAIL_FILE_HPP
+#define BEAST_HTTP_DETAIL_FILE_HPP
+
+#include <beast/core/error.hpp>
+#include <boost/asio/error.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#if ! defined(BEAST_HTTP_FILE_POSIX)
+# if defined(__unix__) || defined(__APPLE__)
+#  define BEAST_HTTP_FILE_POSIX 1
+# else
+#  define BEAST_HTTP_FILE_POSIX 0
+# endif
+#endif
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if BEAST_HTTP_FILE_POSIX
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+namespace beast {
+namespace http {
+namespace detail {
+
+inline
+error_code
+last_file_error()
+{
+    return error_code{errno,
+        boost::system::generic_category()};
+}
+
+// Returns the last write time from the results of stat. The
+// time is in nanoseconds where the platform provides it.
+inline
+std::int64_t
+last_write_time(struct stat const& st)
+{
+#if defined(__linux__)
+    return static_cast<std::int64_t>(st.st_mtim.tv_sec) *
+        1000000000 + st.st_mtim.tv_nsec;
+#else
+    return static_cast<std::int64_t>(st.st_mtime);
+#endif
+}
+
+// Returns the size and the last write time of a file. The
+// time is in nanoseconds where the platform provides it.
+inline
+void
+stat_file(std::string const& path, std::uint64_t& size,
+    std::int64_t& mtime, error_code& ec)
+{
+    struct stat st;
+    if(::stat(path.c_str(), &st) != 0)
+    {
+        ec = last_file_error();
+        return;
+    }
+    size = static_cast<std::uint64_t>(st.st_size);
+    mtime = last_write_time(st);
+}
+
+#if BEAST_HTTP_FILE_POSIX
+
+// A read-only file opened for positional reads.
+//
+class file
+{
+    int fd_ = -1;
+
+public:
+    file() = default;
+    file(file const&) = delete;
+    file& operator=(file const&) = delete;
+
+    ~file()
+    {
+        close();
+    }
+
+    bool
+    is_open() const
+    {
+        return fd_ != -1;
+    }
+
+    int
+    native_handle() const
+    {
+        return fd_;
+    }
+
+    void
+    open(std::string const& path, error_code& ec)
+    {
+        close();
+        for(;;)
+        {
+            fd_ = ::open(path.c_str(), O_RDONLY);
+            if(fd_ != -1)
+                break;
+            if(errno != EINTR)
+            {
+                ec = last_file_error();
+                return;
+            }
+        }
+    #ifdef POSIX_FADV_SEQUENTIAL
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    #endif
+    }
+
+    void
+    close()
+    {
+        if(fd_ != -1)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    std::uint64_t
+    size(error_code& ec) const
+    {
+        struct stat st;
+        if(::fstat(fd_, &st) != 0)
+        {
+            ec = last_file_error();
+            return 0;
+        }
+        return static_cast<std::uint64_t>(st.st_size);
+    }
+
+    // Returns the size and the last write time of the open file
+    void
+    stat(std::uint64_t& size,
+        std::int64_t& mtime, error_code& ec) const
+    {
+        struct stat st;
+        if(::fstat(fd_, &st) != 0)
+        {
+            ec = last_file_error();
+            return;
+        }
+        size = static_cast<std::uint64_t>(st.st_size);
+        mtime = last_write_time(st);
+    }
+
+    // Returns the number of bytes read, zero at end of file.
+    std::size_t
+    read(std::uint64_t offset,
+        void* data, std::size_t size, error_code& ec)
+    {
+        for(;;)
+        {
+            auto const n = ::pread(fd_, data, size,
+                static_cast<off_t>(offset));
+            if(n >= 0)
+                return static_cast<std::size_t>(n);
+            if(errno != EINTR)
+            {
+                ec = last_file_error();
+                return 0;
+            }
+        }
+    }
+};
+
+#else
+
+// A read-only file opened for positional reads.
+//
+// This uses the C library, reads are only positional in that
+// the file is repositioned whenever the offset does not match.
+//
+class file
+{
+    std::FILE* f_ = nullptr;
+    std::uint64_t pos_ = 0;
+
+public:
+    file() = default;
+    file(file const&) = delete;
+    file& operator=(file const&) = delete;
+
+    ~file()
+    {
+        close();
+    }
+
+    bool
+    is_open() const
+    {
+        return f_ != nullptr;
+    }
+
+    void
+    open(std::string const& path, error_code& ec)
+    {
+        close();
+        f_ = std::fopen(path.c_str(), "rb");
+        if(! f_)
+            ec = last_file_error();
+        pos_ = 0;
+    }
+
+    void
+    close()
+    {
+        if(f_)
+        {
+            std::fclose(f_);
+            f_ = nullptr;
+        }
+    }
+
+    std::uint64_t
+    size(error_code& ec)
+    {
+        if(std::fseek(f_, 0, SEEK_END) != 0)
+        {
+            ec = last_file_error();
+            return 0;
+        }
+        auto const n = std::ftell(f_);
+        if(n < 0 || std::fseek(f_, 0, SEEK_SET) != 0)
+        {
+            ec = last_file_error();
+            return 0;
+        }
+        pos_ = 0;
+        return static_cast<std::uint64_t>(n);
+    }
+
+    std::size_t
+    read(std::uint64_t offset,
+        void* data, std::size_t size, error_code& ec)
+    {
+        if(offset != pos_)
+        {
+            if(std::fseek(f_, static_cast<long>(offset), SEEK_SET) != 0)
+            {
+                ec = last_file_error();
+                return 0;
+            }
+            pos_ = offset;
+        }
+        auto const n = std::fread(data, 1, size, f_);
+        if(n < size && std::ferror(f_))
+        {
+            ec = last_file_error();
+            return 0;
+        }
+        pos_ += n;
+        return n;
+    }
+};
+
+#endif
+
+} // detail
+} // http
+} // beast
+
+#endif
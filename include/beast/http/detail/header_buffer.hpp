@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_DETAIL_HEADER_BUFFER_HPP
+#define BEAST_HTTP_DETAIL_HEADER_BUFFER_HPP
+
+#include <beast/http/header_block.hpp>
+#include <beast/http/message.hpp>
+#include <beast/core/detail/type_traits.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace beast {
+namespace http {
+namespace detail {
+
+template<class T, class = beast::detail::void_t<>>
+struct has_prebuilt : std::false_type {};
+
+template<class T>
+struct has_prebuilt<T, beast::detail::void_t<decltype(
+    std::declval<T const&>().prebuilt().data()
+        )> > : std::true_type {};
+
+template<class Fields>
+inline
+boost::asio::const_buffer
+prebuilt_block(Fields const& fields, std::true_type)
+{
+    return fields.prebuilt().data();
+}
+
+template<class Fields>
+inline
+boost::asio::const_buffer
+prebuilt_block(Fields const&, std::false_type)
+{
+    return {};
+}
+
+template<class Fields>
+inline
+header_block
+prebuilt_owner(Fields const& fields, std::true_type)
+{
+    return fields.prebuilt();
+}
+
+template<class Fields>
+inline
+header_block
+prebuilt_owner(Fields const&, std::false_type)
+{
+    return {};
+}
+
+// Serializes a header into a single pre-sized allocation.
+//
+// The total size is computed first, then the start line and
+// every field are copied in with no intermediate growth. A
+// header_block attached to the fields is not copied, it is
+// presented as a separate buffer after the start line.
+//
+class header_buffer
+{
+public:
+    using const_buffers_type =
+        std::array<boost::asio::const_buffer, 3>;
+
+private:
+    std::unique_ptr<char[]> p_;
+    header_block block_;
+    const_buffers_type bs_;
+
+    // "HTTP/1.x " or " HTTP/1.x\r\n"
+    static
+    char*
+    put_version(char* out, int version, bool request)
+    {
+        BOOST_ASSERT(version == 10 || version == 11);
+        if(request)
+            *out++ = ' ';
+        std::memcpy(out, "HTTP/1.", 7);
+        out += 7;
+        *out++ = static_cast<char>('0' + version % 10);
+        if(request)
+        {
+            *out++ = '\r';
+            *out++ = '\n';
+        }
+        else
+        {
+            *out++ = ' ';
+        }
+        return out;
+    }
+
+    static
+    char*
+    put(char* out, std::string const& s)
+    {
+        std::memcpy(out, s.data(), s.size());
+        return out + s.size();
+    }
+
+    static
+    char*
+    put(char* out, boost::string_ref const& s)
+    {
+        std::memcpy(out, s.data(), s.size());
+        return out + s.size();
+    }
+
+    static
+    std::size_t
+    digits(int v)
+    {
+        std::size_t n = v < 0 ? 2 : 1;
+        while(v /= 10)
+            ++n;
+        return n;
+    }
+
+    static
+    char*
+    put(char* out, int v)
+    {
+        auto const n = digits(v);
+        unsigned u;
+        if(v < 0)
+        {
+            *out = '-';
+            u = 0u - static_cast<unsigned>(v);
+        }
+        else
+        {
+            u = static_cast<unsigned>(v);
+        }
+        auto p = out + n;
+        do
+        {
+            *--p = static_cast<char>('0' + u % 10);
+            u /= 10;
+        }
+        while(u);
+        return out + n;
+    }
+
+    template<class Fields>
+    static
+    std::size_t
+    start_line_size(header<true, Fields> const& h)
+    {
+        // method SP url SP "HTTP/1.x" CRLF
+        return h.method.size() + h.url.size() + 12;
+    }
+
+    template<class Fields>
+    static
+    std::size_t
+    start_line_size(header<false, Fields> const& h)
+    {
+        // "HTTP/1.x" SP status SP reason CRLF
+        return 9 + digits(h.status) + 1 + h.reason.size() + 2;
+    }
+
+    template<class Fields>
+    static
+    char*
+    put_start_line(char* out, header<true, Fields> const& h)
+    {
+        out = put(out, h.method);
+        *out++ = ' ';
+        out = put(out, h.url);
+        return put_version(out, h.version, true);
+    }
+
+    template<class Fields>
+    static
+    char*
+    put_start_line(char* out, header<false, Fields> const& h)
+    {
+        out = put_version(out, h.version, false);
+        out = put(out, h.status);
+        *out++ = ' ';
+        out = put(out, h.reason);
+        *out++ = '\r';
+        *out++ = '\n';
+        return out;
+    }
+
+public:
+    header_buffer() = default;
+    header_buffer(header_buffer&&) = default;
+    header_buffer& operator=(header_buffer&&) = default;
+
+    template<bool isRequest, class Fields>
+    explicit
+    header_buffer(header<isRequest, Fields> const& h)
+    {
+        auto const n0 = start_line_size(h);
+        auto n = n0 + 2;
+        for(auto const& f : h.fields)
+            n += f.name().size() + f.value().size() + 4;
+        p_.reset(new char[n]);
+        auto out = put_start_line(p_.get(), h);
+        BOOST_ASSERT(out == p_.get() + n0);
+        for(auto const& f : h.fields)
+        {
+            out = put(out, f.name());
+            *out++ = ':';
+            *out++ = ' ';
+            out = put(out, f.value());
+            *out++ = '\r';
+            *out++ = '\n';
+        }
+        *out++ = '\r';
+        *out++ = '\n';
+        BOOST_ASSERT(out == p_.get() + n);
+        has_prebuilt<Fields> tag;
+        block_ = prebuilt_owner(h.fields, tag);
+        bs_[0] = {p_.get(), n0};
+        bs_[1] = prebuilt_block(h.fields, tag);
+        bs_[2] = {p_.get() + n0, n - n0};
+    }
+
+    /// Returns the unwritten part of the header.
+    const_buffers_type const&
+    data() const
+    {
+        return bs_;
+    }
+
+    /// Returns the number of unwritten bytes.
+    std::size_t
+    size() const
+    {
+        return boost::asio::buffer_size(bs_);
+    }
+
+    /// Remove bytes from the beginning of the header.
+    void
+    consume(std::size_t n)
+    {
+        using boost::asio::buffer_size;
+        for(auto& b : bs_)
+        {
+            auto const len = buffer_size(b);
+            if(n < len)
+            {
+                b = b + n;
+                break;
+            }
+            n -= len;
+            b = {};
+        }
+    }
+};
+
+} // detail
+} // http
+} // beast
+
+#endif
@@ -0,0 +1,274 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_DETAIL_SCAN_HPP
+#define BEAST_HTTP_DETAIL_SCAN_HPP
+
+#include <beast/core/detail/cpu_info.hpp>
+#include <beast/core/detail/ctz.hpp>
+#include <cstdint>
+
+namespace beast {
+namespace http {
+namespace detail {
+
+/*  Bulk scanners for the header loops of basic_parser_v1.
+
+    Each function returns a pointer to the first octet in [first, last)
+    which is not in the "plain" set, or `last`. The plain sets are
+    chosen so that no octet inside them needs any action from the
+    parser's state machine besides being passed through:
+
+        field:  ALPHA / DIGIT / "-" / "_"
+        value:  %x20-7E / obs-text
+
+    Every other octet (":", CR, HTAB, the remaining tchar symbols,
+    invalid octets) stops the scan and is handled one at a time by
+    the caller, so the scanners never need to reject input themselves.
+*/
+
+inline
+bool
+is_plain_field_char(char c)
+{
+    static bool constexpr tab[] = {
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 0
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 16
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 1, 0, 0, // 32
+        1, 1, 1, 1,  1, 1, 1, 1,  1, 1, 0, 0,  0, 0, 0, 0, // 48
+        0, 1, 1, 1,  1, 1, 1, 1,  1, 1, 1, 1,  1, 1, 1, 1, // 64
+        1, 1, 1, 1,  1, 1, 1, 1,  1, 1, 1, 0,  0, 0, 0, 1, // 80
+        0, 1, 1, 1,  1, 1, 1, 1,  1, 1, 1, 1,  1, 1, 1, 1, // 96
+        1, 1, 1, 1,  1, 1, 1, 1,  1, 1, 1, 0,  0, 0, 0, 0, // 112
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 128
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 144
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 160
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 176
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 192
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 208
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0, // 224
+        0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0  // 240
+    };
+    static_assert(sizeof(tab) == 256, "");
+    return tab[static_cast<std::uint8_t>(c)];
+}
+
+inline
+bool
+is_plain_value_char(char c)
+{
+    auto const u = static_cast<std::uint8_t>(c);
+    return u >= 0x20 && u != 0x7f;
+}
+
+inline
+char const*
+skip_field_chars_scalar(char const* first, char const* last)
+{
+    while(first != last && is_plain_field_char(*first))
+        ++first;
+    return first;
+}
+
+inline
+char const*
+skip_value_chars_scalar(char const* first, char const* last)
+{
+    while(first != last && is_plain_value_char(*first))
+        ++first;
+    return first;
+}
+
+#if BEAST_DETAIL_X86
+
+// Signed compares are used throughout: octets 0x80-0xFF
+// are negative, which is what the value set wants and
+// keeps them out of every range in the field set.
+
+inline
+char const*
+skip_field_chars_sse2(char const* first, char const* last)
+{
+    auto const a0 = _mm_set1_epi8('a' - 1);
+    auto const a1 = _mm_set1_epi8('z' + 1);
+    auto const d0 = _mm_set1_epi8('0' - 1);
+    auto const d1 = _mm_set1_epi8('9' + 1);
+    auto const dash = _mm_set1_epi8('-');
+    auto const under = _mm_set1_epi8('_');
+    auto const fold = _mm_set1_epi8(0x20);
+    while(last - first >= 16)
+    {
+        auto const v = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(first));
+        auto const lv = _mm_or_si128(v, fold);
+        auto const ok = _mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(
+                    _mm_cmpgt_epi8(lv, a0),
+                    _mm_cmpgt_epi8(a1, lv)),
+                _mm_and_si128(
+                    _mm_cmpgt_epi8(v, d0),
+                    _mm_cmpgt_epi8(d1, v))),
+            _mm_or_si128(
+                _mm_cmpeq_epi8(v, dash),
+                _mm_cmpeq_epi8(v, under)));
+        auto const m = static_cast<std::uint32_t>(
+            _mm_movemask_epi8(ok)) ^ 0xffff;
+        if(m)
+            return first + beast::detail::ctz(m);
+        first += 16;
+    }
+    return skip_field_chars_scalar(first, last);
+}
+
+inline
+char const*
+skip_value_chars_sse2(char const* first, char const* last)
+{
+    auto const sp = _mm_set1_epi8(0x20);
+    auto const del = _mm_set1_epi8(0x7f);
+    auto const neg = _mm_set1_epi8(-1);
+    while(last - first >= 16)
+    {
+        auto const v = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(first));
+        // 0 <= v < 0x20 || v == 0x7f
+        auto const bad = _mm_or_si128(
+            _mm_and_si128(
+                _mm_cmpgt_epi8(sp, v),
+                _mm_cmpgt_epi8(v, neg)),
+            _mm_cmpeq_epi8(v, del));
+        auto const m = static_cast<std::uint32_t>(
+            _mm_movemask_epi8(bad));
+        if(m)
+            return first + beast::detail::ctz(m);
+        first += 16;
+    }
+    return skip_value_chars_scalar(first, last);
+}
+
+BEAST_DETAIL_TARGET("avx2")
+inline
+char const*
+skip_field_chars_avx2(char const* first, char const* last)
+{
+    auto const a0 = _mm256_set1_epi8('a' - 1);
+    auto const a1 = _mm256_set1_epi8('z' + 1);
+    auto const d0 = _mm256_set1_epi8('0' - 1);
+    auto const d1 = _mm256_set1_epi8('9' + 1);
+    auto const dash = _mm256_set1_epi8('-');
+    auto const under = _mm256_set1_epi8('_');
+    auto const fold = _mm256_set1_epi8(0x20);
+    while(last - first >= 32)
+    {
+        auto const v = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(first));
+        auto const lv = _mm256_or_si256(v, fold);
+        auto const ok = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_and_si256(
+                    _mm256_cmpgt_epi8(lv, a0),
+                    _mm256_cmpgt_epi8(a1, lv)),
+                _mm256_and_si256(
+                    _mm256_cmpgt_epi8(v, d0),
+                    _mm256_cmpgt_epi8(d1, v))),
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, dash),
+                _mm256_cmpeq_epi8(v, under)));
+        auto const m = ~static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(ok));
+        if(m)
+            return first + beast::detail::ctz(m);
+        first += 32;
+    }
+    return skip_field_chars_sse2(first, last);
+}
+
+BEAST_DETAIL_TARGET("avx2")
+inline
+char const*
+skip_value_chars_avx2(char const* first, char const* last)
+{
+    auto const sp = _mm256_set1_epi8(0x20);
+    auto const del = _mm256_set1_epi8(0x7f);
+    auto const neg = _mm256_set1_epi8(-1);
+    while(last - first >= 32)
+    {
+        auto const v = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(first));
+        auto const bad = _mm256_or_si256(
+            _mm256_and_si256(
+                _mm256_cmpgt_epi8(sp, v),
+                _mm256_cmpgt_epi8(v, neg)),
+            _mm256_cmpeq_epi8(v, del));
+        auto const m = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(bad));
+        if(m)
+            return first + beast::detail::ctz(m);
+        first += 32;
+    }
+    return skip_value_chars_sse2(first, last);
+}
+
+#endif
+
+using skip_chars_fn =
+    char const*(*)(char const*, char const*);
+
+inline
+skip_chars_fn
+select_skip_field_chars()
+{
+#if BEAST_DETAIL_X86
+    auto const& ci = beast::detail::get_cpu_info();
+    if(ci.avx2)
+        return &skip_field_chars_avx2;
+    if(ci.sse2)
+        return &skip_field_chars_sse2;
+#endif
+    return &skip_field_chars_scalar;
+}
+
+inline
+skip_chars_fn
+select_skip_value_chars()
+{
+#if BEAST_DETAIL_X86
+    auto const& ci = beast::detail::get_cpu_info();
+    if(ci.avx2)
+        return &skip_value_chars_avx2;
+    if(ci.sse2)
+        return &skip_value_chars_sse2;
+#endif
+    return &skip_value_chars_scalar;
+}
+
+/// Skip octets which need no attention in a field name
+inline
+char const*
+skip_field_chars(char const* first, char const* last)
+{
+    static skip_chars_fn const f =
+        select_skip_field_chars();
+    return f(first, last);
+}
+
+/// Skip octets which need no attention in a field value
+inline
+char const*
+skip_value_chars(char const* first, char const* last)
+{
+    static skip_chars_fn const f =
+        select_skip_value_chars();
+    return f(first, last);
+}
+
+} // detail
+} // http
+} // beast
+
+#endif
@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_DETAIL_SENDFILE_HPP
+#define BEAST_HTTP_DETAIL_SENDFILE_HPP
+
+#include <beast/http/detail/file.hpp>
+#include <beast/core/error.hpp>
+#include <beast/core/detail/type_traits.hpp>
+#include <boost/asio/error.hpp>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if ! defined(BEAST_HTTP_SENDFILE)
+# if defined(__linux__)
+#  define BEAST_HTTP_SENDFILE 1
+# else
+#  define BEAST_HTTP_SENDFILE 0
+# endif
+#endif
+
+#if BEAST_HTTP_SENDFILE
+# include <cerrno>
+# include <poll.h>
+# include <sys/sendfile.h>
+#endif
+
+namespace beast {
+namespace http {
+namespace detail {
+
+/*  Zero-copy transfer of a file to a socket.
+
+    A Writer which exposes the file descriptor and the remaining
+    range of its file may be sent by the kernel directly, when the
+    stream is a socket which exposes its native handle.
+*/
+
+template<class Writer, class = beast::detail::void_t<>>
+struct has_native_file : std::false_type {};
+
+template<class Writer>
+struct has_native_file<Writer, beast::detail::void_t<decltype(
+    std::declval<Writer const&>().native_handle(),
+    std::declval<Writer const&>().offset(),
+    std::declval<Writer const&>().remain(),
+    std::declval<Writer&>().consume(std::uint64_t{})
+        )> > : std::integral_constant<bool,
+    std::is_convertible<decltype(
+        std::declval<Writer const&>().native_handle()),
+            int>::value> {};
+
+template<class Stream, class = beast::detail::void_t<>>
+struct has_native_socket : std::false_type {};
+
+template<class Stream>
+struct has_native_socket<Stream, beast::detail::void_t<decltype(
+    std::declval<Stream&>().native_handle(),
+    std::declval<Stream const&>().native_non_blocking(),
+    std::declval<Stream&>().native_non_blocking(
+        true, std::declval<error_code&>())
+        )> > : std::integral_constant<bool,
+    std::is_convertible<decltype(
+        std::declval<Stream&>().native_handle()),
+            int>::value> {};
+
+template<class Stream, class Writer>
+using can_sendfile = std::integral_constant<bool,
+    BEAST_HTTP_SENDFILE &&
+    has_native_file<Writer>::value &&
+    has_native_socket<Stream>::value>;
+
+#if BEAST_HTTP_SENDFILE
+
+/*  Send the rest of the writer's file on the socket.
+
+    Returns when the file is sent, on error, or with
+    `error::would_block` when the socket is not ready.
+
+    Returns `false` if the kernel cannot send this file to
+    this socket, in which case the caller should continue
+    with the writer, which is positioned after the last byte
+    that was sent.
+*/
+template<class Writer>
+bool
+sendfile_some(int sock, Writer& w, error_code& ec)
+{
+    // Limit each call, as Linux does
+    std::uint64_t constexpr limit = 0x7ffff000;
+    while(w.remain() > 0)
+    {
+        auto off = static_cast<off_t>(w.offset());
+        auto const n = ::sendfile(sock, w.native_handle(), &off,
+            static_cast<std::size_t>(w.remain() < limit ?
+                w.remain() : limit));
+        if(n > 0)
+        {
+            w.consume(static_cast<std::uint64_t>(n));
+            continue;
+        }
+        if(n == 0)
+        {
+            // The file was truncated while sending
+            ec = boost::system::errc::make_error_code(
+                boost::system::errc::io_error);
+            return true;
+        }
+        switch(errno)
+        {
+        case EINTR:
+            continue;
+
+        case EAGAIN:
+    #if EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+    #endif
+            ec = boost::asio::error::would_block;
+            return true;
+
+        case EINVAL:
+        case ENOSYS:
+        case EOPNOTSUPP:
+            return false;
+
+        default:
+            ec = last_file_error();
+            return true;
+        }
+    }
+    return true;
+}
+
+// Block until the socket is writable.
+inline
+void
+wait_writable(int sock, error_code& ec)
+{
+    pollfd fds;
+    fds.fd = sock;
+    fds.events = POLLOUT;
+    fds.revents = 0;
+    for(;;)
+    {
+        if(::poll(&fds, 1, -1) >= 0)
+            return;
+        if(errno != EINTR)
+        {
+            ec = last_file_error();
+            return;
+        }
+    }
+}
+
+#else
+
+template<class Writer>
+bool
+sendfile_some(int, Writer&, error_code&)
+{
+    return false;
+}
+
+inline
+void
+wait_writable(int, error_code&)
+{
+}
+
+#endif
+
+} // detail
+} // http
+} // beast
+
+#endif
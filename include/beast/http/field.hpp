@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_FIELD_HPP
+#define BEAST_HTTP_FIELD_HPP
+
+#include <beast/core/to_string.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <iosfwd>
+
+namespace beast {
+namespace http {
+
+/** Identifiers for well-known HTTP header fields.
+
+    Containers which support field identifiers offer overloads of
+    their lookup and modification functions taking a @ref field in
+    place of a name. The mapping from a name to its identifier is
+    a perfect hash, so it costs one hash and one string comparison
+    regardless of the number of well-known fields.
+
+    @ref basic_flat_fields records the identifier of each field on
+    insertion, and its lookups by identifier compare identifiers.
+    @ref basic_fields accepts identifiers for compatibility only,
+    and looks them up by their canonical name.
+
+    Fields not in this list are represented by `field::unknown`,
+    and must be accessed by name.
+*/
+enum class field : unsigned short
+{
+    unknown = 0,
+
+    accept,
+    accept_charset,
+    accept_encoding,
+    accept_language,
+    accept_ranges,
+    access_control_allow_credentials,
+    access_control_allow_headers,
+    access_control_allow_methods,
+    access_control_allow_origin,
+    access_control_expose_headers,
+    access_control_max_age,
+    access_control_request_headers,
+    access_control_request_method,
+    age,
+    allow,
+    alt_svc,
+    authorization,
+    cache_control,
+    connection,
+    content_disposition,
+    content_encoding,
+    content_language,
+    content_length,
+    content_location,
+    content_md5,
+    content_range,
+    content_security_policy,
+    content_type,
+    cookie,
+    date,
+    dnt,
+    etag,
+    expect,
+    expires,
+    forwarded,
+    from,
+    host,
+    if_match,
+    if_modified_since,
+    if_none_match,
+    if_range,
+    if_unmodified_since,
+    keep_alive,
+    last_modified,
+    link,
+    location,
+    max_forwards,
+    origin,
+    pragma,
+    proxy_authenticate,
+    proxy_authorization,
+    proxy_connection,
+    range,
+    referer,
+    retry_after,
+    sec_websocket_accept,
+    sec_websocket_extensions,
+    sec_websocket_key,
+    sec_websocket_protocol,
+    sec_websocket_version,
+    server,
+    set_cookie,
+    strict_transport_security,
+    te,
+    trailer,
+    transfer_encoding,
+    upgrade,
+    upgrade_insecure_requests,
+    user_agent,
+    vary,
+    via,
+    warning,
+    www_authenticate,
+    x_content_type_options,
+    x_forwarded_for,
+    x_forwarded_host,
+    x_forwarded_proto,
+    x_frame_options,
+    x_requested_with,
+    x_xss_protection
+};
+
+// Keep beast::to_string visible to unqualified calls in this namespace
+using beast::to_string;
+
+/** Return the canonical name of a well-known field.
+
+    The returned string refers to static storage. If `f` is
+    `field::unknown`, an empty string is returned.
+*/
+boost::string_ref
+to_string(field f);
+
+/** Return the identifier for a field name.
+
+    The comparison is case-insensitive. If the name does not
+    match any well-known field, `field::unknown` is returned.
+*/
+field
+string_to_field(boost::string_ref const& name);
+
+/// Write the canonical name of a field to an output stream.
+std::ostream&
+operator<<(std::ostream& os, field f);
+
+} // http
+} // beast
+
+#include <beast/http/impl/field.ipp>
+
+#endif
@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_FILE_BODY_HPP
+#define BEAST_HTTP_FILE_BODY_HPP
+
+#include <beast/core/error.hpp>
+#include <beast/http/message.hpp>
+#include <beast/http/resume_context.hpp>
+#include <beast/http/detail/file.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/logic/tribool.hpp>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace beast {
+namespace http {
+
+/** A Body which sends all or part of a file.
+
+    The body refers to a file by path, together with the range
+    of bytes to send. The file is opened when the message is
+    written.
+
+    When the message is sent on a socket with @ref write or
+    @ref async_write on a platform which supports it, the file is
+    transferred by the kernel using `sendfile`, without copying
+    the contents through user space. Otherwise, and when using
+    chunked encoding, the file is read in large blocks.
+
+    Meets the requirements of @b `Body`.
+
+    @par Example
+    @code
+        response<file_body> res;
+        res.status = 200;
+        res.reason = "OK";
+        res.version = 11;
+        res.body.open("index.html");
+        prepare(res);
+        write(sock, res);
+    @endcode
+*/
+struct file_body
+{
+    /// The type of the `message::body` member
+    class value_type
+    {
+        std::string path_;
+        std::uint64_t file_size_ = 0;
+        std::uint64_t offset_ = 0;
+        std::uint64_t size_ = 0;
+
+    public:
+        /// Default constructor, the body is empty.
+        value_type() = default;
+
+        /** Select a file to send.
+
+            The file is opened to determine its size, and the
+            entire file is selected.
+
+            @param path The path of the file.
+
+            @param ec Set to the error, if any occurred.
+        */
+        void
+        open(std::string path, error_code& ec)
+        {
+            detail::file f;
+            f.open(path, ec);
+            if(ec)
+                return;
+            auto const n = f.size(ec);
+            if(ec)
+                return;
+            path_ = std::move(path);
+            file_size_ = n;
+            offset_ = 0;
+            size_ = n;
+        }
+
+        /** Select a file to send.
+
+            The file is opened to determine its size, and the
+            entire file is selected.
+
+            @param path The path of the file.
+
+            @throws system_error Thrown on failure.
+        */
+        void
+        open(std::string path)
+        {
+            error_code ec;
+            open(std::move(path), ec);
+            if(ec)
+                throw system_error{ec};
+        }
+
+        /** Select a range of bytes within the file.
+
+            This is used to send a partial response.
+
+            @param offset The offset of the first byte to send.
+
+            @param size The number of bytes to send.
+
+            @throws std::out_of_range if the range is not within
+            the file.
+        */
+        void
+        range(std::uint64_t offset, std::uint64_t size)
+        {
+            if(offset > file_size_ || size > file_size_ - offset)
+                throw std::out_of_range{"file_body range"};
+            offset_ = offset;
+            size_ = size;
+        }
+
+        /// Returns the path of the file.
+        std::string const&
+        path() const
+        {
+            return path_;
+        }
+
+        /// Returns the size of the file when it was opened.
+        std::uint64_t
+        file_size() const
+        {
+            return file_size_;
+        }
+
+        /// Returns the offset of the first byte to send.
+        std::uint64_t
+        offset() const
+        {
+            return offset_;
+        }
+
+        /// Returns the number of bytes to send.
+        std::uint64_t
+        size() const
+        {
+            return size_;
+        }
+    };
+
+#if GENERATING_DOCS
+private:
+#endif
+
+    class writer
+    {
+        value_type const& body_;
+        detail::file file_;
+        std::uint64_t offset_;
+        std::uint64_t remain_;
+        std::unique_ptr<char[]> buf_;
+
+    public:
+        /// The size of the blocks read when not using `sendfile`.
+        static std::size_t constexpr buffer_size = 65536;
+
+        template<bool isRequest, class Fields>
+        explicit
+        writer(message<isRequest, file_body, Fields> const& m) noexcept
+            : body_(m.body)
+            , offset_(m.body.offset())
+            , remain_(m.body.size())
+        {
+        }
+
+        void
+        init(error_code& ec) noexcept
+        {
+            if(remain_ == 0)
+                return;
+            file_.open(body_.path(), ec);
+            if(ec)
+                return;
+            auto const n = file_.size(ec);
+            if(ec)
+                return;
+            // The file was truncated after it was selected
+            if(n < offset_ || n - offset_ < remain_)
+                ec = boost::system::errc::make_error_code(
+                    boost::system::errc::io_error);
+        }
+
+        std::uint64_t
+        content_length() const noexcept
+        {
+            return body_.size();
+        }
+
+        template<class WriteFunction>
+        boost::tribool
+        write(resume_context&&, error_code& ec,
+            WriteFunction&& wf) noexcept
+        {
+            if(remain_ == 0)
+            {
+                wf(boost::asio::const_buffers_1{nullptr, 0});
+                return true;
+            }
+            if(! buf_)
+            {
+                buf_.reset(new(std::nothrow) char[buffer_size]);
+                if(! buf_)
+                {
+                    ec = boost::system::errc::make_error_code(
+                        boost::system::errc::not_enough_memory);
+                    return true;
+                }
+            }
+            auto const n = file_.read(offset_, buf_.get(),
+                remain_ < buffer_size ? static_cast<
+                    std::size_t>(remain_) : buffer_size, ec);
+            if(ec)
+                return true;
+            if(n == 0)
+            {
+                // The file was truncated while sending
+                ec = boost::system::errc::make_error_code(
+                    boost::system::errc::io_error);
+                return true;
+            }
+            offset_ += n;
+            remain_ -= n;
+            wf(boost::asio::buffer(buf_.get(), n));
+            return remain_ == 0;
+        }
+
+    #if BEAST_HTTP_FILE_POSIX
+        // These allow the file to be sent with sendfile
+
+        int
+        native_handle() const noexcept
+        {
+            return file_.native_handle();
+        }
+
+        std::uint64_t
+        offset() const noexcept
+        {
+            return offset_;
+        }
+
+        std::uint64_t
+        remain() const noexcept
+        {
+            return remain_;
+        }
+
+        void
+        consume(std::uint64_t n) noexcept
+        {
+            offset_ += n;
+            remain_ -= n;
+        }
+    #endif
+    };
+};
+
+} // http
+} // beast
+
+#endif
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_FILE_MAPPING_HPP
+#define BEAST_HTTP_FILE_MAPPING_HPP
+
+#include <beast/core/error.hpp>
+#include <beast/http/detail/file.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace beast {
+namespace http {
+
+/** A read-only view of the contents of a file.
+
+    On POSIX systems the file is mapped into memory, so the pages
+    are shared with the operating system's page cache. Elsewhere,
+    the contents are read into memory.
+
+    Objects of this type are created with @ref open, and shared
+    through `std::shared_ptr`. The mapping is released when the
+    last reference goes away.
+
+    Because the pages are shared with the file, changes to the file
+    are seen through every existing mapping. A file which is
+    truncated while mapped causes `SIGBUS` when the missing pages
+    are touched, for example while a response is being written, and
+    a file rewritten in place changes the bytes of responses already
+    being sent. Removing the file is safe. Files which are served
+    this way must be replaced by writing a new file and renaming it
+    over the old one, never truncated or rewritten in place.
+*/
+class file_mapping
+{
+    void const* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::int64_t mtime_ = 0;
+#if ! BEAST_HTTP_FILE_POSIX
+    std::unique_ptr<char[]> buf_;
+#endif
+
+    file_mapping() = default;
+
+public:
+    file_mapping(file_mapping const&) = delete;
+    file_mapping& operator=(file_mapping const&) = delete;
+
+    /// Destructor, the mapping is released.
+    ~file_mapping();
+
+    /** Map a file.
+
+        @param path The path of the file.
+
+        @param ec Set to the error, if any occurred.
+
+        @return The mapping, or `nullptr` on error.
+    */
+    static
+    std::shared_ptr<file_mapping const>
+    open(std::string const& path, error_code& ec);
+
+    /// Returns a pointer to the contents of the file.
+    void const*
+    data() const
+    {
+        return data_;
+    }
+
+    /// Returns the size of the file.
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+    /** Returns the last write time of the mapped file.
+
+        The value is only meaningful when compared against
+        another last write time obtained for the same file.
+    */
+    std::int64_t
+    last_write_time() const
+    {
+        return mtime_;
+    }
+
+    /// Returns the contents of the file as a buffer.
+    boost::asio::const_buffer
+    buffer() const
+    {
+        return {data_, size_};
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A cache of shared file mappings.
+
+    Concurrent requests for the same file receive the same
+    @ref file_mapping. An entry is replaced when the size or the
+    last write time of the file changes, so a file which is replaced
+    is mapped again for new requests. Mappings already handed out
+    are not affected by this; see @ref file_mapping for how files
+    must be replaced.
+
+    When the total size of the cached mappings exceeds the limit,
+    mappings which are not in use elsewhere are released. A file
+    larger than the limit is mapped but not cached.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Safe.
+*/
+class file_mapping_cache
+{
+    std::mutex m_;
+    std::unordered_map<std::string,
+        std::shared_ptr<file_mapping const>> map_;
+    std::size_t limit_;
+    std::size_t size_ = 0;
+
+    void
+    evict();
+
+public:
+    /// The default limit on the total size of cached mappings.
+    static std::size_t constexpr default_limit =
+        64 * 1024 * 1024;
+
+    /** Constructor.
+
+        @param limit The limit on the total size of the
+        cached mappings, in bytes.
+    */
+    explicit
+    file_mapping_cache(std::size_t limit = default_limit)
+        : limit_(limit)
+    {
+    }
+
+    file_mapping_cache(file_mapping_cache const&) = delete;
+    file_mapping_cache& operator=(file_mapping_cache const&) = delete;
+
+    /// Returns a cache shared by the whole process.
+    static
+    file_mapping_cache&
+    global()
+    {
+        static file_mapping_cache cache;
+        return cache;
+    }
+
+    /** Return a mapping of a file.
+
+        If the cache holds a mapping of the file and the file
+        has not changed since it was mapped, the cached mapping
+        is returned. Otherwise the file is mapped and cached.
+
+        @param path The path of the file.
+
+        @param ec Set to the error, if any occurred.
+
+        @return The mapping, or `nullptr` on error.
+    */
+    std::shared_ptr<file_mapping const>
+    get(std::string const& path, error_code& ec);
+
+    /// Returns the total size of the cached mappings.
+    std::size_t
+    size();
+
+    /// Remove all mappings from the cache.
+    void
+    clear();
+};
+
+} // http
+} // beast
+
+#include <beast/http/impl/file_mapping.ipp>
+
+#endif
@@ -0,0 +1,24 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_FLAT_FIELDS_HPP
+#define BEAST_HTTP_FLAT_FIELDS_HPP
+
+#include <beast/http/basic_flat_fields.hpp>
+#include <memory>
+
+namespace beast {
+namespace http {
+
+/// A flat HTTP header fields container
+using flat_fields =
+    basic_flat_fields<std::allocator<char>>;
+
+} // http
+} // beast
+
+#endif
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_HEADER_BLOCK_HPP
+#define BEAST_HTTP_HEADER_BLOCK_HPP
+
+#include <boost/asio/buffer.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace beast {
+namespace http {
+
+/** An immutable block of serialized header fields.
+
+    The block holds field lines in their wire format, each of the
+    form `name ": " value CRLF`, built once from a field sequence.
+    Copies share the same storage, so a block built at startup can
+    be attached to every response a server sends and the fields in
+    it are never formatted again.
+
+    To send a block with a message, use @ref prebuilt_fields as the
+    `Fields` type of the message. The block is written after the
+    start line and before the fields of the message.
+
+    @note Fields in the block are not visible to the lookup
+    functions of the message's field container. In particular,
+    the block should not contain fields managed by @ref prepare,
+    such as Connection, Content-Length or Transfer-Encoding.
+*/
+class header_block
+{
+    std::shared_ptr<std::string const> s_;
+
+public:
+    /// Default constructor, the block is empty.
+    header_block() = default;
+
+    /// Copy constructor.
+    header_block(header_block const&) = default;
+
+    /// Copy assignment.
+    header_block& operator=(header_block const&) = default;
+
+    /** Construct the block from a field sequence.
+
+        @param fields The fields to serialize. Each element
+        must provide `name()` and `value()`.
+    */
+    template<class FieldSequence>
+    explicit
+    header_block(FieldSequence const& fields)
+    {
+        std::size_t n = 0;
+        for(auto const& f : fields)
+            n += f.name().size() + f.value().size() + 4;
+        std::string s;
+        s.reserve(n);
+        for(auto const& f : fields)
+        {
+            s.append(f.name().data(), f.name().size());
+            s.append(": ", 2);
+            s.append(f.value().data(), f.value().size());
+            s.append("\r\n", 2);
+        }
+        s_ = std::make_shared<std::string const>(std::move(s));
+    }
+
+    /// Returns `true` if the block holds no fields.
+    bool
+    empty() const
+    {
+        return ! s_ || s_->empty();
+    }
+
+    /// Returns the size of the serialized fields in bytes.
+    std::size_t
+    size() const
+    {
+        return s_ ? s_->size() : 0;
+    }
+
+    /// Returns the serialized fields.
+    boost::asio::const_buffers_1
+    data() const
+    {
+        if(! s_)
+            return {nullptr, 0};
+        return {s_->data(), s_->size()};
+    }
+};
+
+/** A field container with an attached @ref header_block.
+
+    This wraps another field container, adding a prebuilt block
+    of fields which is written with the message. Everything else
+    behaves as the wrapped container.
+
+    @par Example
+    @code
+        header_block const block{server_fields};
+        ...
+        response<string_body, prebuilt_fields<fields>> res;
+        res.fields.prebuilt(block);
+    @endcode
+
+    @tparam Fields The field container to wrap.
+*/
+template<class Fields>
+class prebuilt_fields : public Fields
+{
+    header_block block_;
+
+public:
+    using Fields::Fields;
+
+    /// Default constructor.
+    prebuilt_fields() = default;
+
+    /// Returns the attached header block.
+    header_block const&
+    prebuilt() const
+    {
+        return block_;
+    }
+
+    /// Attach a header block, replacing any previous block.
+    void
+    prebuilt(header_block block)
+    {
+        block_ = std::move(block);
+    }
+};
+
+} // http
+} // beast
+
+#endif
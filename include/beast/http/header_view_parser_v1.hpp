@@ -0,0 +1,583 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_HEADER_VIEW_PARSER_V1_HPP
+#define BEAST_HTTP_HEADER_VIEW_PARSER_V1_HPP
+
+#include <beast/http/basic_parser_v1.hpp>
+#include <beast/http/detail/rfc7230.hpp>
+#include <beast/core/buffer_concepts.hpp>
+#include <beast/core/error.hpp>
+#include <beast/core/detail/ci_char_traits.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace beast {
+namespace http {
+
+/** A zero-copy parser for a HTTP/1 request or response header.
+
+    This class uses the HTTP/1 wire format parser to index a request
+    or response header without copying it. Instead of collecting the
+    start line and fields into strings, the parser records the position
+    and length of each piece within the octets presented to @ref write.
+    Positions are counted from the first octet written to the parser,
+    or to the most recent call to @ref reset.
+
+    No memory is allocated per field. The index is held in a vector
+    whose capacity is retained across calls to @ref reset, so a parser
+    reused for every message on a connection stops allocating once it
+    has seen the largest header.
+
+    To read the parsed header the caller provides a pointer to the
+    first octet, and all of the header octets must be contiguous in
+    memory from that point. The usual arrangement is to leave the
+    octets in the receive buffer, and only consume them after the
+    caller is done with the views:
+
+    @code
+        header_view_parser_v1<true> p;
+        error_code ec;
+        auto const n = p.write(boost::asio::buffer(data, size), ec);
+        if(! ec && p.complete())
+        {
+            auto const v = p.view(data);
+            if(v["Host"] == "example.com")
+                ...
+        }
+    @endcode
+
+    Parsing stops after the header; the body, if any, is left in the
+    input. A field value containing obsolete line folding is presented
+    as the original octets, including the CRLF sequences.
+
+    @tparam isRequest A `bool` indicating whether the parser will be
+    presented with request or response message.
+*/
+template<bool isRequest>
+class header_view_parser_v1
+    : public basic_parser_v1<isRequest,
+        header_view_parser_v1<isRequest>>
+{
+    using base_type = basic_parser_v1<isRequest,
+        header_view_parser_v1<isRequest>>;
+
+public:
+    /// The position and length of a range of octets in the input.
+    struct span
+    {
+        std::size_t pos = 0;
+        std::size_t len = 0;
+    };
+
+    /// The position of a field name and value in the input.
+    struct field_index
+    {
+        span name;
+        span value;
+    };
+
+    class view_type;
+
+private:
+    std::vector<field_index> list_;
+    span method_;
+    span uri_;
+    span reason_;
+    char const* first_ = nullptr;
+    char const* last_ = nullptr;
+    std::size_t pos_ = 0;
+
+public:
+    /// Default constructor
+    header_view_parser_v1() = default;
+
+    /// Move constructor
+    header_view_parser_v1(header_view_parser_v1&&) = default;
+
+    /// Copy constructor (disallowed)
+    header_view_parser_v1(header_view_parser_v1 const&) = delete;
+
+    /// Move assignment (disallowed)
+    header_view_parser_v1& operator=(header_view_parser_v1&&) = delete;
+
+    /// Copy assignment (disallowed)
+    header_view_parser_v1& operator=(header_view_parser_v1 const&) = delete;
+
+    /** Construct the parser.
+
+        @param capacity The number of fields to reserve space for.
+    */
+    explicit
+    header_view_parser_v1(std::size_t capacity)
+    {
+        list_.reserve(capacity);
+    }
+
+    /** Prepare the parser for a new message.
+
+        The index is cleared, but its capacity is kept. Positions
+        in the next message are counted from the first octet written
+        after this call.
+    */
+    void
+    reset()
+    {
+        list_.clear();
+        method_ = {};
+        uri_ = {};
+        reason_ = {};
+        pos_ = 0;
+        base_type::reset();
+    }
+
+    /** Write a sequence of buffers to the parser.
+
+        @param buffers An object meeting the requirements of
+        ConstBufferSequence that represents the input sequence.
+
+        @param ec Set to the error, if any error occurred.
+
+        @return The number of bytes consumed in the input sequence.
+    */
+    template<class ConstBufferSequence>
+#if GENERATING_DOCS
+    std::size_t
+#else
+    typename std::enable_if<
+        ! std::is_convertible<ConstBufferSequence,
+            boost::asio::const_buffer>::value,
+                std::size_t>::type
+#endif
+    write(ConstBufferSequence const& buffers, error_code& ec)
+    {
+        static_assert(is_ConstBufferSequence<
+                ConstBufferSequence>::value,
+            "ConstBufferSequence requirements not met");
+        std::size_t used = 0;
+        for(auto const& buffer : buffers)
+        {
+            auto const n = write(
+                boost::asio::const_buffer(buffer), ec);
+            used += n;
+            if(ec || n < boost::asio::buffer_size(buffer))
+                break;
+        }
+        return used;
+    }
+
+    /** Write a single buffer of data to the parser.
+
+        @param buffer The buffer to write.
+
+        @param ec Set to the error, if any error occurred.
+
+        @return The number of bytes consumed in the buffer.
+    */
+    std::size_t
+    write(boost::asio::const_buffer const& buffer, error_code& ec)
+    {
+        using boost::asio::buffer_cast;
+        using boost::asio::buffer_size;
+        first_ = buffer_cast<char const*>(buffer);
+        last_ = first_ + buffer_size(buffer);
+        auto const n = base_type::write(buffer, ec);
+        pos_ += n;
+        first_ = nullptr;
+        last_ = nullptr;
+        return n;
+    }
+
+    /// Returns the index of fields, in the order they were received.
+    std::vector<field_index> const&
+    fields() const
+    {
+        return list_;
+    }
+
+    /** Returns a view of the parsed header.
+
+        Only valid if @ref complete would return `true`.
+
+        @param data A pointer to the first octet written to the
+        parser. The header must be contiguous from this point.
+    */
+    view_type
+    view(char const* data) const
+    {
+        return view_type{*this, data};
+    }
+
+    /** Returns a view of the parsed header.
+
+        Only valid if @ref complete would return `true`.
+
+        @param buffer A buffer whose first octet is the first
+        octet written to the parser. The header must be contained
+        in this buffer.
+    */
+    view_type
+    view(boost::asio::const_buffer const& buffer) const
+    {
+        BOOST_ASSERT(boost::asio::buffer_size(buffer) >= pos_);
+        return view_type{*this,
+            boost::asio::buffer_cast<char const*>(buffer)};
+    }
+
+private:
+    friend class basic_parser_v1<isRequest, header_view_parser_v1>;
+
+    // Returns `true` if s refers to octets in the current buffer.
+    // The parser also presents a few literal strings which are
+    // not part of the input, such as the SP used to unfold lines.
+    bool
+    in_input(boost::string_ref const& s) const
+    {
+        std::less_equal<char const*> le;
+        return le(first_, s.data()) &&
+            le(s.data() + s.size(), last_);
+    }
+
+    std::size_t
+    position(boost::string_ref const& s) const
+    {
+        return pos_ + static_cast<std::size_t>(
+            s.data() - first_);
+    }
+
+    // Extend a span to include the octets in s. The span
+    // covers everything in between, so that pieces split
+    // across calls to write are joined back together.
+    void
+    extend(span& sp, boost::string_ref const& s)
+    {
+        if(! in_input(s))
+            return;
+        auto const pos = position(s);
+        if(sp.len == 0)
+            sp.pos = pos;
+        sp.len = pos + s.size() - sp.pos;
+    }
+
+    void on_start(error_code&)
+    {
+    }
+
+    void on_method(boost::string_ref const& s, error_code&)
+    {
+        extend(method_, s);
+    }
+
+    void on_uri(boost::string_ref const& s, error_code&)
+    {
+        extend(uri_, s);
+    }
+
+    void on_reason(boost::string_ref const& s, error_code&)
+    {
+        extend(reason_, s);
+    }
+
+    void on_request(error_code&)
+    {
+    }
+
+    void on_response(error_code&)
+    {
+    }
+
+    void on_field(boost::string_ref const& s, error_code&)
+    {
+        BOOST_ASSERT(in_input(s));
+        auto const pos = position(s);
+        if(! list_.empty())
+        {
+            auto& e = list_.back();
+            if(e.value.len == 0 && e.name.pos +
+                    e.name.len == pos)
+            {
+                // continuation of the same name
+                e.name.len += s.size();
+                return;
+            }
+        }
+        list_.emplace_back();
+        auto& e = list_.back();
+        e.name.pos = pos;
+        e.name.len = s.size();
+        e.value.pos = pos + s.size();
+    }
+
+    void on_value(boost::string_ref const& s, error_code&)
+    {
+        BOOST_ASSERT(! list_.empty());
+        extend(list_.back().value, s);
+    }
+
+    void
+    on_header(std::uint64_t, error_code&)
+    {
+    }
+
+    body_what
+    on_body_what(std::uint64_t, error_code&)
+    {
+        return body_what::pause;
+    }
+
+    void on_body(boost::string_ref const&, error_code&)
+    {
+    }
+
+    void on_complete(error_code&)
+    {
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A view of a header indexed by @ref header_view_parser_v1.
+
+    Objects of this type are lightweight references to the parser
+    and the input octets, and are invalidated when either changes.
+    Iterators do not refer to the view, and remain valid for as
+    long as the parser and the input octets do.
+    Field values are presented without leading or trailing whitespace.
+    Lookups by name are case-insensitive.
+*/
+template<bool isRequest>
+class header_view_parser_v1<isRequest>::view_type
+{
+    friend class header_view_parser_v1;
+
+    header_view_parser_v1 const* p_;
+    char const* data_;
+
+    view_type(header_view_parser_v1 const& p,
+            char const* data)
+        : p_(&p)
+        , data_(data)
+    {
+    }
+
+    boost::string_ref
+    str(span const& sp) const
+    {
+        return {data_ + sp.pos, sp.len};
+    }
+
+public:
+    /// The value type of the field sequence.
+    struct value_type
+    {
+        boost::string_ref first;
+        boost::string_ref second;
+
+        boost::string_ref
+        name() const
+        {
+            return first;
+        }
+
+        boost::string_ref
+        value() const
+        {
+            return second;
+        }
+    };
+
+    /// A const iterator to the field sequence.
+    class const_iterator
+    {
+    public:
+        using value_type = typename view_type::value_type;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category =
+            std::forward_iterator_tag;
+
+    private:
+        friend class view_type;
+
+        using iter_type = typename
+            std::vector<field_index>::const_iterator;
+
+        char const* data_ = nullptr;
+        iter_type it_;
+        mutable value_type e_;
+
+        const_iterator(char const* data, iter_type it)
+            : data_(data)
+            , it_(it)
+        {
+        }
+
+        boost::string_ref
+        str(span const& sp) const
+        {
+            return {data_ + sp.pos, sp.len};
+        }
+
+    public:
+        const_iterator() = default;
+
+        bool
+        operator==(const_iterator const& other) const
+        {
+            return it_ == other.it_;
+        }
+
+        bool
+        operator!=(const_iterator const& other) const
+        {
+            return !(*this == other);
+        }
+
+        reference
+        operator*() const
+        {
+            e_.first = str(it_->name);
+            e_.second = http::detail::trim(
+                str(it_->value));
+            return e_;
+        }
+
+        pointer
+        operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator&
+        operator++()
+        {
+            ++it_;
+            return *this;
+        }
+
+        const_iterator
+        operator++(int)
+        {
+            auto temp = *this;
+            ++(*this);
+            return temp;
+        }
+    };
+
+    /// A const iterator to the field sequence.
+    using iterator = const_iterator;
+
+    /// Returns the Request-Method.
+    boost::string_ref
+    method() const
+    {
+        return str(p_->method_);
+    }
+
+    /// Returns the Request-URI.
+    boost::string_ref
+    url() const
+    {
+        return str(p_->uri_);
+    }
+
+    /// Returns the reason-phrase.
+    boost::string_ref
+    reason() const
+    {
+        return str(p_->reason_);
+    }
+
+    /// Returns `true` if the field sequence contains no elements.
+    bool
+    empty() const
+    {
+        return p_->list_.empty();
+    }
+
+    /// Returns the number of elements in the field sequence.
+    std::size_t
+    size() const
+    {
+        return p_->list_.size();
+    }
+
+    /// Returns a const iterator to the beginning of the field sequence.
+    const_iterator
+    begin() const
+    {
+        return {data_, p_->list_.begin()};
+    }
+
+    /// Returns a const iterator to the end of the field sequence.
+    const_iterator
+    end() const
+    {
+        return {data_, p_->list_.end()};
+    }
+
+    /// Returns `true` if the specified field exists.
+    bool
+    exists(boost::string_ref const& name) const
+    {
+        return find(name) != end();
+    }
+
+    /// Returns the number of values for the specified field.
+    std::size_t
+    count(boost::string_ref const& name) const
+    {
+        std::size_t n = 0;
+        for(auto const& e : p_->list_)
+            if(beast::detail::ci_equal(str(e.name), name))
+                ++n;
+        return n;
+    }
+
+    /** Returns an iterator to the case-insensitive matching field name.
+
+        If more than one field with the specified name exists, the
+        first field defined by insertion order is returned.
+    */
+    const_iterator
+    find(boost::string_ref const& name) const
+    {
+        auto it = p_->list_.begin();
+        auto const last = p_->list_.end();
+        for(; it != last; ++it)
+            if(it->name.len == name.size() &&
+                    beast::detail::ci_equal(str(it->name), name))
+                break;
+        return {data_, it};
+    }
+
+    /** Returns the value for a case-insensitive matching header, or `""`.
+
+        If more than one field with the specified name exists, the
+        first field defined by insertion order is returned.
+    */
+    boost::string_ref
+    operator[](boost::string_ref const& name) const
+    {
+        auto it = find(name);
+        if(it == end())
+            return {};
+        return it->second;
+    }
+};
+
+} // http
+} // beast
+
+#endif
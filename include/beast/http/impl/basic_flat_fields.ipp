@@ -0,0 +1,576 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_IMPL_BASIC_FLAT_FIELDS_IPP
+#define BEAST_HTTP_IMPL_BASIC_FLAT_FIELDS_IPP
+
+#include <beast/core/detail/ci_char_traits.hpp>
+#include <beast/http/detail/rfc7230.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace beast {
+namespace http {
+
+template<class Allocator>
+class basic_flat_fields<Allocator>::const_iterator
+{
+public:
+    using value_type =
+        typename basic_flat_fields::value_type;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category =
+        std::bidirectional_iterator_tag;
+
+private:
+    friend class basic_flat_fields;
+
+    basic_flat_fields const* f_ = nullptr;
+    std::size_t i_ = 0;
+    mutable value_type v_;
+
+    const_iterator(basic_flat_fields const& f, std::size_t i)
+        : f_(&f)
+        , i_(i)
+    {
+    }
+
+public:
+    const_iterator() = default;
+    const_iterator(const_iterator&& other) = default;
+    const_iterator(const_iterator const& other) = default;
+    const_iterator& operator=(const_iterator&& other) = default;
+    const_iterator& operator=(const_iterator const& other) = default;
+
+    bool
+    operator==(const_iterator const& other) const
+    {
+        return f_ == other.f_ && i_ == other.i_;
+    }
+
+    bool
+    operator!=(const_iterator const& other) const
+    {
+        return ! (*this == other);
+    }
+
+    reference
+    operator*() const
+    {
+        auto const& e = f_->list_[i_];
+        v_.first = f_->name_of(e);
+        v_.second = f_->value_of(e);
+        return v_;
+    }
+
+    pointer
+    operator->() const
+    {
+        return &**this;
+    }
+
+    const_iterator&
+    operator++()
+    {
+        ++i_;
+        return *this;
+    }
+
+    const_iterator
+    operator++(int)
+    {
+        auto temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    const_iterator&
+    operator--()
+    {
+        --i_;
+        return *this;
+    }
+
+    const_iterator
+    operator--(int)
+    {
+        auto temp = *this;
+        --(*this);
+        return temp;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<class Allocator>
+bool
+basic_flat_fields<Allocator>::
+in_arena(boost::string_ref const& s) const
+{
+    // Only pointers into the same array may be compared
+    auto const first = reinterpret_cast<std::uintptr_t>(
+        arena_.data());
+    auto const p = reinterpret_cast<std::uintptr_t>(
+        s.data());
+    return p >= first && p < first + arena_.capacity();
+}
+
+template<class Allocator>
+template<class Pred>
+std::size_t
+basic_flat_fields<Allocator>::
+find_index(std::uint32_t hash, Pred const& pred) const
+{
+    if(list_.empty())
+        return list_.size();
+    auto const mask = table_.size() - 1;
+    for(auto i = hash & mask;; i = (i + 1) & mask)
+    {
+        auto const slot = table_[i];
+        if(slot == 0)
+            return list_.size();
+        auto const& e = list_[slot - 1];
+        if(e.hash == hash && pred(e))
+            return slot - 1;
+    }
+}
+
+template<class Allocator>
+template<class Pred>
+std::size_t
+basic_flat_fields<Allocator>::
+count_if(std::uint32_t hash, Pred const& pred) const
+{
+    if(list_.empty())
+        return 0;
+    std::size_t n = 0;
+    auto const mask = table_.size() - 1;
+    for(auto i = hash & mask;; i = (i + 1) & mask)
+    {
+        auto const slot = table_[i];
+        if(slot == 0)
+            return n;
+        auto const& e = list_[slot - 1];
+        if(e.hash == hash && pred(e))
+            ++n;
+    }
+}
+
+template<class Allocator>
+template<class Pred>
+std::size_t
+basic_flat_fields<Allocator>::
+erase_if(Pred const& pred)
+{
+    std::size_t out = 0;
+    std::uint32_t pos = 0;
+    for(std::size_t i = 0; i < list_.size(); ++i)
+    {
+        auto e = list_[i];
+        if(pred(e))
+            continue;
+        auto const len = e.name_len + e.value_len;
+        if(e.pos != pos)
+            std::memmove(&arena_[pos], &arena_[e.pos], len);
+        e.pos = pos;
+        pos += len;
+        list_[out++] = e;
+    }
+    auto const n = list_.size() - out;
+    arena_.resize(pos);
+    list_.resize(out);
+    rehash(list_.size());
+    return n;
+}
+
+template<class Allocator>
+std::size_t
+basic_flat_fields<Allocator>::
+find_index(boost::string_ref const& name) const
+{
+    return find_index(beast::detail::ci_hash(name),
+        [&](entry const& e)
+        {
+            auto const s = name_of(e);
+            return s.size() == name.size() &&
+                beast::detail::ci_equal(s, name);
+        });
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+insert(std::uint32_t hash, field id,
+    boost::string_ref const& name, boost::string_ref value)
+{
+    value = detail::trim(value);
+    auto const len = name.size() + value.size();
+    if(name.size() > std::numeric_limits<std::uint16_t>::max())
+        throw std::length_error{"field name too large"};
+    if(len > std::numeric_limits<std::uint32_t>::max() -
+            arena_.size() ||
+        list_.size() >= std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error{"fields too large"};
+    if(arena_.size() + len > arena_.capacity() &&
+        (in_arena(name) || in_arena(value)))
+    {
+        // Growing the arena would invalidate the arguments
+        std::string const s(name.data(), name.size());
+        std::string const v(value.data(), value.size());
+        return insert(hash, id, s, v);
+    }
+    entry e;
+    e.hash = hash;
+    e.pos = static_cast<std::uint32_t>(arena_.size());
+    e.value_len = static_cast<std::uint32_t>(value.size());
+    e.name_len = static_cast<std::uint16_t>(name.size());
+    e.id = id;
+    arena_.insert(arena_.end(), name.begin(), name.end());
+    arena_.insert(arena_.end(), value.begin(), value.end());
+    list_.push_back(e);
+    if(2 * list_.size() > table_.size())
+        rehash(list_.size());
+    else
+        place(list_.size() - 1);
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+place(std::size_t i)
+{
+    // Equal names are probed in insertion order,
+    // so the first match is the earliest field.
+    auto const mask = table_.size() - 1;
+    for(auto j = list_[i].hash & mask;; j = (j + 1) & mask)
+    {
+        if(table_[j] == 0)
+        {
+            table_[j] = static_cast<std::uint32_t>(i + 1);
+            return;
+        }
+    }
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+rehash(std::size_t n)
+{
+    // Load factor is kept at or below one half
+    std::size_t size = 16;
+    while(size < 2 * n)
+        size *= 2;
+    if(size > table_.size())
+        table_.assign(size, 0);
+    else
+        std::fill(table_.begin(), table_.end(), 0);
+    for(std::size_t i = 0; i < list_.size(); ++i)
+        place(i);
+}
+
+//------------------------------------------------------------------------------
+
+template<class Allocator>
+basic_flat_fields<Allocator>::
+basic_flat_fields(Allocator const& alloc)
+    : arena_(alloc)
+    , list_(alloc)
+    , table_(alloc)
+{
+}
+
+template<class Allocator>
+basic_flat_fields<Allocator>::
+basic_flat_fields(basic_flat_fields&& other)
+    : arena_(std::move(other.arena_))
+    , list_(std::move(other.list_))
+    , table_(std::move(other.table_))
+{
+    other.arena_.clear();
+    other.list_.clear();
+    other.table_.clear();
+}
+
+template<class Allocator>
+auto
+basic_flat_fields<Allocator>::
+operator=(basic_flat_fields&& other) ->
+    basic_flat_fields&
+{
+    if(this == &other)
+        return *this;
+    arena_ = std::move(other.arena_);
+    list_ = std::move(other.list_);
+    table_ = std::move(other.table_);
+    other.arena_.clear();
+    other.list_.clear();
+    other.table_.clear();
+    return *this;
+}
+
+template<class Allocator>
+template<class OtherAlloc>
+basic_flat_fields<Allocator>::
+basic_flat_fields(basic_flat_fields<OtherAlloc> const& other)
+{
+    reserve(other.size(), other.arena_.size());
+    copy_from(other);
+}
+
+template<class Allocator>
+template<class OtherAlloc>
+auto
+basic_flat_fields<Allocator>::
+operator=(basic_flat_fields<OtherAlloc> const& other) ->
+    basic_flat_fields&
+{
+    clear();
+    reserve(other.size(), other.arena_.size());
+    copy_from(other);
+    return *this;
+}
+
+template<class Allocator>
+template<class FwdIt>
+basic_flat_fields<Allocator>::
+basic_flat_fields(FwdIt first, FwdIt last)
+{
+    for(;first != last; ++first)
+        insert(first->name(), first->value());
+}
+
+template<class Allocator>
+auto
+basic_flat_fields<Allocator>::
+begin() const ->
+    const_iterator
+{
+    return {*this, 0};
+}
+
+template<class Allocator>
+auto
+basic_flat_fields<Allocator>::
+end() const ->
+    const_iterator
+{
+    return {*this, list_.size()};
+}
+
+template<class Allocator>
+bool
+basic_flat_fields<Allocator>::
+exists(boost::string_ref const& name) const
+{
+    return find_index(name) != list_.size();
+}
+
+template<class Allocator>
+std::size_t
+basic_flat_fields<Allocator>::
+count(boost::string_ref const& name) const
+{
+    return count_if(beast::detail::ci_hash(name),
+        [&](entry const& e)
+        {
+            auto const s = name_of(e);
+            return s.size() == name.size() &&
+                beast::detail::ci_equal(s, name);
+        });
+}
+
+template<class Allocator>
+auto
+basic_flat_fields<Allocator>::
+find(boost::string_ref const& name) const ->
+    iterator
+{
+    return {*this, find_index(name)};
+}
+
+template<class Allocator>
+boost::string_ref
+basic_flat_fields<Allocator>::
+operator[](boost::string_ref const& name) const
+{
+    auto const i = find_index(name);
+    if(i == list_.size())
+        return {};
+    return value_of(list_[i]);
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+clear() noexcept
+{
+    arena_.clear();
+    list_.clear();
+    std::fill(table_.begin(), table_.end(), 0);
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+reserve(std::size_t fields, std::size_t bytes)
+{
+    arena_.reserve(bytes);
+    list_.reserve(fields);
+    if(2 * fields > table_.size())
+        rehash(fields);
+}
+
+template<class Allocator>
+std::size_t
+basic_flat_fields<Allocator>::
+erase(boost::string_ref const& name)
+{
+    if(find_index(name) == list_.size())
+        return 0;
+    if(in_arena(name))
+    {
+        // The name would be overwritten while compacting
+        std::string const s(name.data(), name.size());
+        return erase(s);
+    }
+    auto const h = beast::detail::ci_hash(name);
+    return erase_if(
+        [&](entry const& e)
+        {
+            if(e.hash != h)
+                return false;
+            auto const s = name_of(e);
+            return s.size() == name.size() &&
+                beast::detail::ci_equal(s, name);
+        });
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+insert(boost::string_ref const& name,
+    boost::string_ref value)
+{
+    auto const h = beast::detail::ci_hash(name);
+    insert(h, detail::string_to_field(name, h), name, value);
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+replace(boost::string_ref const& name,
+    boost::string_ref value)
+{
+    value = detail::trim(value);
+    if(in_arena(name) || in_arena(value))
+    {
+        // erase moves the contents of the arena
+        std::string const s(name.data(), name.size());
+        std::string const v(value.data(), value.size());
+        return replace(s, v);
+    }
+    erase(name);
+    insert(name, value);
+}
+
+template<class Allocator>
+bool
+basic_flat_fields<Allocator>::
+exists(field f) const
+{
+    return find(f) != end();
+}
+
+template<class Allocator>
+std::size_t
+basic_flat_fields<Allocator>::
+count(field f) const
+{
+    BOOST_ASSERT(f != field::unknown);
+    return count_if(detail::field_hash(
+        static_cast<std::size_t>(f)),
+        [f](entry const& e)
+        {
+            return e.id == f;
+        });
+}
+
+template<class Allocator>
+auto
+basic_flat_fields<Allocator>::
+find(field f) const ->
+    iterator
+{
+    BOOST_ASSERT(f != field::unknown);
+    return {*this, find_index(detail::field_hash(
+        static_cast<std::size_t>(f)),
+        [f](entry const& e)
+        {
+            return e.id == f;
+        })};
+}
+
+template<class Allocator>
+boost::string_ref
+basic_flat_fields<Allocator>::
+operator[](field f) const
+{
+    auto const it = find(f);
+    if(it == end())
+        return {};
+    return it->second;
+}
+
+template<class Allocator>
+std::size_t
+basic_flat_fields<Allocator>::
+erase(field f)
+{
+    if(! exists(f))
+        return 0;
+    return erase_if(
+        [f](entry const& e)
+        {
+            return e.id == f;
+        });
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+insert(field f, boost::string_ref value)
+{
+    BOOST_ASSERT(f != field::unknown);
+    insert(detail::field_hash(static_cast<std::size_t>(f)),
+        f, {}, value);
+}
+
+template<class Allocator>
+void
+basic_flat_fields<Allocator>::
+replace(field f, boost::string_ref value)
+{
+    value = detail::trim(value);
+    if(in_arena(value))
+    {
+        // erase moves the contents of the arena
+        std::string const v(value.data(), value.size());
+        return replace(f, v);
+    }
+    erase(f);
+    insert(f, value);
+}
+
+} // http
+} // beast
+
+#endif
@@ -9,6 +9,7 @@
 #define BEAST_HTTP_IMPL_BASIC_PARSER_V1_IPP
 
 #include <beast/http/detail/rfc7230.hpp>
+#include <beast/http/detail/scan.hpp>
 #include <beast/core/buffer_concepts.hpp>
 #include <boost/assert.hpp>
 
@@ -147,6 +148,8 @@ write(boost::asio::const_buffer const& buffer, error_code& ec)
     using beast::http::detail::is_digit;
     using beast::http::detail::is_tchar;
     using beast::http::detail::is_text;
+    using beast::http::detail::skip_field_chars;
+    using beast::http::detail::skip_value_chars;
     using beast::http::detail::to_field_char;
     using beast::http::detail::to_value_char;
     using beast::http::detail::unhex;
@@ -489,6 +492,12 @@ write(boost::asio::const_buffer const& buffer, error_code& ec)
         {
             for(; p != end; ++p)
             {
+                if(fs_ == h_general)
+                {
+                    p = skip_field_chars(p, end);
+                    if(p == end)
+                        break;
+                }
                 ch = *p;
                 auto c = to_field_char(ch);
                 if(! c)
@@ -608,6 +617,12 @@ write(boost::asio::const_buffer const& buffer, error_code& ec)
         {
             for(; p != end; ++p)
             {
+                if(fs_ == h_general)
+                {
+                    p = skip_value_chars(p, end);
+                    if(p == end)
+                        break;
+                }
                 ch = *p;
                 if(ch == '\r')
                 {
@@ -1251,6 +1266,7 @@ basic_parser_v1<isRequest, Derived>::
 reset()
 {
     cb_ = nullptr;
+    flags_ = 0;
     h_left_ = h_max_;
     b_left_ = b_max_;
     reset(std::integral_constant<bool, isRequest>{});
@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_IMPL_FIELD_IPP
+#define BEAST_HTTP_IMPL_FIELD_IPP
+
+#include <beast/core/detail/ci_char_traits.hpp>
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace beast {
+namespace http {
+
+namespace detail {
+
+/*  Tables for the well-known fields, indexed by field.
+
+    The perfect hash maps the case-insensitive hash of a name, as
+    computed by beast::detail::ci_hash, to one of 256 slots. Each
+    slot holds the field whose hash lands there, or zero. The
+    multiplier was found by search so that no two well-known
+    fields share a slot; the tests check every entry.
+*/
+
+std::size_t constexpr field_count = 80;
+
+std::uint32_t constexpr field_hash_mul = 1379869u;
+
+inline
+boost::string_ref
+field_name(std::size_t i)
+{
+    static char const* const tab[field_count + 1] = {
+        "",
+        "Accept",
+        "Accept-Charset",
+        "Accept-Encoding",
+        "Accept-Language",
+        "Accept-Ranges",
+        "Access-Control-Allow-Credentials",
+        "Access-Control-Allow-Headers",
+        "Access-Control-Allow-Methods",
+        "Access-Control-Allow-Origin",
+        "Access-Control-Expose-Headers",
+        "Access-Control-Max-Age",
+        "Access-Control-Request-Headers",
+        "Access-Control-Request-Method",
+        "Age",
+        "Allow",
+        "Alt-Svc",
+        "Authorization",
+        "Cache-Control",
+        "Connection",
+        "Content-Disposition",
+        "Content-Encoding",
+        "Content-Language",
+        "Content-Length",
+        "Content-Location",
+        "Content-MD5",
+        "Content-Range",
+        "Content-Security-Policy",
+        "Content-Type",
+        "Cookie",
+        "Date",
+        "DNT",
+        "ETag",
+        "Expect",
+        "Expires",
+        "Forwarded",
+        "From",
+        "Host",
+        "If-Match",
+        "If-Modified-Since",
+        "If-None-Match",
+        "If-Range",
+        "If-Unmodified-Since",
+        "Keep-Alive",
+        "Last-Modified",
+        "Link",
+        "Location",
+        "Max-Forwards",
+        "Origin",
+        "Pragma",
+        "Proxy-Authenticate",
+        "Proxy-Authorization",
+        "Proxy-Connection",
+        "Range",
+        "Referer",
+        "Retry-After",
+        "Sec-WebSocket-Accept",
+        "Sec-WebSocket-Extensions",
+        "Sec-WebSocket-Key",
+        "Sec-WebSocket-Protocol",
+        "Sec-WebSocket-Version",
+        "Server",
+        "Set-Cookie",
+        "Strict-Transport-Security",
+        "TE",
+        "Trailer",
+        "Transfer-Encoding",
+        "Upgrade",
+        "Upgrade-Insecure-Requests",
+        "User-Agent",
+        "Vary",
+        "Via",
+        "Warning",
+        "WWW-Authenticate",
+        "X-Content-Type-Options",
+        "X-Forwarded-For",
+        "X-Forwarded-Host",
+        "X-Forwarded-Proto",
+        "X-Frame-Options",
+        "X-Requested-With",
+        "X-XSS-Protection",
+    };
+    static std::uint8_t constexpr len[field_count + 1] = {
+        0,
+        6, 14, 15, 15, 13, 32, 28, 28, 27, 29, 22, 30, 29, 3, 5, 7,
+        13, 13, 10, 19, 16, 16, 14, 16, 11, 13, 23, 12, 6, 4, 3, 4,
+        6, 7, 9, 4, 4, 8, 17, 13, 8, 19, 10, 13, 4, 8, 12, 6,
+        6, 18, 19, 16, 5, 7, 11, 20, 24, 17, 22, 21, 6, 10, 25, 2,
+        7, 17, 7, 25, 10, 4, 3, 7, 16, 22, 15, 16, 17, 15, 16, 16,
+    };
+    return {tab[i], len[i]};
+}
+
+// Returns the ci_hash of the canonical name of each field
+inline
+std::uint32_t
+field_hash(std::size_t i)
+{
+    static std::array<std::uint32_t, field_count + 1> constexpr tab = {{
+        0x00000000u,
+        0x08247e29u, 0xda645c68u, 0xc9715a99u, 0x75f67716u,
+        0x6625cf66u, 0x35b4ca8cu, 0x5adb24c0u, 0x81a75facu,
+        0xa1937becu, 0x92055aa9u, 0x9c6efbceu, 0xd68cc290u,
+        0x9011af27u, 0x2c41499cu, 0xaeb1a832u, 0x80154303u,
+        0x913657beu, 0x50c8a4cdu, 0x38b99ed9u, 0xe7d03e5cu,
+        0x03e2ed88u, 0x017d1113u, 0x4df9451du, 0x893b4c2eu,
+        0xbb31d46bu, 0xd3ecfa4au, 0x5d85a5dcu, 0xfcf70995u,
+        0x77a740bfu, 0xd472dc59u, 0xd96ae729u, 0x06c857c0u,
+        0x96da6b58u, 0x3e8ec783u, 0x588604abu, 0x95cd8075u,
+        0xaffea56fu, 0xd67076eau, 0x83e879a9u, 0x972b6177u,
+        0x8b887e3eu, 0xe230478au, 0xe18edb80u, 0xc0575a6bu,
+        0x0ddb0669u, 0x0bf5a9a6u, 0x6cd905d6u, 0xd97f9a4fu,
+        0x19fa4625u, 0xa17edaefu, 0xa01f18bbu, 0x32c09da6u,
+        0xfadc0cd2u, 0xec9af966u, 0xc6da1376u, 0xe24d5583u,
+        0x3b4c03c1u, 0xcab5ec26u, 0xd5b978fbu, 0x050a86e1u,
+        0x40ac3dd2u, 0x6e2be738u, 0xf6a71e21u, 0x3c453eb2u,
+        0x816fede0u, 0xddb4744cu, 0xdc97cc77u, 0x93c51f85u,
+        0x24259beeu, 0x40abde45u, 0x69122c13u, 0x792112efu,
+        0x2e7bcf02u, 0xd93b89c9u, 0xadb2f988u, 0x28867067u,
+        0x2eb2af39u, 0xee0d1548u, 0x5d54fe11u, 0x95132148u,
+    }};
+    return tab[i];
+}
+
+inline
+std::size_t
+field_slot(std::uint32_t hash)
+{
+    return (hash * field_hash_mul) >> 24;
+}
+
+/*  Return the field for a name whose ci_hash is already known.
+
+    This lets containers which hash names on insertion identify
+    well-known fields without hashing twice.
+*/
+inline
+field
+string_to_field(boost::string_ref const& name, std::uint32_t hash)
+{
+    static std::array<std::uint8_t, 256> constexpr tab = {{
+         0,  0,  0, 29, 73,  0,  0,  0,  0, 24,  0,  0, 55,  0,  0, 79,
+        67,  0, 45,  0,  0, 72,  0,  0,  0,  0, 68,  0,  0,  0,  0,  0,
+         0, 42, 23,  0,  0,  0,  0,  0,  0, 76, 74, 16,  0,  0, 57,  0,
+        50,  0, 38,  0,  0,  0, 60, 52,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0, 34,  0,  1, 10, 48, 59, 58,  0,  7,  0, 65, 15,  0,  0,
+         0,  0,  0,  0,  0, 21,  0,  0,  0,  0,  0, 25,  0,  0, 43,  0,
+         0,  0, 49,  0,  0,  0,  0,  0, 22,  0,  0,  0, 30, 78, 37, 77,
+        31,  0, 11,  3,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 40, 26,
+        53,  0, 27, 71,  0,  0, 66,  0,  9,  0,  0,  0,  0, 63,  0,  0,
+         0,  0,  0,  0,  0,  0,  6,  0,  0,  0,  0, 19,  4,  0, 17, 14,
+        41,  0, 39,  0, 18,  0,  5, 13,  0, 80,  0,  0,  0, 47,  0,  0,
+         8,  0,  0,  0, 46,  0,  0,  0,  0,  0,  0,  0, 54, 35, 36,  0,
+         0, 64,  0, 20,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  0,
+         0, 61,  0,  0,  0,  0, 33,  0,  0, 62,  0,  0,  0,  0, 51,  0,
+         0, 56,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 32,  0,  0, 75,
+         0, 69,  0, 28,  0, 70, 12,  0,  0,  0,  0, 44,  0,  0,  0,  0,
+    }};
+    auto const i = tab[field_slot(hash)];
+    if(i == 0 || field_hash(i) != hash)
+        return field::unknown;
+    auto const s = field_name(i);
+    if(s.size() != name.size() ||
+            ! beast::detail::ci_equal(s, name))
+        return field::unknown;
+    return static_cast<field>(i);
+}
+
+} // detail
+
+inline
+boost::string_ref
+to_string(field f)
+{
+    auto const i = static_cast<std::size_t>(f);
+    if(i > detail::field_count)
+        return {};
+    return detail::field_name(i);
+}
+
+inline
+field
+string_to_field(boost::string_ref const& name)
+{
+    return detail::string_to_field(
+        name, beast::detail::ci_hash(name));
+}
+
+inline
+std::ostream&
+operator<<(std::ostream& os, field f)
+{
+    auto const s = to_string(f);
+    return os.write(s.data(), s.size());
+}
+
+} // http
+} // beast
+
+#endif
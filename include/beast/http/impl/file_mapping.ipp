@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_IMPL_FILE_MAPPING_IPP
+#define BEAST_HTTP_IMPL_FILE_MAPPING_IPP
+
+#include <limits>
+
+#if BEAST_HTTP_FILE_POSIX
+# include <sys/mman.h>
+#endif
+
+namespace beast {
+namespace http {
+
+inline
+file_mapping::
+~file_mapping()
+{
+#if BEAST_HTTP_FILE_POSIX
+    if(size_ > 0)
+        ::munmap(const_cast<void*>(data_), size_);
+#endif
+}
+
+inline
+std::shared_ptr<file_mapping const>
+file_mapping::
+open(std::string const& path, error_code& ec)
+{
+    std::uint64_t size;
+    std::int64_t mtime;
+#if BEAST_HTTP_FILE_POSIX
+    detail::file f;
+    f.open(path, ec);
+    if(ec)
+        return nullptr;
+    // Size and time of the file actually opened, in
+    // case the path was replaced since it was checked.
+    f.stat(size, mtime, ec);
+    if(ec)
+        return nullptr;
+#else
+    detail::stat_file(path, size, mtime, ec);
+    if(ec)
+        return nullptr;
+    detail::file f;
+    f.open(path, ec);
+    if(ec)
+        return nullptr;
+    size = f.size(ec);
+    if(ec)
+        return nullptr;
+#endif
+    if(size > (std::numeric_limits<std::size_t>::max)())
+    {
+        ec = boost::system::errc::make_error_code(
+            boost::system::errc::file_too_large);
+        return nullptr;
+    }
+    std::shared_ptr<file_mapping> p{new file_mapping};
+    p->mtime_ = mtime;
+    if(size == 0)
+        return p;
+#if BEAST_HTTP_FILE_POSIX
+    // MAP_PRIVATE would not help here, truncating the file
+    // still invalidates the pages. See the class documentation.
+    auto const data = ::mmap(nullptr, static_cast<std::size_t>(size),
+        PROT_READ, MAP_SHARED, f.native_handle(), 0);
+    if(data == MAP_FAILED)
+    {
+        ec = detail::last_file_error();
+        return nullptr;
+    }
+#ifdef MADV_WILLNEED
+    ::madvise(data, static_cast<std::size_t>(size), MADV_WILLNEED);
+#endif
+    p->data_ = data;
+    p->size_ = static_cast<std::size_t>(size);
+#else
+    p->buf_.reset(new char[static_cast<std::size_t>(size)]);
+    std::size_t n = 0;
+    while(n < size)
+    {
+        auto const bytes = f.read(n, p->buf_.get() + n,
+            static_cast<std::size_t>(size) - n, ec);
+        if(ec)
+            return nullptr;
+        if(bytes == 0)
+        {
+            ec = boost::system::errc::make_error_code(
+                boost::system::errc::io_error);
+            return nullptr;
+        }
+        n += bytes;
+    }
+    p->data_ = p->buf_.get();
+    p->size_ = n;
+#endif
+    return p;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void
+file_mapping_cache::
+evict()
+{
+    // Only the cache holds these, nobody can
+    // acquire another reference while locked.
+    for(auto it = map_.begin();
+        it != map_.end() && size_ > limit_;)
+    {
+        if(it->second.use_count() == 1)
+        {
+            size_ -= it->second->size();
+            it = map_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+inline
+std::shared_ptr<file_mapping const>
+file_mapping_cache::
+get(std::string const& path, error_code& ec)
+{
+    std::uint64_t size;
+    std::int64_t mtime;
+    detail::stat_file(path, size, mtime, ec);
+    if(ec)
+        return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        auto const it = map_.find(path);
+        if(it != map_.end() &&
+            it->second->size() == size &&
+            it->second->last_write_time() == mtime)
+            return it->second;
+    }
+    // Map outside the lock, so a slow file
+    // does not hold up requests for others.
+    auto p = file_mapping::open(path, ec);
+    if(ec)
+        return nullptr;
+    std::lock_guard<std::mutex> lock(m_);
+    auto const it = map_.find(path);
+    if(it != map_.end())
+    {
+        if(it->second->last_write_time() ==
+                p->last_write_time() &&
+            it->second->size() == p->size())
+            // Another thread mapped the same file
+            return it->second;
+        size_ -= it->second->size();
+        map_.erase(it);
+    }
+    if(p->size() > limit_)
+        return p;
+    map_.emplace(path, p);
+    size_ += p->size();
+    if(size_ > limit_)
+        evict();
+    return p;
+}
+
+inline
+std::size_t
+file_mapping_cache::
+size()
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return size_;
+}
+
+inline
+void
+file_mapping_cache::
+clear()
+{
+    std::lock_guard<std::mutex> lock(m_);
+    map_.clear();
+    size_ = 0;
+}
+
+} // http
+} // beast
+
+#endif
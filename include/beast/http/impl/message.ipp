@@ -11,6 +11,7 @@
 #include <beast/core/error.hpp>
 #include <beast/http/concepts.hpp>
 #include <beast/http/rfc7230.hpp>
+#include <beast/http/detail/field_access.hpp>
 #include <beast/core/detail/ci_char_traits.hpp>
 #include <beast/core/detail/type_traits.hpp>
 #include <boost/assert.hpp>
@@ -64,11 +65,13 @@ is_keep_alive(header<isRequest, Fields> const& msg)
     BOOST_ASSERT(msg.version == 10 || msg.version == 11);
     if(msg.version == 11)
     {
-        if(token_list{msg.fields["Connection"]}.exists("close"))
+        if(token_list{detail::get_field(
+                msg.fields, field::connection)}.exists("close"))
             return false;
         return true;
     }
-    if(token_list{msg.fields["Connection"]}.exists("keep-alive"))
+    if(token_list{detail::get_field(
+            msg.fields, field::connection)}.exists("keep-alive"))
         return true;
     return false;
 }
@@ -80,7 +83,8 @@ is_upgrade(header<isRequest, Fields> const& msg)
     BOOST_ASSERT(msg.version == 10 || msg.version == 11);
     if(msg.version == 10)
         return false;
-    if(token_list{msg.fields["Connection"]}.exists("upgrade"))
+    if(token_list{detail::get_field(
+            msg.fields, field::connection)}.exists("upgrade"))
         return true;
     return false;
 }
@@ -175,15 +179,16 @@ prepare(message<isRequest, Body, Fields>& msg,
     detail::prepare_options(pi, msg,
         std::forward<Options>(options)...);
 
-    if(msg.fields.exists("Connection"))
+    if(detail::exists_field(msg.fields, field::connection))
         throw make_exception<std::invalid_argument>(
             "prepare called with Connection field set", __FILE__, __LINE__);
 
-    if(msg.fields.exists("Content-Length"))
+    if(detail::exists_field(msg.fields, field::content_length))
         throw make_exception<std::invalid_argument>(
             "prepare called with Content-Length field set", __FILE__, __LINE__);
 
-    if(token_list{msg.fields["Transfer-Encoding"]}.exists("chunked"))
+    if(token_list{detail::get_field(msg.fields,
+            field::transfer_encoding)}.exists("chunked"))
         throw make_exception<std::invalid_argument>(
             "prepare called with Transfer-Encoding: chunked set", __FILE__, __LINE__);
 
@@ -201,8 +206,8 @@ prepare(message<isRequest, Body, Fields>& msg,
                     if(*pi.content_length > 0 ||
                         ci_equal(msg.method, "POST"))
                     {
-                        msg.fields.insert(
-                            "Content-Length", *pi.content_length);
+                        detail::insert_field(msg.fields,
+                            field::content_length, *pi.content_length);
                     }
                 }
 
@@ -214,8 +219,8 @@ prepare(message<isRequest, Body, Fields>& msg,
                         msg.status != 204 &&
                         msg.status != 304)
                     {
-                        msg.fields.insert(
-                            "Content-Length", *pi.content_length);
+                        detail::insert_field(msg.fields,
+                            field::content_length, *pi.content_length);
                     }
                 }
             };
@@ -223,39 +228,44 @@ prepare(message<isRequest, Body, Fields>& msg,
         }
         else if(msg.version >= 11)
         {
-            msg.fields.insert("Transfer-Encoding", "chunked");
+            detail::insert_field(msg.fields,
+                field::transfer_encoding, "chunked");
         }
     }
 
     auto const content_length =
-        msg.fields.exists("Content-Length");
+        detail::exists_field(msg.fields, field::content_length);
 
     if(pi.connection_value)
     {
         switch(*pi.connection_value)
         {
         case connection::upgrade:
-            msg.fields.insert("Connection", "upgrade");
+            detail::insert_field(msg.fields,
+                field::connection, "upgrade");
             break;
 
         case connection::keep_alive:
             if(msg.version < 11)
             {
                 if(content_length)
-                    msg.fields.insert("Connection", "keep-alive");
+                    detail::insert_field(msg.fields,
+                        field::connection, "keep-alive");
             }
             break;
 
         case connection::close:
             if(msg.version >= 11)
-                msg.fields.insert("Connection", "close");
+                detail::insert_field(msg.fields,
+                    field::connection, "close");
             break;
         }
     }
 
     // rfc7230 6.7.
     if(msg.version < 11 && token_list{
-            msg.fields["Connection"]}.exists("upgrade"))
+            detail::get_field(msg.fields,
+                field::connection)}.exists("upgrade"))
         throw make_exception<std::invalid_argument>(
             "invalid version for Connection: upgrade", __FILE__, __LINE__);
 }
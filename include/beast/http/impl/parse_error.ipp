@@ -52,6 +52,8 @@ public:
         case parse_error::invalid_ext_val: return "invalid ext val";
         case parse_error::header_too_big: return "header size limit exceeded";
         case parse_error::body_too_big: return "body size limit exceeded";
+        case parse_error::unknown_content_coding: return "unsupported Content-Encoding";
+        case parse_error::bad_content_coding: return "bad content-coding data";
         default:
         case parse_error::short_read: return "unexpected end of data";
         }
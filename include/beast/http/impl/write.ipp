@@ -11,6 +11,9 @@
 #include <beast/http/concepts.hpp>
 #include <beast/http/resume_context.hpp>
 #include <beast/http/chunk_encode.hpp>
+#include <beast/http/detail/field_access.hpp>
+#include <beast/http/detail/header_buffer.hpp>
+#include <beast/http/detail/sendfile.hpp>
 #include <beast/core/buffer_cat.hpp>
 #include <beast/core/bind_handler.hpp>
 #include <beast/core/buffer_concepts.hpp>
@@ -33,82 +36,18 @@ namespace http {
 
 namespace detail {
 
-template<class DynamicBuffer, class Fields>
-void
-write_start_line(DynamicBuffer& dynabuf,
-    header<true, Fields> const& msg)
-{
-    BOOST_ASSERT(msg.version == 10 || msg.version == 11);
-    write(dynabuf, msg.method);
-    write(dynabuf, " ");
-    write(dynabuf, msg.url);
-    switch(msg.version)
-    {
-    case 10:
-        write(dynabuf, " HTTP/1.0\r\n");
-        break;
-    case 11:
-        write(dynabuf, " HTTP/1.1\r\n");
-        break;
-    }
-}
-
-template<class DynamicBuffer, class Fields>
-void
-write_start_line(DynamicBuffer& dynabuf,
-    header<false, Fields> const& msg)
-{
-    BOOST_ASSERT(msg.version == 10 || msg.version == 11);
-    switch(msg.version)
-    {
-    case 10:
-        write(dynabuf, "HTTP/1.0 ");
-        break;
-    case 11:
-        write(dynabuf, "HTTP/1.1 ");
-        break;
-    }
-    write(dynabuf, msg.status);
-    write(dynabuf, " ");
-    write(dynabuf, msg.reason);
-    write(dynabuf, "\r\n");
-}
-
-template<class DynamicBuffer, class FieldSequence>
-void
-write_fields(DynamicBuffer& dynabuf, FieldSequence const& fields)
-{
-    static_assert(is_DynamicBuffer<DynamicBuffer>::value,
-        "DynamicBuffer requirements not met");
-    //static_assert(is_FieldSequence<FieldSequence>::value,
-    //    "FieldSequence requirements not met");
-    for(auto const& field : fields)
-    {
-        write(dynabuf, field.name());
-        write(dynabuf, ": ");
-        write(dynabuf, field.value());
-        write(dynabuf, "\r\n");
-    }
-}
-
-} // detail
-
-//------------------------------------------------------------------------------
-
-namespace detail {
-
 template<class Stream, class Handler>
-class write_streambuf_op
+class write_header_op
 {
     struct data
     {
         bool cont;
         Stream& s;
-        streambuf sb;
+        header_buffer sb;
         int state = 0;
 
         data(Handler& handler, Stream& s_,
-                streambuf&& sb_)
+                header_buffer&& sb_)
             : cont(beast_asio_helpers::
                 is_continuation(handler))
             , s(s_)
@@ -120,11 +59,11 @@ class write_streambuf_op
     handler_ptr<data, Handler> d_;
 
 public:
-    write_streambuf_op(write_streambuf_op&&) = default;
-    write_streambuf_op(write_streambuf_op const&) = default;
+    write_header_op(write_header_op&&) = default;
+    write_header_op(write_header_op const&) = default;
 
     template<class DeducedHandler, class... Args>
-    write_streambuf_op(DeducedHandler&& h, Stream& s,
+    write_header_op(DeducedHandler&& h, Stream& s,
             Args&&... args)
         : d_(std::forward<DeducedHandler>(h),
             s, std::forward<Args>(args)...)
@@ -138,7 +77,7 @@ public:
 
     friend
     void* asio_handler_allocate(
-        std::size_t size, write_streambuf_op* op)
+        std::size_t size, write_header_op* op)
     {
         return beast_asio_helpers::
             allocate(size, op->d_.handler());
@@ -146,21 +85,21 @@ public:
 
     friend
     void asio_handler_deallocate(
-        void* p, std::size_t size, write_streambuf_op* op)
+        void* p, std::size_t size, write_header_op* op)
     {
         return beast_asio_helpers::
             deallocate(p, size, op->d_.handler());
     }
 
     friend
-    bool asio_handler_is_continuation(write_streambuf_op* op)
+    bool asio_handler_is_continuation(write_header_op* op)
     {
         return op->d_->cont;
     }
 
     template<class Function>
     friend
-    void asio_handler_invoke(Function&& f, write_streambuf_op* op)
+    void asio_handler_invoke(Function&& f, write_header_op* op)
     {
         return beast_asio_helpers::
             invoke(f, op->d_.handler());
@@ -169,7 +108,7 @@ public:
 
 template<class Stream, class Handler>
 void
-write_streambuf_op<Stream, Handler>::
+write_header_op<Stream, Handler>::
 operator()(error_code ec, std::size_t, bool again)
 {
     auto& d = *d_;
@@ -215,10 +154,7 @@ write(SyncWriteStream& stream,
 {
     static_assert(is_SyncWriteStream<SyncWriteStream>::value,
         "SyncWriteStream requirements not met");
-    streambuf sb;
-    detail::write_start_line(sb, msg);
-    detail::write_fields(sb, msg.fields);
-    beast::write(sb, "\r\n");
+    detail::header_buffer sb{msg};
     boost::asio::write(stream, sb.data(), ec);
 }
 
@@ -235,11 +171,8 @@ async_write(AsyncWriteStream& stream,
         "AsyncWriteStream requirements not met");
     beast::async_completion<WriteHandler,
         void(error_code)> completion{handler};
-    streambuf sb;
-    detail::write_start_line(sb, msg);
-    detail::write_fields(sb, msg.fields);
-    beast::write(sb, "\r\n");
-    detail::write_streambuf_op<AsyncWriteStream,
+    detail::header_buffer sb{msg};
+    detail::write_header_op<AsyncWriteStream,
         decltype(completion.handler)>{
             completion.handler, stream, std::move(sb)};
     return completion.result.get();
@@ -254,7 +187,7 @@ struct write_preparation
 {
     message<isRequest, Body, Fields> const& msg;
     typename Body::writer w;
-    streambuf sb;
+    header_buffer sb;
     bool chunked;
     bool close;
 
@@ -263,12 +196,12 @@ struct write_preparation
             message<isRequest, Body, Fields> const& msg_)
         : msg(msg_)
         , w(msg)
-        , chunked(token_list{
-            msg.fields["Transfer-Encoding"]}.exists("chunked"))
-        , close(token_list{
-            msg.fields["Connection"]}.exists("close") ||
-                (msg.version < 11 && ! msg.fields.exists(
-                    "Content-Length")))
+        , chunked(token_list{get_field(msg.fields,
+            field::transfer_encoding)}.exists("chunked"))
+        , close(token_list{get_field(msg.fields,
+            field::connection)}.exists("close") ||
+                (msg.version < 11 && ! exists_field(
+                    msg.fields, field::content_length)))
     {
     }
 
@@ -279,9 +212,7 @@ struct write_preparation
         if(ec)
             return;
 
-        write_start_line(sb, msg);
-        write_fields(sb, msg.fields);
-        beast::write(sb, "\r\n");
+        sb = header_buffer{msg};
     }
 };
 
@@ -366,6 +297,25 @@ class write_op
 
     handler_ptr<data, Handler> d_;
 
+    bool
+    send_file(error_code&, std::false_type)
+    {
+        return false;
+    }
+
+    bool
+    send_file(error_code& ec, std::true_type)
+    {
+        auto& d = *d_;
+        if(! d.s.native_non_blocking())
+        {
+            d.s.native_non_blocking(true, ec);
+            if(ec)
+                return true;
+        }
+        return sendfile_some(d.s.native_handle(), d.wp.w, ec);
+    }
+
 public:
     write_op(write_op&&) = default;
     write_op(write_op const&) = default;
@@ -454,7 +404,12 @@ operator()(error_code ec, std::size_t, bool again)
                     std::move(*this), ec, 0, false));
                 return;
             }
-            d.state = 1;
+            if(can_sendfile<Stream,
+                    typename Body::writer>::value &&
+                        ! d.wp.chunked)
+                d.state = 10;
+            else
+                d.state = 1;
             break;
         }
 
@@ -531,6 +486,38 @@ operator()(error_code ec, std::size_t, bool again)
             }
             d.state = 99;
             break;
+
+        // write header, then send the file
+        case 10:
+            d.state = 11;
+            boost::asio::async_write(d.s,
+                d.wp.sb.data(), std::move(*this));
+            return;
+
+        case 11:
+            d.wp.sb.consume(d.wp.sb.size());
+            d.state = 12;
+            break;
+
+        case 12:
+            if(! send_file(ec, can_sendfile<
+                Stream, typename Body::writer>{}))
+            {
+                // not supported, use the writer
+                d.state = 1;
+                break;
+            }
+            if(ec == boost::asio::error::would_block)
+            {
+                // wait until the socket is writable
+                ec = {};
+                d.s.async_write_some(
+                    boost::asio::null_buffers{},
+                        std::move(*this));
+                return;
+            }
+            d.state = 5;
+            break;
         }
     }
     d.copy = {};
@@ -538,17 +525,17 @@ operator()(error_code ec, std::size_t, bool again)
     d_.invoke(ec);
 }
 
-template<class SyncWriteStream, class DynamicBuffer>
+template<class SyncWriteStream, class HeaderBuffer>
 class writef0_lambda
 {
-    DynamicBuffer const& sb_;
+    HeaderBuffer const& sb_;
     SyncWriteStream& stream_;
     bool chunked_;
     error_code& ec_;
 
 public:
     writef0_lambda(SyncWriteStream& stream,
-            DynamicBuffer const& sb, bool chunked, error_code& ec)
+            HeaderBuffer const& sb, bool chunked, error_code& ec)
         : sb_(sb)
         , stream_(stream)
         , chunked_(chunked)
@@ -597,6 +584,42 @@ public:
     }
 };
 
+template<class SyncWriteStream,
+    bool isRequest, class Body, class Fields>
+bool
+write_file(SyncWriteStream&, write_preparation<
+    isRequest, Body, Fields>&, error_code&, std::false_type)
+{
+    return false;
+}
+
+// Returns `false` if the body should be sent by the writer
+template<class SyncWriteStream,
+    bool isRequest, class Body, class Fields>
+bool
+write_file(SyncWriteStream& stream, write_preparation<
+    isRequest, Body, Fields>& wp, error_code& ec, std::true_type)
+{
+    if(wp.chunked)
+        return false;
+    boost::asio::write(stream, wp.sb.data(), ec);
+    if(ec)
+        return true;
+    wp.sb.consume(wp.sb.size());
+    auto const sock = stream.native_handle();
+    for(;;)
+    {
+        if(! sendfile_some(sock, wp.w, ec))
+            return false;
+        if(ec != boost::asio::error::would_block)
+            return true;
+        ec = {};
+        wait_writable(sock, ec);
+        if(ec)
+            return true;
+    }
+}
+
 } // detail
 
 template<class SyncWriteStream,
@@ -640,6 +663,16 @@ write(SyncWriteStream& stream,
     wp.init(ec);
     if(ec)
         return;
+    if(detail::write_file(stream, wp, ec, detail::can_sendfile<
+        SyncWriteStream, typename Body::writer>{}))
+    {
+        if(! ec && wp.close)
+        {
+            // VFALCO TODO Decide on an error code
+            ec = boost::asio::error::eof;
+        }
+        return;
+    }
     std::mutex m;
     std::condition_variable cv;
     bool ready = false;
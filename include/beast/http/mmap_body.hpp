@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_HTTP_MMAP_BODY_HPP
+#define BEAST_HTTP_MMAP_BODY_HPP
+
+#include <beast/core/error.hpp>
+#include <beast/http/file_mapping.hpp>
+#include <beast/http/message.hpp>
+#include <beast/http/resume_context.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/logic/tribool.hpp>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace beast {
+namespace http {
+
+/** A Body which sends a shared mapping of a file.
+
+    The body holds a reference to a @ref file_mapping, together
+    with the range of bytes to send. The writer presents the range
+    directly to the stream, so the header and the body are gathered
+    in a single write with no copy.
+
+    This is suited to small, frequently requested files. Use a
+    @ref file_mapping_cache so concurrent responses for the same
+    file share one mapping. Served files must be replaced by
+    renaming a new file over them, never truncated or rewritten in
+    place; see @ref file_mapping.
+
+    Meets the requirements of @b `Body`.
+
+    @par Example
+    @code
+        error_code ec;
+        response<mmap_body> res;
+        res.body = file_mapping_cache::global().get("index.html", ec);
+        if(! ec)
+        {
+            prepare(res);
+            write(sock, res);
+        }
+    @endcode
+*/
+struct mmap_body
+{
+    /// The type of the `message::body` member
+    class value_type
+    {
+        std::shared_ptr<file_mapping const> map_;
+        std::size_t offset_ = 0;
+        std::size_t size_ = 0;
+
+    public:
+        /// Default constructor, the body is empty.
+        value_type() = default;
+
+        /** Construct the body from a mapping.
+
+            The entire mapping is selected.
+        */
+        value_type(std::shared_ptr<file_mapping const> map)
+            : map_(std::move(map))
+            , size_(map_ ? map_->size() : 0)
+        {
+        }
+
+        /** Select a range of bytes within the mapping.
+
+            This is used to send a partial response.
+
+            @param offset The offset of the first byte to send.
+
+            @param size The number of bytes to send.
+
+            @throws std::out_of_range if the range is not within
+            the mapping.
+        */
+        void
+        range(std::size_t offset, std::size_t size)
+        {
+            auto const n = map_ ? map_->size() : 0;
+            if(offset > n || size > n - offset)
+                throw std::out_of_range{"mmap_body range"};
+            offset_ = offset;
+            size_ = size;
+        }
+
+        /// Returns the mapping.
+        std::shared_ptr<file_mapping const> const&
+        mapping() const
+        {
+            return map_;
+        }
+
+        /// Returns the offset of the first byte to send.
+        std::size_t
+        offset() const
+        {
+            return offset_;
+        }
+
+        /// Returns the number of bytes to send.
+        std::size_t
+        size() const
+        {
+            return size_;
+        }
+
+        /// Returns the bytes to send.
+        boost::asio::const_buffer
+        data() const
+        {
+            if(! map_)
+                return {};
+            return {static_cast<char const*>(
+                map_->data()) + offset_, size_};
+        }
+    };
+
+#if GENERATING_DOCS
+private:
+#endif
+
+    class writer
+    {
+        value_type const& body_;
+        std::size_t pos_ = 0;
+
+    public:
+        /** The largest slice presented in one call.
+
+            Bodies up to this size are written together with the
+            header in a single call to the stream.
+        */
+        static std::size_t constexpr window_size =
+            64 * 1024 * 1024;
+
+        template<bool isRequest, class Fields>
+        explicit
+        writer(message<isRequest, mmap_body, Fields> const& m) noexcept
+            : body_(m.body)
+        {
+        }
+
+        void
+        init(error_code&) noexcept
+        {
+        }
+
+        std::uint64_t
+        content_length() const noexcept
+        {
+            return body_.size();
+        }
+
+        template<class WriteFunction>
+        boost::tribool
+        write(resume_context&&, error_code&,
+            WriteFunction&& wf) noexcept
+        {
+            auto n = body_.size() - pos_;
+            if(n > window_size)
+                n = window_size;
+            wf(boost::asio::const_buffers_1{
+                boost::asio::buffer(body_.data() + pos_, n)});
+            pos_ += n;
+            return pos_ == body_.size();
+        }
+    };
+};
+
+} // http
+} // beast
+
+#endif
@@ -36,7 +36,10 @@ enum class parse_error
 
     header_too_big,
     body_too_big,
-    short_read
+    short_read,
+
+    unknown_content_coding,
+    bad_content_coding
 };
 
 } // http
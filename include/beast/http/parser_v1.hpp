@@ -54,6 +54,28 @@ struct skip_body
     }
 };
 
+namespace detail {
+
+template<class T, class = beast::detail::void_t<>>
+struct has_body_max_size : std::false_type {};
+
+template<class T>
+struct has_body_max_size<T, beast::detail::void_t<decltype(
+    std::declval<T&>().set_option(
+        std::declval<body_max_size const&>())
+            )> > : std::true_type {};
+
+template<class T, class = beast::detail::void_t<>>
+struct has_finish : std::false_type {};
+
+template<class T>
+struct has_finish<T, beast::detail::void_t<decltype(
+    std::declval<T&>().finish(
+        std::declval<error_code&>())
+            )> > : std::true_type {};
+
+} // detail
+
 /** A parser for producing HTTP/1 messages.
 
     This class uses the basic HTTP/1 wire format parser to convert
@@ -152,6 +174,9 @@ public:
                 isRequest, Body, Fields>>&>(*this) = parser;
     }
 
+    using basic_parser_v1<isRequest,
+        parser_v1<isRequest, Body, Fields>>::set_option;
+
     /// Set the skip body option.
     void
     set_option(skip_body const& o)
@@ -277,6 +302,7 @@ private:
         if(skip_body_)
             return body_what::skip;
         r_.emplace(m_);
+        set_limit(detail::has_body_max_size<reader>{});
         r_->init(ec);
         return body_what::normal;
     }
@@ -286,7 +312,33 @@ private:
         r_->write(s.data(), s.size(), ec);
     }
 
-    void on_complete(error_code&)
+    void on_complete(error_code& ec)
+    {
+        if(r_)
+            finish(ec, detail::has_finish<reader>{});
+    }
+
+    // Readers which transform the body enforce
+    // the limit on the octets they produce.
+    void
+    set_limit(std::true_type)
+    {
+        r_->set_option(body_max_size{this->body_limit()});
+    }
+
+    void
+    set_limit(std::false_type)
+    {
+    }
+
+    void
+    finish(error_code& ec, std::true_type)
+    {
+        r_->finish(ec);
+    }
+
+    void
+    finish(error_code&, std::false_type)
     {
     }
 };
@@ -8,7 +8,11 @@
 #ifndef BEAST_HTTP_RESUME_CONTEXT_HPP
 #define BEAST_HTTP_RESUME_CONTEXT_HPP
 
-#include <functional>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace beast {
 namespace http {
@@ -25,8 +29,264 @@ namespace http {
     to indicate that the write operation should suspend. Later, the calling
     code invokes the resume function and the write operation continues
     from where it left off.
+
+    The context stores its function object inline when it fits in
+    a small buffer, which is always the case for the contexts created
+    by the write implementation. Constructing, copying, moving and
+    invoking such a context never allocates memory.
 */
-using resume_context = std::function<void(void)>;
+class resume_context
+{
+    struct ops
+    {
+        void (*invoke)(void*);
+        void (*copy)(void const*, void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+    };
+
+    static std::size_t constexpr buffer_size = 4 * sizeof(void*);
+
+    using storage_type =
+        std::aligned_storage<buffer_size>::type;
+
+    template<class F>
+    using is_local = std::integral_constant<bool,
+        sizeof(F) <= buffer_size &&
+        alignof(F) <= alignof(storage_type)>;
+
+    // F stored in the buffer
+    template<class F>
+    struct local
+    {
+        static ops const table;
+
+        static
+        void
+        invoke(void* p)
+        {
+            (*static_cast<F*>(p))();
+        }
+
+        static
+        void
+        copy(void const* from, void* to)
+        {
+            ::new(to) F(*static_cast<F const*>(from));
+        }
+
+        static
+        void
+        move(void* from, void* to)
+        {
+            ::new(to) F(std::move(*static_cast<F*>(from)));
+            static_cast<F*>(from)->~F();
+        }
+
+        static
+        void
+        destroy(void* p)
+        {
+            static_cast<F*>(p)->~F();
+        }
+    };
+
+    // F too large, the buffer holds a pointer to it
+    template<class F>
+    struct remote
+    {
+        static ops const table;
+
+        static
+        F*&
+        get(void* p)
+        {
+            return *static_cast<F**>(p);
+        }
+
+        static
+        void
+        invoke(void* p)
+        {
+            (*get(p))();
+        }
+
+        static
+        void
+        copy(void const* from, void* to)
+        {
+            ::new(to) F*(new F(**static_cast<F* const*>(from)));
+        }
+
+        static
+        void
+        move(void* from, void* to)
+        {
+            ::new(to) F*(get(from));
+        }
+
+        static
+        void
+        destroy(void* p)
+        {
+            delete get(p);
+        }
+    };
+
+    mutable storage_type buf_;
+    ops const* ops_ = nullptr;
+
+    template<class F>
+    void
+    construct(F&& f, std::true_type)
+    {
+        using T = typename std::decay<F>::type;
+        ::new(&buf_) T(std::forward<F>(f));
+        ops_ = &local<T>::table;
+    }
+
+    template<class F>
+    void
+    construct(F&& f, std::false_type)
+    {
+        using T = typename std::decay<F>::type;
+        ::new(&buf_) T*(new T(std::forward<F>(f)));
+        ops_ = &remote<T>::table;
+    }
+
+    void
+    reset()
+    {
+        if(ops_)
+        {
+            ops_->destroy(&buf_);
+            ops_ = nullptr;
+        }
+    }
+
+public:
+    /// Default constructor, the context is empty.
+    resume_context() = default;
+
+    /// Construct an empty context.
+    resume_context(std::nullptr_t)
+    {
+    }
+
+    /// Destructor.
+    ~resume_context()
+    {
+        reset();
+    }
+
+    /// Copy constructor.
+    resume_context(resume_context const& other)
+    {
+        if(other.ops_)
+        {
+            other.ops_->copy(&other.buf_, &buf_);
+            ops_ = other.ops_;
+        }
+    }
+
+    /** Move constructor.
+
+        After the move, `other` is empty.
+    */
+    resume_context(resume_context&& other)
+    {
+        if(other.ops_)
+        {
+            other.ops_->move(&other.buf_, &buf_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    /** Construct a context from a function object.
+
+        @param f The function object, which must be invocable
+        with no arguments, and copy constructible.
+    */
+    template<class F, class = typename std::enable_if<
+        ! std::is_same<typename std::decay<F>::type,
+            resume_context>::value &&
+        ! std::is_same<typename std::decay<F>::type,
+            std::nullptr_t>::value>::type>
+    resume_context(F&& f)
+    {
+        construct(std::forward<F>(f),
+            is_local<typename std::decay<F>::type>{});
+    }
+
+    /// Copy assignment.
+    resume_context&
+    operator=(resume_context const& other)
+    {
+        if(this != &other)
+        {
+            resume_context tmp{other};
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    /** Move assignment.
+
+        After the move, `other` is empty.
+    */
+    resume_context&
+    operator=(resume_context&& other)
+    {
+        if(this != &other)
+        {
+            reset();
+            if(other.ops_)
+            {
+                other.ops_->move(&other.buf_, &buf_);
+                ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    /// Returns `true` if the context holds a function object.
+    explicit
+    operator bool() const
+    {
+        return ops_ != nullptr;
+    }
+
+    /** Resume the write operation.
+
+        @note The context must not be empty.
+    */
+    void
+    operator()() const
+    {
+        BOOST_ASSERT(ops_);
+        ops_->invoke(&buf_);
+    }
+};
+
+template<class F>
+resume_context::ops const
+resume_context::local<F>::table = {
+    &resume_context::local<F>::invoke,
+    &resume_context::local<F>::copy,
+    &resume_context::local<F>::move,
+    &resume_context::local<F>::destroy
+};
+
+template<class F>
+resume_context::ops const
+resume_context::remote<F>::table = {
+    &resume_context::remote<F>::invoke,
+    &resume_context::remote<F>::copy,
+    &resume_context::remote<F>::move,
+    &resume_context::remote<F>::destroy
+};
 
 } // http
 } // beast
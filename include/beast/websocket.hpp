@@ -10,6 +10,7 @@
 
 #include <beast/websocket/error.hpp>
 #include <beast/websocket/option.hpp>
+#include <beast/websocket/prepared_message.hpp>
 #include <beast/websocket/rfc6455.hpp>
 #include <beast/websocket/stream.hpp>
 #include <beast/websocket/teardown.hpp>
@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_WEBSOCKET_DETAIL_BUFFER_POOL_HPP
+#define BEAST_WEBSOCKET_DETAIL_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace beast {
+namespace websocket {
+namespace detail {
+
+/*  Idle read and write buffers.
+
+    A stream needs a read buffer to inflate compressed messages,
+    and a write buffer to compress or mask the messages it sends.
+    Instead of keeping them while the connection is idle, streams
+    check them out of this pool at the start of each message and
+    give them back at the end.
+
+    Buffers are only handed out for requests of the same size.
+
+    The pool is shared by the whole process.
+*/
+class buffer_pool
+{
+    struct entry
+    {
+        std::size_t size;
+        std::unique_ptr<std::uint8_t[]> p;
+    };
+
+    std::mutex m_;
+    std::vector<entry> v_;
+    std::size_t limit_ = 64;
+
+    void
+    put(std::uint8_t* p, std::size_t size)
+    {
+        std::unique_ptr<std::uint8_t[]> sp{p};
+        std::lock_guard<std::mutex> lock(m_);
+        if(v_.size() < limit_)
+            v_.push_back({size, std::move(sp)});
+    }
+
+public:
+    // Returns the buffer to the pool on destruction
+    class deleter
+    {
+        std::size_t size_ = 0;
+
+    public:
+        deleter() = default;
+
+        explicit
+        deleter(std::size_t size)
+            : size_(size)
+        {
+        }
+
+        void
+        operator()(std::uint8_t* p) const
+        {
+            instance().put(p, size_);
+        }
+    };
+
+    using buffer_ptr =
+        std::unique_ptr<std::uint8_t[], deleter>;
+
+    buffer_pool() = default;
+    buffer_pool(buffer_pool const&) = delete;
+    buffer_pool& operator=(buffer_pool const&) = delete;
+
+    // Never destroyed, streams destroyed during
+    // exit may still give their buffers back.
+    static
+    buffer_pool&
+    instance()
+    {
+        static buffer_pool* const pool = new buffer_pool;
+        return *pool;
+    }
+
+    buffer_ptr
+    get(std::size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            for(auto it = v_.rbegin(); it != v_.rend(); ++it)
+            {
+                if(it->size != size)
+                    continue;
+                buffer_ptr p{it->p.release(), deleter{size}};
+                std::swap(*it, v_.back());
+                v_.pop_back();
+                return p;
+            }
+        }
+        return buffer_ptr{
+            new std::uint8_t[size], deleter{size}};
+    }
+
+    // Set the largest number of idle buffers
+    void
+    limit(std::size_t n)
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        limit_ = n;
+        if(v_.size() > n)
+            v_.resize(n);
+    }
+
+    // Returns the number of idle buffers
+    std::size_t
+    idle()
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        return v_.size();
+    }
+};
+
+} // detail
+} // websocket
+} // beast
+
+#endif
@@ -8,10 +8,13 @@
 #ifndef BEAST_WEBSOCKET_DETAIL_MASK_HPP
 #define BEAST_WEBSOCKET_DETAIL_MASK_HPP
 
+#include <beast/core/detail/cpu_info.hpp>
 #include <boost/asio/buffer.hpp>
+#include <algorithm>
 #include <array>
 #include <climits>
 #include <cstdint>
+#include <cstring>
 #include <random>
 #include <type_traits>
 
@@ -229,13 +232,170 @@ mask_inplace_fast(
     }
 }
 
+/*  Bulk masking kernels.
+
+    Each kernel masks the largest prefix of [src, src+n) whose size
+    is a multiple of its block size into dst, and returns the number
+    of bytes masked. dst and src may be equal, which masks in place.
+    Since the count is always a multiple of four the key does not
+    rotate, and the caller finishes the leftovers with the scalar
+    code which also takes care of the key rotation. Loads and stores
+    are unaligned, so the kernels work on any buffer boundary.
+
+    `key` is the current mask key as it appears in memory, that is
+    the low 32 bits of the rotated prepared key.
+*/
+using mask_bulk_fn = std::size_t(*)(std::uint8_t*,
+    std::uint8_t const*, std::size_t, std::uint32_t);
+
+inline
+std::size_t
+mask_bulk_scalar(std::uint8_t* dst,
+    std::uint8_t const* src, std::size_t n, std::uint32_t key)
+{
+    auto const k =
+        (static_cast<std::uint64_t>(key) << 32) | key;
+    auto const n0 = n;
+    while(n >= 8)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, src, 8);
+        v ^= k;
+        std::memcpy(dst, &v, 8);
+        dst += 8;
+        src += 8;
+        n -= 8;
+    }
+    return n0 - n;
+}
+
+#if BEAST_DETAIL_X86
+
+inline
+std::size_t
+mask_bulk_sse2(std::uint8_t* dst,
+    std::uint8_t const* src, std::size_t n, std::uint32_t key)
+{
+    auto const k = _mm_set1_epi32(static_cast<int>(key));
+    auto const n0 = n;
+    while(n >= 64)
+    {
+        auto const s = reinterpret_cast<__m128i const*>(src);
+        auto const d = reinterpret_cast<__m128i*>(dst);
+        auto const v0 = _mm_loadu_si128(s);
+        auto const v1 = _mm_loadu_si128(s + 1);
+        auto const v2 = _mm_loadu_si128(s + 2);
+        auto const v3 = _mm_loadu_si128(s + 3);
+        _mm_storeu_si128(d,     _mm_xor_si128(v0, k));
+        _mm_storeu_si128(d + 1, _mm_xor_si128(v1, k));
+        _mm_storeu_si128(d + 2, _mm_xor_si128(v2, k));
+        _mm_storeu_si128(d + 3, _mm_xor_si128(v3, k));
+        dst += 64;
+        src += 64;
+        n -= 64;
+    }
+    while(n >= 16)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+            _mm_xor_si128(_mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(src)), k));
+        dst += 16;
+        src += 16;
+        n -= 16;
+    }
+    return n0 - n;
+}
+
+BEAST_DETAIL_TARGET("avx2")
+inline
+std::size_t
+mask_bulk_avx2(std::uint8_t* dst,
+    std::uint8_t const* src, std::size_t n, std::uint32_t key)
+{
+    auto const k = _mm256_set1_epi32(static_cast<int>(key));
+    auto const n0 = n;
+    while(n >= 64)
+    {
+        auto const s = reinterpret_cast<__m256i const*>(src);
+        auto const d = reinterpret_cast<__m256i*>(dst);
+        auto const v0 = _mm256_loadu_si256(s);
+        auto const v1 = _mm256_loadu_si256(s + 1);
+        _mm256_storeu_si256(d,     _mm256_xor_si256(v0, k));
+        _mm256_storeu_si256(d + 1, _mm256_xor_si256(v1, k));
+        dst += 64;
+        src += 64;
+        n -= 64;
+    }
+    if(n >= 32)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+            _mm256_xor_si256(_mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(src)), k));
+        dst += 32;
+        src += 32;
+        n -= 32;
+    }
+    // Avoid the AVX-SSE transition penalty on return
+    _mm256_zeroupper();
+    return (n0 - n) + mask_bulk_sse2(dst, src, n, key);
+}
+
+#endif
+
+inline
+mask_bulk_fn
+select_mask_bulk()
+{
+#if BEAST_DETAIL_X86
+    auto const& ci = beast::detail::get_cpu_info();
+    if(ci.avx2)
+        return &mask_bulk_avx2;
+    if(ci.sse2)
+        return &mask_bulk_sse2;
+#endif
+    return &mask_bulk_scalar;
+}
+
+inline
+std::size_t
+mask_bulk(std::uint8_t* dst,
+    std::uint8_t const* src, std::size_t n, std::uint32_t key)
+{
+    static mask_bulk_fn const f = select_mask_bulk();
+    return f(dst, src, n, key);
+}
+
+// Buffers shorter than this are masked with the scalar code
+std::size_t constexpr mask_bulk_min = 64;
+
+template<class KeyType>
+void
+mask_inplace_bulk(
+    boost::asio::mutable_buffer const& b,
+        KeyType& key)
+{
+    using boost::asio::buffer_cast;
+    using boost::asio::buffer_size;
+    auto n = buffer_size(b);
+    auto p = buffer_cast<std::uint8_t*>(b);
+    if(n >= mask_bulk_min)
+    {
+        auto const used = mask_bulk(p, p, n,
+            static_cast<std::uint32_t>(key));
+        p += used;
+        n -= used;
+    }
+    mask_inplace_fast(
+        boost::asio::mutable_buffer{p, n}, key);
+}
+
 inline
 void
 mask_inplace(
     boost::asio::mutable_buffer const& b,
         std::uint32_t& key)
 {
-    mask_inplace_fast(b, key);
+    mask_inplace_bulk(b, key);
 }
 
 inline
@@ -244,7 +404,7 @@ mask_inplace(
     boost::asio::mutable_buffer const& b,
         std::uint64_t& key)
 {
-    mask_inplace_fast(b, key);
+    mask_inplace_bulk(b, key);
 }
 
 // Apply mask in place
@@ -258,6 +418,95 @@ mask_inplace(
         mask_inplace(b, key);
 }
 
+// Copy and apply mask in a single pass, n bytes
+//
+template<class KeyType>
+void
+mask_copy(std::uint8_t* dst,
+    std::uint8_t const* src, std::size_t n, KeyType& key)
+{
+    if(n >= mask_bulk_min)
+    {
+        auto const used = mask_bulk(dst, src, n,
+            static_cast<std::uint32_t>(key));
+        dst += used;
+        src += used;
+        n -= used;
+    }
+    for(std::size_t i = 0; i < n; ++i)
+        dst[i] = src[i] ^ static_cast<std::uint8_t>(
+            key >> (8 * (i % sizeof(key))));
+    key = ror(key, static_cast<unsigned>(8 * n));
+}
+
+/*  Copy and apply mask in a single pass.
+
+    This behaves like `buffer_copy`: the number of bytes copied is
+    the smaller of the sizes of the source and the destination.
+    Each byte is read once and written once.
+
+    @return The number of bytes copied.
+*/
+template<class ConstBufferSequence, class KeyType>
+std::size_t
+mask_copy(boost::asio::mutable_buffer const& dest,
+    ConstBufferSequence const& bs, KeyType& key)
+{
+    using boost::asio::buffer_cast;
+    using boost::asio::buffer_size;
+    auto out = buffer_cast<std::uint8_t*>(dest);
+    auto remain = buffer_size(dest);
+    std::size_t total = 0;
+    for(auto const& b : bs)
+    {
+        if(remain == 0)
+            break;
+        auto const n = (std::min)(buffer_size(b), remain);
+        mask_copy(out, buffer_cast<
+            std::uint8_t const*>(b), n, key);
+        out += n;
+        remain -= n;
+        total += n;
+    }
+    return total;
+}
+
+// Buffers are unmasked in pieces of this size, so that a
+// piece is still in cache when the caller looks at it.
+std::size_t constexpr mask_piece_size = 4096;
+
+/*  Apply mask in place, calling f on each unmasked piece.
+
+    f is invoked as `bool(std::uint8_t const*, std::size_t)`
+    right after each piece is unmasked, so a second pass over
+    the payload (such as UTF-8 validation) reads the bytes from
+    cache instead of memory. Returns `false` as soon as f does,
+    leaving the rest of the buffers unchanged.
+*/
+template<class MutableBuffers, class KeyType, class Function>
+bool
+mask_inplace_each(MutableBuffers const& bs,
+    KeyType& key, Function&& f)
+{
+    using boost::asio::buffer_cast;
+    using boost::asio::buffer_size;
+    for(auto const& b : bs)
+    {
+        auto p = buffer_cast<std::uint8_t*>(b);
+        auto n = buffer_size(b);
+        while(n > 0)
+        {
+            auto const k = (std::min)(n, mask_piece_size);
+            mask_inplace(boost::asio::mutable_buffer{p, k}, key);
+            if(! f(p, k))
+                return false;
+            p += k;
+            n -= k;
+        }
+    }
+    return true;
+}
+
 } // detail
 } // websocket
 } // beast
@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_WEBSOCKET_DETAIL_PMD_POOL_HPP
+#define BEAST_WEBSOCKET_DETAIL_PMD_POOL_HPP
+
+#include <beast/zlib/deflate_stream.hpp>
+#include <beast/zlib/inflate_stream.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace beast {
+namespace websocket {
+namespace detail {
+
+/*  Idle permessage-deflate compressors and decompressors.
+
+    A compressor holds about 300KB once it has been used, and a
+    decompressor holds its window. Instead of keeping them for the
+    life of every connection, streams check them out of this pool
+    and give them back: at the end of each message when context
+    takeover is off for that direction, otherwise when the
+    connection closes.
+
+    Objects checked out may have been used before, callers must
+    reset them with their own settings. Buffers are kept when the
+    settings need the same sizes.
+
+    The pool is shared by the whole process.
+*/
+class pmd_pool
+{
+    std::mutex m_;
+    std::vector<std::unique_ptr<zlib::deflate_stream>> zo_;
+    std::vector<std::unique_ptr<zlib::inflate_stream>> zi_;
+    std::size_t limit_ = 32;
+
+    template<class T>
+    void
+    put(std::vector<std::unique_ptr<T>>& v, T* p)
+    {
+        std::unique_ptr<T> sp{p};
+        std::lock_guard<std::mutex> lock(m_);
+        if(v.size() < limit_)
+            v.emplace_back(std::move(sp));
+    }
+
+    template<class T>
+    std::unique_ptr<T>
+    get(std::vector<std::unique_ptr<T>>& v)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            if(! v.empty())
+            {
+                auto p = std::move(v.back());
+                v.pop_back();
+                return p;
+            }
+        }
+        return std::unique_ptr<T>{new T};
+    }
+
+public:
+    // Returns the object to the pool on destruction
+    struct deflate_deleter
+    {
+        void
+        operator()(zlib::deflate_stream* p) const
+        {
+            instance().put(instance().zo_, p);
+        }
+    };
+
+    // Returns the object to the pool on destruction
+    struct inflate_deleter
+    {
+        void
+        operator()(zlib::inflate_stream* p) const
+        {
+            instance().put(instance().zi_, p);
+        }
+    };
+
+    using deflate_ptr = std::unique_ptr<
+        zlib::deflate_stream, deflate_deleter>;
+
+    using inflate_ptr = std::unique_ptr<
+        zlib::inflate_stream, inflate_deleter>;
+
+    pmd_pool() = default;
+    pmd_pool(pmd_pool const&) = delete;
+    pmd_pool& operator=(pmd_pool const&) = delete;
+
+    // Never destroyed, streams destroyed during
+    // exit may still give their objects back.
+    static
+    pmd_pool&
+    instance()
+    {
+        static pmd_pool* const pool = new pmd_pool;
+        return *pool;
+    }
+
+    deflate_ptr
+    get_deflate()
+    {
+        return deflate_ptr{get(zo_).release()};
+    }
+
+    inflate_ptr
+    get_inflate()
+    {
+        return inflate_ptr{get(zi_).release()};
+    }
+
+    // Set the largest number of idle objects of each kind
+    void
+    limit(std::size_t n)
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        limit_ = n;
+        if(zo_.size() > n)
+            zo_.resize(n);
+        if(zi_.size() > n)
+            zi_.resize(n);
+    }
+
+    // Returns the number of idle compressors
+    std::size_t
+    deflate_idle()
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        return zo_.size();
+    }
+
+    // Returns the number of idle decompressors
+    std::size_t
+    inflate_idle()
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        return zi_.size();
+    }
+};
+
+} // detail
+} // websocket
+} // beast
+
+#endif
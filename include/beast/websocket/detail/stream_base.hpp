@@ -11,17 +11,18 @@
 #include <beast/websocket/error.hpp>
 #include <beast/websocket/option.hpp>
 #include <beast/websocket/rfc6455.hpp>
+#include <beast/websocket/detail/buffer_pool.hpp>
 #include <beast/websocket/detail/decorator.hpp>
 #include <beast/websocket/detail/frame.hpp>
 #include <beast/websocket/detail/invokable.hpp>
 #include <beast/websocket/detail/mask.hpp>
 #include <beast/websocket/detail/pmd_extension.hpp>
+#include <beast/websocket/detail/pmd_pool.hpp>
 #include <beast/websocket/detail/utf8_checker.hpp>
+#include <beast/core/handler_memory.hpp>
 #include <beast/http/empty_body.hpp>
 #include <beast/http/message.hpp>
 #include <beast/http/string_body.hpp>
-#include <beast/zlib/deflate_stream.hpp>
-#include <beast/zlib/inflate_stream.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/assert.hpp>
 #include <cstdint>
@@ -50,6 +51,10 @@ protected:
 
     struct op {};
 
+    template<class Handler>
+    using memory_handler =
+        beast::detail::memory_handler<Handler>;
+
     detail::maskgen maskgen_;               // source of mask keys
     decorator_type d_;                      // adorns http messages
     bool keep_alive_ = false;               // close on failed upgrade
@@ -71,6 +76,7 @@ protected:
     invokable wr_op_;                       // write parking
     invokable ping_op_;                     // ping parking
     close_reason cr_;                       // set from received close frame
+    handler_memory mem_;                    // recycled op memory
 
     // State information for the message being received
     //
@@ -95,7 +101,9 @@ protected:
         std::size_t buf_size;
 
         // The read buffer. Used for compression and masking.
-        std::unique_ptr<std::uint8_t[]> buf;
+        // The buffer is checked out of the pool at the beginning
+        // of receiving a compressed message, and returned at the end.
+        buffer_pool::buffer_ptr buf;
     };
 
     rd_t rd_;
@@ -127,9 +135,9 @@ protected:
         std::size_t buf_size;
 
         // The write buffer. Used for compression and masking.
-        // The buffer is allocated or reallocated at the beginning of
-        // sending a message.
-        std::unique_ptr<std::uint8_t[]> buf;
+        // The buffer is checked out of the pool at the beginning of
+        // sending a message, and returned at the end.
+        buffer_pool::buffer_ptr buf;
     };
 
     wr_t wr_;
@@ -140,8 +148,23 @@ protected:
         // `true` if current read message is compressed
         bool rd_set;
 
-        zlib::deflate_stream zo;
-        zlib::inflate_stream zi;
+        // `true` if the compressor is reset after each message
+        bool wr_reset;
+
+        // `true` if the decompressor is reset after each message
+        bool rd_reset;
+
+        // Settings, fixed when the connection opens
+        int compLevel;
+        int memLevel;
+        int wr_bits;
+        int rd_bits;
+
+        // Checked out of the pool on first use. Returned at the
+        // end of the message if reset after each message,
+        // otherwise when the connection closes.
+        pmd_pool::deflate_ptr zo;
+        pmd_pool::inflate_ptr zi;
     };
 
     // If not engaged, then permessage-deflate is not
@@ -172,6 +195,26 @@ protected:
     void
     close();
 
+    // Returns the compressor, checking one out if needed
+    template<class = void>
+    zlib::deflate_stream&
+    pmd_zo();
+
+    // Returns the decompressor, checking one out if needed
+    template<class = void>
+    zlib::inflate_stream&
+    pmd_zi();
+
+    // Called after the last frame of a compressed message is sent
+    template<class = void>
+    void
+    pmd_wr_done();
+
+    // Called after the last frame of a compressed message is received
+    template<class = void>
+    void
+    pmd_rd_done();
+
     template<class DynamicBuffer>
     std::size_t
     read_fh1(detail::frame_header& fh,
@@ -193,6 +236,11 @@ protected:
     void
     wr_begin();
 
+    // Called after the last frame of each message is sent
+    template<class = void>
+    void
+    wr_done();
+
     template<class DynamicBuffer>
     void
     write_close(DynamicBuffer& db, close_reason const& rc);
@@ -224,25 +272,28 @@ open(role_type role)
     {
         pmd_normalize(pmd_config_);
         pmd_.reset(new pmd_t);
+        pmd_->compLevel = pmd_opts_.compLevel;
+        pmd_->memLevel = pmd_opts_.memLevel;
         if(role_ == role_type::client)
         {
-            pmd_->zi.reset(
-                pmd_config_.server_max_window_bits);
-            pmd_->zo.reset(
-                pmd_opts_.compLevel,
-                pmd_config_.client_max_window_bits,
-                pmd_opts_.memLevel,
-                zlib::Strategy::normal);
+            // We may always reset our own compressor
+            pmd_->wr_reset =
+                pmd_config_.client_no_context_takeover ||
+                pmd_opts_.client_no_context_takeover;
+            pmd_->rd_reset =
+                pmd_config_.server_no_context_takeover;
+            pmd_->wr_bits = pmd_config_.client_max_window_bits;
+            pmd_->rd_bits = pmd_config_.server_max_window_bits;
         }
         else
         {
-            pmd_->zi.reset(
-                pmd_config_.client_max_window_bits);
-            pmd_->zo.reset(
-                pmd_opts_.compLevel,
-                pmd_config_.server_max_window_bits,
-                pmd_opts_.memLevel,
-                zlib::Strategy::normal);
+            pmd_->wr_reset =
+                pmd_config_.server_no_context_takeover ||
+                pmd_opts_.server_no_context_takeover;
+            pmd_->rd_reset =
+                pmd_config_.client_no_context_takeover;
+            pmd_->wr_bits = pmd_config_.server_max_window_bits;
+            pmd_->rd_bits = pmd_config_.client_max_window_bits;
         }
     }
 }
@@ -257,6 +308,58 @@ close()
     pmd_.reset();
 }
 
+template<class>
+zlib::deflate_stream&
+stream_base::
+pmd_zo()
+{
+    BOOST_ASSERT(pmd_);
+    if(! pmd_->zo)
+    {
+        pmd_->zo = pmd_pool::instance().get_deflate();
+        pmd_->zo->reset(
+            pmd_->compLevel,
+            pmd_->wr_bits,
+            pmd_->memLevel,
+            zlib::Strategy::normal);
+    }
+    return *pmd_->zo;
+}
+
+template<class>
+zlib::inflate_stream&
+stream_base::
+pmd_zi()
+{
+    BOOST_ASSERT(pmd_);
+    if(! pmd_->zi)
+    {
+        pmd_->zi = pmd_pool::instance().get_inflate();
+        pmd_->zi->reset(pmd_->rd_bits);
+    }
+    return *pmd_->zi;
+}
+
+template<class>
+void
+stream_base::
+pmd_wr_done()
+{
+    // Give it back, the next message starts from scratch
+    if(pmd_->wr_reset)
+        pmd_->zo = nullptr;
+}
+
+template<class>
+void
+stream_base::
+pmd_rd_done()
+{
+    if(pmd_->rd_reset)
+        pmd_->zi = nullptr;
+    rd_.buf = nullptr;
+}
+
 // Read fixed frame header from buffer
 // Requires at least 2 bytes
 //
@@ -448,12 +551,12 @@ stream_base::
 rd_begin()
 {
     // Maintain the read buffer
-    if(pmd_)
+    if(pmd_ && pmd_->rd_set)
     {
         if(! rd_.buf || rd_.buf_size != rd_buf_size_)
         {
             rd_.buf_size = rd_buf_size_;
-            rd_.buf.reset(new std::uint8_t[rd_.buf_size]);
+            rd_.buf = buffer_pool::instance().get(rd_.buf_size);
         }
     }
 }
@@ -473,7 +576,7 @@ wr_begin()
         if(! wr_.buf || wr_.buf_size != wr_buf_size_)
         {
             wr_.buf_size = wr_buf_size_;
-            wr_.buf.reset(new std::uint8_t[wr_.buf_size]);
+            wr_.buf = buffer_pool::instance().get(wr_.buf_size);
         }
     }
     else
@@ -483,6 +586,14 @@ wr_begin()
     }
 }
 
+template<class>
+void
+stream_base::
+wr_done()
+{
+    wr_.buf = nullptr;
+}
+
 template<class DynamicBuffer>
 void
 stream_base::
@@ -11,6 +11,7 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/assert.hpp>
 #include <beast/core/buffer_concepts.hpp>
+#include <beast/core/detail/cpu_info.hpp>
 #include <algorithm>
 #include <cstdint>
 
@@ -63,6 +64,246 @@ namespace detail {
     3. This notice may not be removed or altered from any source distribution.
 */
 
+/*  Bulk UTF8 validators.
+
+    Each function validates a prefix of [first, last), which must
+    begin on a character boundary. It returns the end of the valid
+    prefix, which is also on a character boundary, or `nullptr` if
+    the prefix contains invalid text. The remaining octets, at most
+    one block plus an incomplete sequence, are left for the caller.
+
+    The vector versions implement the range lookup algorithm from
+    "Validating UTF-8 In Less Than One Instruction Per Byte",
+    John Keiser and Daniel Lemire, 2020. Every pair of adjacent
+    octets is classified with three 16-entry table lookups, indexed
+    by the high and low nibbles of the first octet and the high
+    nibble of the second. Each table entry is a set of error bits
+    and the pair is invalid when one bit is set in all three. Third
+    and fourth octets of a sequence are checked separately against
+    the lead octets two and three positions back.
+*/
+using utf8_skip_fn = std::uint8_t const*(*)(
+    std::uint8_t const*, std::uint8_t const*);
+
+inline
+std::uint8_t const*
+utf8_skip_scalar(std::uint8_t const* first, std::uint8_t const*)
+{
+    return first;
+}
+
+// Returns the start of an incomplete sequence
+// at the end of [first, last), or last.
+inline
+std::uint8_t const*
+utf8_rewind(std::uint8_t const* first, std::uint8_t const* last)
+{
+    for(std::size_t i = 1; i <= 3 &&
+        static_cast<std::size_t>(last - first) >= i; ++i)
+    {
+        auto const c = last[-static_cast<std::ptrdiff_t>(i)];
+        if(c < 0x80)
+            break;
+        if(c >= 0xc0)
+        {
+            std::size_t const len =
+                c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : 2;
+            if(len > i)
+                return last - i;
+            break;
+        }
+    }
+    return last;
+}
+
+#if BEAST_DETAIL_X86
+
+// Lookup tables for the vector validators
+//
+inline
+std::uint8_t const*
+utf8_tables()
+{
+    // Error bits
+    //  0x01 too short   lead or ASCII followed by lead or ASCII
+    //  0x02 too long    ASCII followed by continuation
+    //  0x04 overlong 3  E0 80..9F
+    //  0x08 too large   F4 90..BF, F5..FF 90..BF
+    //  0x10 surrogate   ED A0..BF
+    //  0x20 overlong 2  C0..C1 80..BF
+    //  0x40 overlong 4  F0 80..8F, or too large F5..FF 80..8F
+    //  0x80 two continuations
+    alignas(16) static std::uint8_t constexpr tab[4][16] = {
+        // first octet, high nibble
+        {
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+            0x80, 0x80, 0x80, 0x80, 0x21, 0x01, 0x15, 0x49
+        },
+        // first octet, low nibble
+        {
+            0xe7, 0xa3, 0x83, 0x83, 0x8b, 0xcb, 0xcb, 0xcb,
+            0xcb, 0xcb, 0xcb, 0xcb, 0xcb, 0xdb, 0xcb, 0xcb
+        },
+        // second octet, high nibble
+        {
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+            0xe6, 0xae, 0xba, 0xba, 0x01, 0x01, 0x01, 0x01
+        },
+        // subtracted from the last octets of a block
+        // to find a sequence which continues past it
+        {
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+        }
+    };
+    return &tab[0][0];
+}
+
+BEAST_DETAIL_TARGET("ssse3")
+inline
+std::uint8_t const*
+utf8_skip_ssse3(std::uint8_t const* first, std::uint8_t const* last)
+{
+    auto const tab = reinterpret_cast<
+        __m128i const*>(utf8_tables());
+    auto const t1h = _mm_load_si128(tab);
+    auto const t1l = _mm_load_si128(tab + 1);
+    auto const t2h = _mm_load_si128(tab + 2);
+    auto const tmax = _mm_load_si128(tab + 3);
+    auto const nib = _mm_set1_epi8(0x0f);
+    auto const third = _mm_set1_epi8(0xe0 - 0x80);
+    auto const fourth = _mm_set1_epi8(
+        static_cast<char>(0xf0 - 0x80));
+    auto const high = _mm_set1_epi8(
+        static_cast<char>(0x80));
+    auto prev = _mm_setzero_si128();
+    auto incomplete = _mm_setzero_si128();
+    auto err = _mm_setzero_si128();
+    auto p = first;
+    while(last - p >= 16)
+    {
+        auto const v = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(p));
+        if(_mm_movemask_epi8(v) == 0)
+        {
+            // ASCII is only wrong after a truncated sequence
+            err = _mm_or_si128(err, incomplete);
+        }
+        else
+        {
+            auto const p1 = _mm_alignr_epi8(v, prev, 15);
+            auto const sc = _mm_and_si128(_mm_and_si128(
+                _mm_shuffle_epi8(t1h, _mm_and_si128(
+                    _mm_srli_epi16(p1, 4), nib)),
+                _mm_shuffle_epi8(t1l,
+                    _mm_and_si128(p1, nib))),
+                _mm_shuffle_epi8(t2h, _mm_and_si128(
+                    _mm_srli_epi16(v, 4), nib)));
+            auto const must23 = _mm_and_si128(_mm_or_si128(
+                _mm_subs_epu8(
+                    _mm_alignr_epi8(v, prev, 14), third),
+                _mm_subs_epu8(
+                    _mm_alignr_epi8(v, prev, 13), fourth)),
+                high);
+            err = _mm_or_si128(err, _mm_xor_si128(must23, sc));
+        }
+        incomplete = _mm_subs_epu8(v, tmax);
+        prev = v;
+        p += 16;
+    }
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(
+            err, _mm_setzero_si128())) != 0xffff)
+        return nullptr;
+    return utf8_rewind(first, p);
+}
+
+BEAST_DETAIL_TARGET("avx2")
+inline
+std::uint8_t const*
+utf8_skip_avx2(std::uint8_t const* first, std::uint8_t const* last)
+{
+    auto const tab = reinterpret_cast<
+        __m128i const*>(utf8_tables());
+    auto const t1h = _mm256_broadcastsi128_si256(
+        _mm_load_si128(tab));
+    auto const t1l = _mm256_broadcastsi128_si256(
+        _mm_load_si128(tab + 1));
+    auto const t2h = _mm256_broadcastsi128_si256(
+        _mm_load_si128(tab + 2));
+    // Only the last octets of the upper lane matter
+    auto const tmax = _mm256_inserti128_si256(
+        _mm256_set1_epi8(-1), _mm_load_si128(tab + 3), 1);
+    auto const nib = _mm256_set1_epi8(0x0f);
+    auto const third = _mm256_set1_epi8(0xe0 - 0x80);
+    auto const fourth = _mm256_set1_epi8(
+        static_cast<char>(0xf0 - 0x80));
+    auto const high = _mm256_set1_epi8(
+        static_cast<char>(0x80));
+    auto prev = _mm256_setzero_si256();
+    auto incomplete = _mm256_setzero_si256();
+    auto err = _mm256_setzero_si256();
+    auto p = first;
+    while(last - p >= 32)
+    {
+        auto const v = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(p));
+        if(_mm256_movemask_epi8(v) == 0)
+        {
+            err = _mm256_or_si256(err, incomplete);
+        }
+        else
+        {
+            // The previous 16 octets of each lane
+            auto const pv = _mm256_permute2x128_si256(
+                prev, v, 0x21);
+            auto const p1 = _mm256_alignr_epi8(v, pv, 15);
+            auto const sc = _mm256_and_si256(_mm256_and_si256(
+                _mm256_shuffle_epi8(t1h, _mm256_and_si256(
+                    _mm256_srli_epi16(p1, 4), nib)),
+                _mm256_shuffle_epi8(t1l,
+                    _mm256_and_si256(p1, nib))),
+                _mm256_shuffle_epi8(t2h, _mm256_and_si256(
+                    _mm256_srli_epi16(v, 4), nib)));
+            auto const must23 = _mm256_and_si256(_mm256_or_si256(
+                _mm256_subs_epu8(
+                    _mm256_alignr_epi8(v, pv, 14), third),
+                _mm256_subs_epu8(
+                    _mm256_alignr_epi8(v, pv, 13), fourth)),
+                high);
+            err = _mm256_or_si256(err,
+                _mm256_xor_si256(must23, sc));
+        }
+        incomplete = _mm256_subs_epu8(v, tmax);
+        prev = v;
+        p += 32;
+    }
+    auto const ok = _mm256_testz_si256(err, err);
+    // Avoid the AVX-SSE transition penalty on return
+    _mm256_zeroupper();
+    if(! ok)
+        return nullptr;
+    return utf8_rewind(first, p);
+}
+
+#endif
+
+inline
+utf8_skip_fn
+select_utf8_skip()
+{
+#if BEAST_DETAIL_X86
+    auto const& ci = beast::detail::get_cpu_info();
+    if(ci.avx2)
+        return &utf8_skip_avx2;
+    if(ci.ssse3)
+        return &utf8_skip_ssse3;
+#endif
+    return &utf8_skip_scalar;
+}
+
+// Text shorter than this is checked with the scalar code
+std::size_t constexpr utf8_skip_min = 64;
+
 /** A UTF8 validator.
 
     This validator can be used to check if a buffer containing UTF8 text is
@@ -92,7 +333,18 @@ public:
         @return `true` if the text is valid utf8 or false otherwise.
     */
     bool
-    write(std::uint8_t const* in, std::size_t size);
+    write(std::uint8_t const* in, std::size_t size)
+    {
+        static utf8_skip_fn const skip = select_utf8_skip();
+        return write(in, size, skip);
+    }
+
+    /** Check if text is valid UTF8, using the given bulk validator
+
+        @return `true` if the text is valid utf8 or false otherwise.
+    */
+    bool
+    write(std::uint8_t const* in, std::size_t size, utf8_skip_fn skip);
 
     /** Check if text is valid UTF8
 
@@ -138,7 +390,8 @@ utf8_checker_t<_>::write(ConstBufferSequence const& bs)
 
 template<class _>
 bool
-utf8_checker_t<_>::write(std::uint8_t const* in, std::size_t size)
+utf8_checker_t<_>::write(std::uint8_t const* in,
+    std::size_t size, utf8_skip_fn skip)
 {
     auto const valid =
         [](std::uint8_t const*& in)
@@ -150,8 +403,9 @@ utf8_checker_t<_>::write(std::uint8_t const* in, std::size_t size)
             }
             if ((in[0] & 0x60) == 0x40)
             {
-                if ((in[1] & 0xc0) != 0x80)
-                    return false;
+                if (in[0] < 194 ||
+                    (in[1] & 0xc0) != 0x80)
+                        return false;
                 in += 2;
                 return true;
             }
@@ -241,6 +495,14 @@ utf8_checker_t<_>::write(std::uint8_t const* in, std::size_t size)
         p_ = have_;
     }
 
+    if(size >= utf8_skip_min)
+    {
+        in = skip(in, end);
+        if(! in)
+            return false;
+        size = static_cast<std::size_t>(end - in);
+    }
+
     auto last = in + size - 7;
     while(in < last)
     {
@@ -132,6 +132,7 @@ operator()(error_code ec, bool again)
                 pmd_read(
                     d.ws.pmd_config_, d.res.fields);
                 d.ws.open(detail::role_type::server);
+                d.ws.stream_.buffer().shrink_to_fit();
             }
             break;
         }
@@ -289,8 +290,9 @@ async_accept(ConstBufferSequence const& bs, AcceptHandler&& handler)
     beast::async_completion<
         AcceptHandler, void(error_code)
             > completion{handler};
-    accept_op<decltype(completion.handler)>{
-        completion.handler, *this, bs};
+    accept_op<memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, bs};
     return completion.result.get();
 }
 
@@ -308,8 +310,9 @@ async_accept(http::request<Body, Fields> const& req,
         AcceptHandler, void(error_code)
             > completion{handler};
     reset();
-    response_op<decltype(completion.handler)>{
-        completion.handler, *this, req,
+    response_op<memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, req,
             beast_asio_helpers::
                 is_continuation(completion.handler)};
     return completion.result.get();
@@ -416,6 +419,7 @@ accept(http::request<Body, Fields> const& req,
     }
     pmd_read(pmd_config_, req.fields);
     open(detail::role_type::server);
+    stream_.buffer().shrink_to_fit();
 }
 
 //------------------------------------------------------------------------------
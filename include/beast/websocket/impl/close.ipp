@@ -207,8 +207,9 @@ async_close(close_reason const& cr, CloseHandler&& handler)
     beast::async_completion<
         CloseHandler, void(error_code)
             > completion{handler};
-    close_op<decltype(completion.handler)>{
-        completion.handler, *this, cr};
+    close_op<memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, cr};
     return completion.result.get();
 }
 
@@ -159,8 +159,9 @@ async_handshake(boost::string_ref const& host,
     beast::async_completion<
         HandshakeHandler, void(error_code)
             > completion{handler};
-    handshake_op<decltype(completion.handler)>{
-        completion.handler, *this, host, resource};
+    handshake_op<memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, host, resource};
     return completion.result.get();
 }
 
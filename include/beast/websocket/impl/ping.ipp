@@ -205,8 +205,9 @@ async_ping(ping_data const& payload, WriteHandler&& handler)
     beast::async_completion<
         WriteHandler, void(error_code)
             > completion{handler};
-    ping_op<decltype(completion.handler)>{
-        completion.handler, *this,
+    ping_op<memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this,
             opcode::ping, payload};
     return completion.result.get();
 }
@@ -223,8 +224,9 @@ async_pong(ping_data const& payload, WriteHandler&& handler)
     beast::async_completion<
         WriteHandler, void(error_code)
             > completion{handler};
-    ping_op<decltype(completion.handler)>{
-        completion.handler, *this,
+    ping_op<memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this,
             opcode::pong, payload};
     return completion.result.get();
 }
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_IPP
+#define BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_IPP
+
+#include <beast/core/buffer_concepts.hpp>
+#include <beast/core/consuming_buffers.hpp>
+#include <beast/core/error.hpp>
+#include <beast/core/static_streambuf.hpp>
+#include <beast/websocket/detail/frame.hpp>
+#include <beast/websocket/detail/pmd_extension.hpp>
+#include <beast/websocket/detail/pmd_pool.hpp>
+#include <string>
+
+namespace beast {
+namespace websocket {
+
+template<class ConstBufferSequence>
+void
+prepared_message::
+make_frame(frame& f, opcode op, bool rsv1,
+    ConstBufferSequence const& payload)
+{
+    using boost::asio::buffer;
+    using boost::asio::buffer_copy;
+    using boost::asio::buffer_size;
+    detail::frame_header fh;
+    fh.op = op;
+    fh.fin = true;
+    fh.mask = false;
+    fh.rsv1 = rsv1;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = buffer_size(payload);
+    fh.key = 0;
+    detail::fh_streambuf fh_buf;
+    detail::write<static_streambuf>(fh_buf, fh);
+    f.header = fh_buf.size();
+    f.size = f.header + buffer_size(payload);
+    f.data.reset(new std::uint8_t[f.size]);
+    buffer_copy(buffer(f.data.get(), f.header), fh_buf.data());
+    buffer_copy(buffer(f.data.get() + f.header,
+        f.size - f.header), payload);
+}
+
+template<class ConstBufferSequence>
+auto
+prepared_message::
+make_impl(message_type type,
+    ConstBufferSequence const& buffers) ->
+        std::unique_ptr<impl>
+{
+    static_assert(beast::is_ConstBufferSequence<
+        ConstBufferSequence>::value,
+            "ConstBufferSequence requirements not met");
+    std::unique_ptr<impl> p{new impl};
+    p->op = type.value;
+    p->size = boost::asio::buffer_size(buffers);
+    make_frame(p->plain, p->op, false, buffers);
+    return p;
+}
+
+template<class ConstBufferSequence>
+prepared_message::
+prepared_message(message_type type,
+    ConstBufferSequence const& buffers)
+    : impl_(make_impl(type, buffers))
+{
+}
+
+template<class ConstBufferSequence>
+prepared_message::
+prepared_message(message_type type,
+    ConstBufferSequence const& buffers,
+        permessage_deflate const& opts)
+{
+    using boost::asio::buffer;
+    using boost::asio::buffer_size;
+    auto p = make_impl(type, buffers);
+    p->window_bits = opts.server_max_window_bits;
+    auto zo = detail::pmd_pool::instance().get_deflate();
+    zo->reset(opts.compLevel, p->window_bits,
+        opts.memLevel, zlib::Strategy::normal);
+    // Compress the copy, it is in one piece
+    consuming_buffers<boost::asio::const_buffers_1> cb{
+        boost::asio::const_buffers_1{p->plain.payload()}};
+    std::string out;
+    std::uint8_t tmp[4096];
+    error_code ec;
+    for(;;)
+    {
+        boost::asio::mutable_buffer b{tmp, sizeof(tmp)};
+        auto const more = detail::deflate(
+            *zo, b, cb, true, ec);
+        if(ec)
+            throw system_error{ec};
+        out.append(reinterpret_cast<
+            char const*>(tmp), buffer_size(b));
+        if(! more)
+            break;
+    }
+    if(out.size() < p->size)
+        make_frame(p->deflated, p->op, true,
+            buffer(out.data(), out.size()));
+    impl_ = std::move(p);
+}
+
+} // websocket
+} // beast
+
+#endif
@@ -225,13 +225,20 @@ operator()(error_code ec,
                 d.remain -= bytes_transferred;
                 auto const pb = prepare_buffers(
                     bytes_transferred, *d.dmb);
-                if(d.fh.mask)
-                    detail::mask_inplace(pb, d.key);
                 if(d.ws.rd_.op == opcode::text)
                 {
-                    if(! d.ws.rd_.utf8.write(pb) ||
-                        (d.remain == 0 && d.fh.fin &&
-                            ! d.ws.rd_.utf8.finish()))
+                    auto& utf8 = d.ws.rd_.utf8;
+                    // Validate each piece right after it is
+                    // unmasked, while it is still in cache.
+                    auto const valid = d.fh.mask ?
+                        detail::mask_inplace_each(pb, d.key,
+                            [&](std::uint8_t const* p, std::size_t n)
+                            {
+                                return utf8.write(p, n);
+                            }) :
+                        utf8.write(pb);
+                    if(! valid || (d.remain == 0 && d.fh.fin &&
+                        ! utf8.finish()))
                     {
                         // invalid utf8
                         code = close_code::bad_payload;
@@ -239,6 +246,10 @@ operator()(error_code ec,
                         break;
                     }
                 }
+                else if(d.fh.mask)
+                {
+                    detail::mask_inplace(pb, d.key);
+                }
                 d.db.commit(bytes_transferred);
                 if(d.remain > 0)
                 {
@@ -284,7 +295,7 @@ operator()(error_code ec,
                 if(d.fh.mask)
                     detail::mask_inplace(in, d.key);
                 auto const prev = d.db.size();
-                detail::inflate(d.ws.pmd_->zi, d.db, in, ec);
+                detail::inflate(d.ws.pmd_zi(), d.db, in, ec);
                 d.ws.failed_ = ec != 0;
                 if(d.ws.failed_)
                     break;
@@ -293,7 +304,7 @@ operator()(error_code ec,
                     static std::uint8_t constexpr
                         empty_block[4] = {
                             0x00, 0x00, 0xff, 0xff };
-                    detail::inflate(d.ws.pmd_->zi, d.db,
+                    detail::inflate(d.ws.pmd_zi(), d.db,
                         buffer(&empty_block[0], 4), ec);
                     d.ws.failed_ = ec != 0;
                     if(d.ws.failed_)
@@ -320,12 +331,8 @@ operator()(error_code ec,
                     d.state = do_inflate_payload + 1;
                     break;
                 }
-                if(d.fh.fin && (
-                    (d.ws.role_ == detail::role_type::client &&
-                        d.ws.pmd_config_.server_no_context_takeover) ||
-                    (d.ws.role_ == detail::role_type::server &&
-                        d.ws.pmd_config_.client_no_context_takeover)))
-                    d.ws.pmd_->zi.reset();
+                if(d.fh.fin)
+                    d.ws.pmd_rd_done();
                 d.state = do_frame_done;
                 break;
             }
@@ -333,6 +340,9 @@ operator()(error_code ec,
             //------------------------------------------------------------------
 
             case do_frame_done:
+                // Handshake leftovers are gone, release the memory
+                if(d.ws.stream_.buffer().size() == 0)
+                    d.ws.stream_.buffer().shrink_to_fit();
                 // call handler
                 d.fi.op = d.ws.rd_.op;
                 d.fi.fin = d.fh.fin;
@@ -692,8 +702,9 @@ async_read_frame(frame_info& fi,
         "DynamicBuffer requirements not met");
     beast::async_completion<
         ReadHandler, void(error_code)> completion{handler};
-    read_frame_op<DynamicBuffer, decltype(completion.handler)>{
-        completion.handler, *this, fi, dynabuf};
+    read_frame_op<DynamicBuffer, memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, fi, dynabuf};
     return completion.result.get();
 }
 
@@ -860,18 +871,28 @@ read_frame(frame_info& fi, DynamicBuffer& dynabuf, error_code& ec)
                 remain -= bytes_transferred;
                 auto const pb = prepare_buffers(
                     bytes_transferred, b);
-                if(fh.mask)
-                    detail::mask_inplace(pb, key);
                 if(rd_.op == opcode::text)
                 {
-                    if(! rd_.utf8.write(pb) ||
-                        (remain == 0 && fh.fin &&
-                            ! rd_.utf8.finish()))
+                    // Validate each piece right after it is
+                    // unmasked, while it is still in cache.
+                    auto const valid = fh.mask ?
+                        detail::mask_inplace_each(pb, key,
+                            [&](std::uint8_t const* p, std::size_t n)
+                            {
+                                return rd_.utf8.write(p, n);
+                            }) :
+                        rd_.utf8.write(pb);
+                    if(! valid || (remain == 0 && fh.fin &&
+                        ! rd_.utf8.finish()))
                     {
                         code = close_code::bad_payload;
                         goto do_close;
                     }
                 }
+                else if(fh.mask)
+                {
+                    detail::mask_inplace(pb, key);
+                }
                 dynabuf.commit(bytes_transferred);
             }
         }
@@ -894,7 +915,7 @@ read_frame(frame_info& fi, DynamicBuffer& dynabuf, error_code& ec)
                 if(fh.mask)
                     detail::mask_inplace(in, key);
                 auto const prev = dynabuf.size();
-                detail::inflate(pmd_->zi, dynabuf, in, ec);
+                detail::inflate(pmd_zi(), dynabuf, in, ec);
                 failed_ = ec != 0;
                 if(failed_)
                     return;
@@ -903,7 +924,7 @@ read_frame(frame_info& fi, DynamicBuffer& dynabuf, error_code& ec)
                     static std::uint8_t constexpr
                         empty_block[4] = {
                             0x00, 0x00, 0xff, 0xff };
-                    detail::inflate(pmd_->zi, dynabuf,
+                    detail::inflate(pmd_zi(), dynabuf,
                         buffer(&empty_block[0], 4), ec);
                     failed_ = ec != 0;
                     if(failed_)
@@ -926,13 +947,12 @@ read_frame(frame_info& fi, DynamicBuffer& dynabuf, error_code& ec)
                 if(remain == 0)
                     break;
             }
-            if(fh.fin && (
-                (role_ == detail::role_type::client &&
-                    pmd_config_.server_no_context_takeover) ||
-                (role_ == detail::role_type::server &&
-                    pmd_config_.client_no_context_takeover)))
-                pmd_->zi.reset();
+            if(fh.fin)
+                pmd_rd_done();
         }
+        // Handshake leftovers are gone, release the memory
+        if(stream_.buffer().size() == 0)
+            stream_.buffer().shrink_to_fit();
         fi.op = rd_.op;
         fi.fin = fh.fin;
         return;
@@ -1091,8 +1111,9 @@ async_read(opcode& op,
     beast::async_completion<
         ReadHandler, void(error_code)
             > completion{handler};
-    read_op<DynamicBuffer, decltype(completion.handler)>{
-        completion.handler, *this, op, dynabuf};
+    read_op<DynamicBuffer, memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, op, dynabuf};
     return completion.result.get();
 }
 
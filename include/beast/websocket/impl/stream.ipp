@@ -222,6 +222,7 @@ do_response(http::response<Body, Fields> const& res,
     //        return an error if not.
     pmd_config_ = offer; // overwrite for now
     open(detail::role_type::client);
+    stream_.buffer().shrink_to_fit();
 }
 
 } // websocket
@@ -141,7 +141,6 @@ operator()(error_code ec,
 {
     using beast::detail::clamp;
     using boost::asio::buffer;
-    using boost::asio::buffer_copy;
     using boost::asio::buffer_size;
     enum
     {
@@ -314,8 +313,7 @@ operator()(error_code ec,
                 clamp(d.remain, d.ws.wr_.buf_size);
             auto const b =
                 buffer(d.ws.wr_.buf.get(), n);
-            buffer_copy(b, d.cb);
-            detail::mask_inplace(b, d.key);
+            detail::mask_copy(b, d.cb, d.key);
             d.remain -= n;
             d.ws.wr_.cont = ! d.fin;
             // Send frame header and partial payload
@@ -334,8 +332,7 @@ operator()(error_code ec,
                 clamp(d.remain, d.ws.wr_.buf_size);
             auto const b =
                 buffer(d.ws.wr_.buf.get(), n);
-            buffer_copy(b, d.cb);
-            detail::mask_inplace(b, d.key);
+            detail::mask_copy(b, d.cb, d.key);
             d.remain -= n;
             // Send parial payload
             if(d.remain == 0)
@@ -364,8 +361,7 @@ operator()(error_code ec,
             detail::prepare_key(d.key, d.fh.key);
             auto const b = buffer(
                 d.ws.wr_.buf.get(), n);
-            buffer_copy(b, d.cb);
-            detail::mask_inplace(b, d.key);
+            detail::mask_copy(b, d.cb, d.key);
             detail::write<static_streambuf>(
                 d.fh_buf, d.fh);
             d.ws.wr_.cont = ! d.fin;
@@ -411,7 +407,7 @@ operator()(error_code ec,
             auto b = buffer(d.ws.wr_.buf.get(),
                 d.ws.wr_.buf_size);
             auto const more = detail::deflate(
-                d.ws.pmd_->zo, b, d.cb, d.fin, ec);
+                d.ws.pmd_zo(), b, d.cb, d.fin, ec);
             d.ws.failed_ = ec != 0;
             if(d.ws.failed_)
                 goto upcall;
@@ -472,12 +468,8 @@ operator()(error_code ec,
             break;
 
         case do_deflate + 3:
-            if(d.fh.fin && (
-                (d.ws.role_ == detail::role_type::client &&
-                    d.ws.pmd_config_.client_no_context_takeover) ||
-                (d.ws.role_ == detail::role_type::server &&
-                    d.ws.pmd_config_.server_no_context_takeover)))
-                d.ws.pmd_->zo.reset();
+            if(d.fh.fin)
+                d.ws.pmd_wr_done();
             goto upcall;
 
         //----------------------------------------------------------------------
@@ -538,6 +530,8 @@ operator()(error_code ec,
 upcall:
     if(d.ws.wr_block_ == &d)
         d.ws.wr_block_ = nullptr;
+    if(! d.ws.wr_.cont)
+        d.ws.wr_done();
     d.ws.rd_op_.maybe_invoke() ||
         d.ws.ping_op_.maybe_invoke();
     d_.invoke(ec);
@@ -559,9 +553,9 @@ async_write_frame(bool fin,
     beast::async_completion<
         WriteHandler, void(error_code)
             > completion{handler};
-    write_frame_op<ConstBufferSequence, decltype(
-        completion.handler)>{completion.handler,
-            *this, fin, bs};
+    write_frame_op<ConstBufferSequence, memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, fin, bs};
     return completion.result.get();
 }
 
@@ -596,7 +590,6 @@ write_frame(bool fin,
             "ConstBufferSequence requirements not met");
     using beast::detail::clamp;
     using boost::asio::buffer;
-    using boost::asio::buffer_copy;
     using boost::asio::buffer_size;
     detail::frame_header fh;
     if(! wr_.cont)
@@ -622,7 +615,7 @@ write_frame(bool fin,
             auto b = buffer(
                 wr_.buf.get(), wr_.buf_size);
             auto const more = detail::deflate(
-                pmd_->zo, b, cb, fin, ec);
+                pmd_zo(), b, cb, fin, ec);
             failed_ = ec != 0;
             if(failed_)
                 return;
@@ -659,12 +652,11 @@ write_frame(bool fin,
             fh.op = opcode::cont;
             fh.rsv1 = false;
         }
-        if(fh.fin && (
-            (role_ == detail::role_type::client &&
-                pmd_config_.client_no_context_takeover) ||
-            (role_ == detail::role_type::server &&
-                pmd_config_.server_no_context_takeover)))
-            pmd_->zo.reset();
+        if(fh.fin)
+        {
+            pmd_wr_done();
+            wr_done();
+        }
         return;
     }
     if(! fh.mask)
@@ -727,10 +719,9 @@ write_frame(bool fin,
         {
             auto const n = clamp(remain, wr_.buf_size);
             auto const b = buffer(wr_.buf.get(), n);
-            buffer_copy(b, cb);
+            detail::mask_copy(b, cb, key);
             cb.consume(n);
             remain -= n;
-            detail::mask_inplace(b, key);
             wr_.cont = ! fin;
             boost::asio::write(stream_,
                 buffer_cat(fh_buf.data(), b), ec);
@@ -742,15 +733,16 @@ write_frame(bool fin,
         {
             auto const n = clamp(remain, wr_.buf_size);
             auto const b = buffer(wr_.buf.get(), n);
-            buffer_copy(b, cb);
+            detail::mask_copy(b, cb, key);
             cb.consume(n);
             remain -= n;
-            detail::mask_inplace(b, key);
             boost::asio::write(stream_, b, ec);
             failed_ = ec != 0;
             if(failed_)
                 return;
         }
+        if(fin)
+            wr_done();
         return;
     }
     {
@@ -765,8 +757,7 @@ write_frame(bool fin,
             detail::prepare_key(key, fh.key);
             auto const n = clamp(remain, wr_.buf_size);
             auto const b = buffer(wr_.buf.get(), n);
-            buffer_copy(b, cb);
-            detail::mask_inplace(b, key);
+            detail::mask_copy(b, cb, key);
             fh.len = n;
             remain -= n;
             fh.fin = fin ? remain == 0 : false;
@@ -782,6 +773,8 @@ write_frame(bool fin,
             fh.op = opcode::cont;
             cb.consume(n);
         }
+        if(fin)
+            wr_done();
         return;
     }
 }
@@ -907,8 +900,9 @@ async_write(ConstBufferSequence const& bs, WriteHandler&& handler)
             "ConstBufferSequence requirements not met");
     beast::async_completion<
         WriteHandler, void(error_code)> completion{handler};
-    write_op<ConstBufferSequence, decltype(completion.handler)>{
-        completion.handler, *this, bs};
+    write_op<ConstBufferSequence, memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, bs};
     return completion.result.get();
 }
 
@@ -943,6 +937,388 @@ write(ConstBufferSequence const& buffers, error_code& ec)
     write_frame(true, buffers, ec);
 }
 
+//------------------------------------------------------------------------------
+
+template<class NextLayer>
+prepared_message::frame const&
+stream<NextLayer>::
+prepared_frame(prepared_message const& msg)
+{
+    auto const& impl = *msg.impl_;
+    if(! pmd_ || ! impl.deflated.data ||
+            impl.window_bits > pmd_->wr_bits)
+        return impl.plain;
+    // The peer's window now holds data our compressor
+    // never saw, the next message starts from scratch.
+    pmd_->zo = nullptr;
+    return impl.deflated;
+}
+
+template<class NextLayer>
+template<class Handler>
+class stream<NextLayer>::write_prepared_op
+{
+    struct data : op
+    {
+        bool cont;
+        stream<NextLayer>& ws;
+        prepared_message msg;
+        boost::asio::const_buffer payload;
+        detail::fh_streambuf fh_buf;
+        detail::prepared_key key;
+        int state = 0;
+        int entry_state;
+
+        data(Handler& handler, stream<NextLayer>& ws_,
+                prepared_message const& msg_)
+            : cont(beast_asio_helpers::
+                is_continuation(handler))
+            , ws(ws_)
+            , msg(msg_)
+        {
+        }
+    };
+
+    handler_ptr<data, Handler> d_;
+
+public:
+    write_prepared_op(write_prepared_op&&) = default;
+    write_prepared_op(write_prepared_op const&) = default;
+
+    template<class DeducedHandler, class... Args>
+    write_prepared_op(DeducedHandler&& h,
+            stream<NextLayer>& ws, Args&&... args)
+        : d_(std::forward<DeducedHandler>(h),
+            ws, std::forward<Args>(args)...)
+    {
+        (*this)(error_code{}, 0, false);
+    }
+
+    void operator()()
+    {
+        (*this)(error_code{}, 0, true);
+    }
+
+    void operator()(error_code const& ec)
+    {
+        (*this)(ec, 0, true);
+    }
+
+    void operator()(error_code ec,
+        std::size_t bytes_transferred)
+    {
+        auto& d = *d_;
+        if(ec)
+            d.ws.failed_ = true;
+        (*this)(ec, bytes_transferred, true);
+    }
+
+    void operator()(error_code ec,
+        std::size_t bytes_transferred, bool again);
+
+    friend
+    void* asio_handler_allocate(
+        std::size_t size, write_prepared_op* op)
+    {
+        return beast_asio_helpers::
+            allocate(size, op->d_.handler());
+    }
+
+    friend
+    void asio_handler_deallocate(
+        void* p, std::size_t size, write_prepared_op* op)
+    {
+        return beast_asio_helpers::
+            deallocate(p, size, op->d_.handler());
+    }
+
+    friend
+    bool asio_handler_is_continuation(write_prepared_op* op)
+    {
+        return op->d_->cont;
+    }
+
+    template<class Function>
+    friend
+    void asio_handler_invoke(Function&& f, write_prepared_op* op)
+    {
+        return beast_asio_helpers::
+            invoke(f, op->d_.handler());
+    }
+};
+
+template<class NextLayer>
+template<class Handler>
+void
+stream<NextLayer>::
+write_prepared_op<Handler>::
+operator()(error_code ec, std::size_t, bool again)
+{
+    using beast::detail::clamp;
+    using boost::asio::buffer;
+    using boost::asio::buffer_size;
+    enum
+    {
+        do_init = 0,
+        do_nomask = 20,
+        do_mask = 40,
+        do_maybe_suspend = 80,
+        do_upcall = 99
+    };
+    auto& d = *d_;
+    d.cont = d.cont || again;
+    if(ec)
+        goto upcall;
+    for(;;)
+    {
+        switch(d.state)
+        {
+        case do_init:
+            BOOST_ASSERT(! d.ws.wr_.cont);
+            if(d.ws.role_ == detail::role_type::client)
+            {
+                d.ws.wr_begin();
+                d.entry_state = do_mask;
+            }
+            else
+            {
+                d.entry_state = do_nomask;
+            }
+            d.state = do_maybe_suspend;
+            break;
+
+        //----------------------------------------------------------------------
+
+        case do_nomask:
+            BOOST_ASSERT(! d.ws.wr_block_);
+            d.ws.wr_block_ = &d;
+            // [[fallthrough]]
+
+        case do_nomask + 1:
+        {
+            BOOST_ASSERT(d.ws.wr_block_ == &d);
+            auto const& f = d.ws.prepared_frame(d.msg);
+            // Send frame
+            d.state = do_upcall;
+            boost::asio::async_write(d.ws.stream_,
+                boost::asio::const_buffers_1{f.buffer()},
+                    std::move(*this));
+            return;
+        }
+
+        //----------------------------------------------------------------------
+
+        case do_mask:
+            BOOST_ASSERT(! d.ws.wr_block_);
+            d.ws.wr_block_ = &d;
+            // [[fallthrough]]
+
+        case do_mask + 1:
+        {
+            BOOST_ASSERT(d.ws.wr_block_ == &d);
+            auto const& f = d.ws.prepared_frame(d.msg);
+            d.payload = f.payload();
+            detail::frame_header fh;
+            fh.op = d.msg.op();
+            fh.fin = true;
+            fh.mask = true;
+            fh.rsv1 = &f == &d.msg.impl_->deflated;
+            fh.rsv2 = false;
+            fh.rsv3 = false;
+            fh.len = buffer_size(d.payload);
+            fh.key = d.ws.maskgen_();
+            detail::prepare_key(d.key, fh.key);
+            detail::write<static_streambuf>(d.fh_buf, fh);
+            auto const n = clamp(
+                buffer_size(d.payload), d.ws.wr_.buf_size);
+            auto const b = buffer(d.ws.wr_.buf.get(), n);
+            detail::mask_copy(b,
+                boost::asio::const_buffers_1{d.payload}, d.key);
+            d.payload = d.payload + n;
+            // Send frame header and partial payload
+            d.state = buffer_size(d.payload) == 0 ?
+                do_upcall : do_mask + 2;
+            boost::asio::async_write(d.ws.stream_,
+                buffer_cat(d.fh_buf.data(), b),
+                    std::move(*this));
+            return;
+        }
+
+        case do_mask + 2:
+        {
+            auto const n = clamp(
+                buffer_size(d.payload), d.ws.wr_.buf_size);
+            auto const b = buffer(d.ws.wr_.buf.get(), n);
+            detail::mask_copy(b,
+                boost::asio::const_buffers_1{d.payload}, d.key);
+            d.payload = d.payload + n;
+            // Send partial payload
+            if(buffer_size(d.payload) == 0)
+                d.state = do_upcall;
+            boost::asio::async_write(
+                d.ws.stream_, b, std::move(*this));
+            return;
+        }
+
+        //----------------------------------------------------------------------
+
+        case do_maybe_suspend:
+        {
+            if(d.ws.wr_block_)
+            {
+                // suspend
+                d.state = do_maybe_suspend + 1;
+                d.ws.wr_op_.template emplace<
+                    write_prepared_op>(std::move(*this));
+                return;
+            }
+            if(d.ws.failed_ || d.ws.wr_close_)
+            {
+                // call handler
+                d.state = do_upcall;
+                d.ws.get_io_service().post(
+                    bind_handler(std::move(*this),
+                        boost::asio::error::operation_aborted));
+                return;
+            }
+            d.state = d.entry_state;
+            break;
+        }
+
+        case do_maybe_suspend + 1:
+            BOOST_ASSERT(! d.ws.wr_block_);
+            d.ws.wr_block_ = &d;
+            d.state = do_maybe_suspend + 2;
+            // The current context is safe but might not be
+            // the same as the one for this operation (since
+            // we are being called from a write operation).
+            // Call post to make sure we are invoked the same
+            // way as the final handler for this operation.
+            d.ws.get_io_service().post(bind_handler(
+                std::move(*this), ec));
+            return;
+
+        case do_maybe_suspend + 2:
+            BOOST_ASSERT(d.ws.wr_block_ == &d);
+            if(d.ws.failed_ || d.ws.wr_close_)
+            {
+                // call handler
+                ec = boost::asio::error::operation_aborted;
+                goto upcall;
+            }
+            d.state = d.entry_state + 1;
+            break;
+
+        //----------------------------------------------------------------------
+
+        case do_upcall:
+            goto upcall;
+        }
+    }
+upcall:
+    if(d.ws.wr_block_ == &d)
+        d.ws.wr_block_ = nullptr;
+    if(! d.ws.wr_.cont)
+        d.ws.wr_done();
+    d.ws.rd_op_.maybe_invoke() ||
+        d.ws.ping_op_.maybe_invoke();
+    d_.invoke(ec);
+}
+
+template<class NextLayer>
+template<class WriteHandler>
+typename async_completion<
+    WriteHandler, void(error_code)>::result_type
+stream<NextLayer>::
+async_write_prepared(prepared_message const& msg,
+    WriteHandler&& handler)
+{
+    static_assert(is_AsyncStream<next_layer_type>::value,
+        "AsyncStream requirements not met");
+    beast::async_completion<
+        WriteHandler, void(error_code)> completion{handler};
+    write_prepared_op<memory_handler<decltype(
+        completion.handler)>>{bind_memory(mem_,
+            completion.handler), *this, msg};
+    return completion.result.get();
+}
+
+template<class NextLayer>
+void
+stream<NextLayer>::
+write_prepared(prepared_message const& msg)
+{
+    static_assert(is_SyncStream<next_layer_type>::value,
+        "SyncStream requirements not met");
+    error_code ec;
+    write_prepared(msg, ec);
+    if(ec)
+        throw system_error{ec};
+}
+
+template<class NextLayer>
+void
+stream<NextLayer>::
+write_prepared(prepared_message const& msg, error_code& ec)
+{
+    static_assert(is_SyncStream<next_layer_type>::value,
+        "SyncStream requirements not met");
+    using beast::detail::clamp;
+    using boost::asio::buffer;
+    using boost::asio::buffer_size;
+    BOOST_ASSERT(! wr_.cont);
+    auto const& f = prepared_frame(msg);
+    if(role_ == detail::role_type::server)
+    {
+        boost::asio::write(stream_,
+            boost::asio::const_buffers_1{f.buffer()}, ec);
+        failed_ = ec != 0;
+        return;
+    }
+    wr_begin();
+    auto payload = f.payload();
+    detail::frame_header fh;
+    fh.op = msg.op();
+    fh.fin = true;
+    fh.mask = true;
+    fh.rsv1 = &f == &msg.impl_->deflated;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = buffer_size(payload);
+    fh.key = maskgen_();
+    detail::prepared_key key;
+    detail::prepare_key(key, fh.key);
+    detail::fh_streambuf fh_buf;
+    detail::write<static_streambuf>(fh_buf, fh);
+    {
+        auto const n = clamp(
+            buffer_size(payload), wr_.buf_size);
+        auto const b = buffer(wr_.buf.get(), n);
+        detail::mask_copy(b,
+            boost::asio::const_buffers_1{payload}, key);
+        payload = payload + n;
+        boost::asio::write(stream_,
+            buffer_cat(fh_buf.data(), b), ec);
+        failed_ = ec != 0;
+        if(failed_)
+            return;
+    }
+    while(buffer_size(payload) > 0)
+    {
+        auto const n = clamp(
+            buffer_size(payload), wr_.buf_size);
+        auto const b = buffer(wr_.buf.get(), n);
+        detail::mask_copy(b,
+            boost::asio::const_buffers_1{payload}, key);
+        payload = payload + n;
+        boost::asio::write(stream_, b, ec);
+        failed_ = ec != 0;
+        if(failed_)
+            return;
+    }
+    wr_done();
+}
+
 } // websocket
 } // beast
 
@@ -226,7 +226,12 @@ struct permessage_deflate
     /// `true` if client_no_context_takeover desired
     bool client_no_context_takeover = false;
 
-    /// Deflate compression level 0..9
+    /** Deflate compression level 0..9
+
+        Level 1 trades compression ratio for speed: it tries one
+        match per position and sends each block with the static
+        Huffman trees, which suits small, latency sensitive messages.
+    */
     int compLevel = 8;
 
     /// Deflate memory level, 1..9
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+#define BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+
+#include <beast/websocket/option.hpp>
+#include <beast/websocket/rfc6455.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace beast {
+namespace websocket {
+
+template<class NextLayer>
+class stream;
+
+/** A message framed once, for sending to many streams.
+
+    A prepared message holds the frame header and payload of a
+    complete message in an immutable buffer, optionally together
+    with a compressed copy of the payload. Copies of the object
+    share the buffer, and sending the message with
+    @ref stream::write_prepared or @ref stream::async_write_prepared
+    copies or compresses nothing in the server role.
+
+    The compressed copy is sent to streams which negotiated the
+    permessage-deflate extension with a server window at least as
+    large as the one the message was compressed with. Other streams
+    receive the uncompressed payload.
+
+    In the client role, frames must be masked with a key chosen for
+    each frame, so the payload is masked into the write buffer of
+    each stream as it is sent.
+
+    @par Example
+    Sending the same message to many clients.
+    @code
+    ...
+    websocket::prepared_message msg{
+        websocket::message_type{websocket::opcode::text},
+            boost::asio::buffer(s), pmd};
+    for(auto& ws : clients)
+        ws.async_write_prepared(msg, handler);
+    @endcode
+*/
+class prepared_message
+{
+    template<class NextLayer>
+    friend class stream;
+
+    // A complete frame, header followed by payload
+    struct frame
+    {
+        std::unique_ptr<std::uint8_t[]> data;
+        std::size_t header = 0;
+        std::size_t size = 0;
+
+        // The header and payload
+        boost::asio::const_buffer
+        buffer() const
+        {
+            return {data.get(), size};
+        }
+
+        // The payload
+        boost::asio::const_buffer
+        payload() const
+        {
+            return {data.get() + header, size - header};
+        }
+    };
+
+    struct impl
+    {
+        opcode op;
+        std::size_t size;
+        frame plain;
+        frame deflated;
+        int window_bits = 0;
+    };
+
+    std::shared_ptr<impl const> impl_;
+
+    template<class ConstBufferSequence>
+    static
+    void
+    make_frame(frame& f, opcode op, bool rsv1,
+        ConstBufferSequence const& payload);
+
+    template<class ConstBufferSequence>
+    static
+    std::unique_ptr<impl>
+    make_impl(message_type type,
+        ConstBufferSequence const& buffers);
+
+public:
+    /// Copy constructor, the buffer is shared.
+    prepared_message(prepared_message const&) = default;
+
+    /// Copy assignment, the buffer is shared.
+    prepared_message& operator=(prepared_message const&) = default;
+
+    /** Construct an uncompressed message.
+
+        @param type The opcode of the message, text or binary.
+
+        @param buffers The buffers containing the entire message
+        payload. The bytes are copied.
+    */
+    template<class ConstBufferSequence>
+    prepared_message(message_type type,
+        ConstBufferSequence const& buffers);
+
+    /** Construct a message, compressing the payload.
+
+        The payload is compressed using the compression level,
+        memory level and server window bits in `opts`, independently
+        of any other message. The compressed copy is discarded if
+        it is not smaller than the payload.
+
+        @param type The opcode of the message, text or binary.
+
+        @param buffers The buffers containing the entire message
+        payload. The bytes are copied.
+
+        @param opts The permessage-deflate settings used to
+        compress the payload.
+    */
+    template<class ConstBufferSequence>
+    prepared_message(message_type type,
+        ConstBufferSequence const& buffers,
+            permessage_deflate const& opts);
+
+    /// Returns the opcode of the message.
+    opcode
+    op() const
+    {
+        return impl_->op;
+    }
+
+    /// Returns the size of the uncompressed payload.
+    std::size_t
+    size() const
+    {
+        return impl_->size;
+    }
+
+    /// Returns `true` if the message holds a compressed copy.
+    bool
+    compressed() const
+    {
+        return impl_->deflated.data != nullptr;
+    }
+};
+
+} // websocket
+} // beast
+
+#include <beast/websocket/impl/prepared_message.ipp>
+
+#endif
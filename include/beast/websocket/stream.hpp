@@ -9,6 +9,7 @@
 #define BEAST_WEBSOCKET_STREAM_HPP
 
 #include <beast/websocket/option.hpp>
+#include <beast/websocket/prepared_message.hpp>
 #include <beast/websocket/detail/stream_base.hpp>
 #include <beast/http/message.hpp>
 #include <beast/http/string_body.hpp>
@@ -1659,6 +1660,122 @@ public:
     async_write_frame(bool fin,
         ConstBufferSequence const& buffers, WriteHandler&& handler);
 
+    /** Write a prepared message to the stream.
+
+        This function is used to synchronously write a message
+        prepared ahead of time to the stream. The call blocks until
+        one of the following conditions is met:
+
+        @li The entire message is sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls to the
+        next layer's `write_some` function.
+
+        The message is sent in a single frame with the opcode it was
+        prepared with, regardless of the @ref message_type and
+        @ref auto_fragment options. The compressed payload is sent if
+        the message holds one and the permessage-deflate extension was
+        negotiated with a large enough server window, in which case
+        the next message compressed by the stream starts with an empty
+        window.
+
+        @param msg The message to send. A copy of the object is kept
+        until the call returns.
+
+        @throws system_error Thrown on failure.
+
+        @note The stream must not be in the middle of sending a
+        message with @ref write_frame.
+    */
+    void
+    write_prepared(prepared_message const& msg);
+
+    /** Write a prepared message to the stream.
+
+        This function is used to synchronously write a message
+        prepared ahead of time to the stream. The call blocks until
+        one of the following conditions is met:
+
+        @li The entire message is sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls to the
+        next layer's `write_some` function.
+
+        The message is sent in a single frame with the opcode it was
+        prepared with, regardless of the @ref message_type and
+        @ref auto_fragment options. The compressed payload is sent if
+        the message holds one and the permessage-deflate extension was
+        negotiated with a large enough server window, in which case
+        the next message compressed by the stream starts with an empty
+        window.
+
+        @param msg The message to send.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @note The stream must not be in the middle of sending a
+        message with @ref write_frame.
+    */
+    void
+    write_prepared(prepared_message const& msg, error_code& ec);
+
+    /** Start an asynchronous operation to write a prepared message to the stream.
+
+        This function is used to asynchronously write a message
+        prepared ahead of time to the stream. The function call always
+        returns immediately. The asynchronous operation will continue
+        until one of the following conditions is true:
+
+        @li The entire message is sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls
+        to the next layer's `async_write_some` functions, and is known
+        as a <em>composed operation</em>. The program must ensure that
+        the stream performs no other write operations (such as
+        stream::async_write, stream::async_write_frame, or
+        stream::async_close).
+
+        The message is sent in a single frame with the opcode it was
+        prepared with, regardless of the @ref message_type and
+        @ref auto_fragment options. The compressed payload is sent if
+        the message holds one and the permessage-deflate extension was
+        negotiated with a large enough server window, in which case
+        the next message compressed by the stream starts with an empty
+        window.
+
+        @param msg The message to send. The operation holds a copy of
+        the object, which shares the buffer of the message, until the
+        handler is called.
+
+        @param handler The handler to be called when the write operation
+        completes. Copies will be made of the handler as required. The
+        function signature of the handler must be:
+        @code
+        void handler(
+            error_code const& error     // Result of operation
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `boost::asio::io_service::post`.
+    */
+    template<class WriteHandler>
+#if GENERATING_DOCS
+    void_or_deduced
+#else
+    typename async_completion<
+        WriteHandler, void(error_code)>::result_type
+#endif
+    async_write_prepared(prepared_message const& msg,
+        WriteHandler&& handler);
+
 private:
     template<class Handler> class accept_op;
     template<class Handler> class close_op;
@@ -1667,12 +1784,16 @@ private:
     template<class Handler> class response_op;
     template<class Buffers, class Handler> class write_op;
     template<class Buffers, class Handler> class write_frame_op;
+    template<class Handler> class write_prepared_op;
     template<class DynamicBuffer, class Handler> class read_op;
     template<class DynamicBuffer, class Handler> class read_frame_op;
 
     void
     reset();
 
+    prepared_message::frame const&
+    prepared_frame(prepared_message const& msg);
+
     http::request<http::empty_body>
     build_request(boost::string_ref const& host,
         boost::string_ref const& resource,
@@ -313,6 +313,30 @@ public:
         doParams(zs, level, strategy, ec);
     }
 
+    /** Set the preset dictionary.
+
+        The dictionary is history which matches in the data that
+        follows may refer to, as if it had been compressed just
+        before it. Only the last window's worth of the dictionary
+        is used. A decompressor must be given the same history,
+        for example by decompressing the preceding data with the
+        same stream. This function must be called after a reset
+        and before the first call to `write`.
+
+        @param dict A pointer to the dictionary.
+
+        @param size The size of the dictionary in bytes.
+
+        @param ec Set to `error::stream_error` if the stream
+        has already been written to.
+    */
+    void
+    dictionary(void const* dict, std::size_t size, error_code& ec)
+    {
+        doDictionary(static_cast<Byte const*>(dict),
+            static_cast<uInt>(size), ec);
+    }
+
     /** Return bits pending in the output.
 
         This function returns the number of bytes and bits of output
@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_ZLIB_DETAIL_ADLER32_HPP
+#define BEAST_ZLIB_DETAIL_ADLER32_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace beast {
+namespace zlib {
+namespace detail {
+
+/** Update a running Adler-32 checksum with a buffer.
+
+    Start with an adler of one. The result is the same as zlib's
+    `adler32`.
+*/
+inline
+std::uint32_t
+adler32(std::uint32_t adler, void const* data, std::size_t size)
+{
+    // largest prime smaller than 65536
+    std::uint32_t constexpr base = 65521;
+    // largest n such that 255n(n+1)/2 + (n+1)(base-1) <= 2^32-1
+    std::size_t constexpr nmax = 5552;
+
+    auto p = static_cast<std::uint8_t const*>(data);
+    std::uint32_t a = adler & 0xffff;
+    std::uint32_t b = adler >> 16;
+    while(size > 0)
+    {
+        auto n = size < nmax ? size : nmax;
+        size -= n;
+        while(n--)
+        {
+            a += *p++;
+            b += a;
+        }
+        a %= base;
+        b %= base;
+    }
+    return (b << 16) | a;
+}
+
+/** Combine the Adler-32s of two adjacent buffers.
+
+    Returns the checksum of the concatenation, given the checksum
+    of the first buffer, and the checksum and size of the second
+    buffer. The result is the same as zlib's `adler32_combine`.
+*/
+inline
+std::uint32_t
+adler32_combine(std::uint32_t adler1,
+    std::uint32_t adler2, std::uint64_t len2)
+{
+    std::uint32_t constexpr base = 65521;
+    auto const rem = static_cast<std::uint32_t>(len2 % base);
+    std::uint32_t sum1 = adler1 & 0xffff;
+    std::uint32_t sum2 = static_cast<std::uint32_t>(
+        (std::uint64_t{rem} * sum1) % base);
+    sum1 += (adler2 & 0xffff) + base - 1;
+    sum2 += (adler1 >> 16) + (adler2 >> 16) + base - rem;
+    if(sum1 >= base)
+        sum1 -= base;
+    if(sum1 >= base)
+        sum1 -= base;
+    if(sum2 >= 2 * base)
+        sum2 -= 2 * base;
+    if(sum2 >= base)
+        sum2 -= base;
+    return sum1 | (sum2 << 16);
+}
+
+} // detail
+} // zlib
+} // beast
+
+#endif
@@ -36,16 +36,24 @@
 #define BEAST_ZLIB_DETAIL_BITSTREAM_HPP
 
 #include <boost/assert.hpp>
+#include <boost/endian/conversion.hpp>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 
 namespace beast {
 namespace zlib {
 namespace detail {
 
+/*  Bit reservoir, filled from the low end.
+
+    fill_56 may leave bits of a partially loaded byte above size();
+    they are the same bits the next load would bring in, and rewind
+    clears them.
+*/
 class bitstream
 {
-    using value_type = std::uint32_t;
+    using value_type = std::uint64_t;
 
     value_type v_ = 0;
     unsigned n_ = 0;
@@ -87,15 +95,10 @@ public:
     bool
     fill(std::size_t n, FwdIt& first, FwdIt const& last);
 
-    // fill 8 bits, unchecked
-    template<class FwdIt>
+    // fill at least 56 bits with one load of
+    // 8 bytes, unchecked
     void
-    fill_8(FwdIt& it);
-
-    // fill 16 bits, unchecked
-    template<class FwdIt>
-    void
-    fill_16(FwdIt& it);
+    fill_56(std::uint8_t const*& it);
 
     // return n bits
     template<class Unsigned>
@@ -114,10 +117,11 @@ public:
     void
     read(Unsigned& value, std::size_t n);
 
-    // rewind by the number of whole bytes stored (unchecked)
+    // rewind by the number of whole bytes stored,
+    // but no more than limit bytes (unchecked)
     template<class BidirIt>
     void
-    rewind(BidirIt& it);
+    rewind(BidirIt& it, std::size_t limit);
 };
 
 template<class FwdIt>
@@ -136,26 +140,17 @@ fill(std::size_t n, FwdIt& first, FwdIt const& last)
     return true;
 }
 
-template<class FwdIt>
-inline
-void
-bitstream::
-fill_8(FwdIt& it)
-{
-    v_ += static_cast<value_type>(*it++) << n_;
-    n_ += 8;
-}
-
-template<class FwdIt>
 inline
 void
 bitstream::
-fill_16(FwdIt& it)
+fill_56(std::uint8_t const*& it)
 {
-    v_ += static_cast<value_type>(*it++) << n_;
-    n_ += 8;
-    v_ += static_cast<value_type>(*it++) << n_;
-    n_ += 8;
+    BOOST_ASSERT(n_ < 64);
+    value_type v;
+    std::memcpy(&v, it, sizeof(v));
+    v_ |= boost::endian::little_to_native(v) << n_;
+    it += (63 - n_) >> 3;
+    n_ |= 56;
 }
 
 template<class Unsigned>
@@ -188,12 +183,14 @@ template<class BidirIt>
 inline
 void
 bitstream::
-rewind(BidirIt& it)
+rewind(BidirIt& it, std::size_t limit)
 {
-    auto len = n_ >> 3;
+    std::size_t len = n_ >> 3;
+    if(len > limit)
+        len = limit;
     it = std::prev(it, len);
-    n_ &= 7;
-    v_ &= (1U << n_) - 1;
+    n_ -= static_cast<unsigned>(len * 8);
+    v_ &= (value_type{1} << n_) - 1;
 }
 
 } // detail
@@ -0,0 +1,159 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_ZLIB_DETAIL_CRC32_HPP
+#define BEAST_ZLIB_DETAIL_CRC32_HPP
+
+#include <boost/endian/conversion.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace beast {
+namespace zlib {
+namespace detail {
+
+/*  Tables for the CRC-32 used by gzip (ISO 3309, reflected polynomial
+    0xedb88320), for processing eight bytes at a time.
+
+    t[0] is the usual byte table. t[k][n] is the CRC of byte n
+    followed by k zero bytes, so eight bytes can be folded in with
+    eight independent lookups ("slicing-by-8").
+*/
+struct crc32_tables
+{
+    std::uint32_t t[8][256];
+
+    crc32_tables()
+    {
+        for(std::uint32_t n = 0; n < 256; ++n)
+        {
+            auto c = n;
+            for(int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            t[0][n] = c;
+        }
+        for(std::uint32_t n = 0; n < 256; ++n)
+            for(int k = 1; k < 8; ++k)
+                t[k][n] = (t[k-1][n] >> 8) ^ t[0][t[k-1][n] & 0xff];
+    }
+};
+
+template<class = void>
+crc32_tables const&
+get_crc32_tables()
+{
+    static crc32_tables const tables;
+    return tables;
+}
+
+/** Update a running CRC-32 with a buffer.
+
+    Start with a crc of zero. The result is the same as zlib's
+    `crc32`.
+*/
+inline
+std::uint32_t
+crc32(std::uint32_t crc, void const* data, std::size_t size)
+{
+    auto const& t = get_crc32_tables().t;
+    auto p = static_cast<std::uint8_t const*>(data);
+    crc = ~crc;
+    while(size >= 8)
+    {
+        std::uint32_t a;
+        std::uint32_t b;
+        std::memcpy(&a, p, 4);
+        std::memcpy(&b, p + 4, 4);
+        a = boost::endian::little_to_native(a) ^ crc;
+        b = boost::endian::little_to_native(b);
+        crc =
+            t[7][ a        & 0xff] ^ t[6][(a >>  8) & 0xff] ^
+            t[5][(a >> 16) & 0xff] ^ t[4][ a >> 24        ] ^
+            t[3][ b        & 0xff] ^ t[2][(b >>  8) & 0xff] ^
+            t[1][(b >> 16) & 0xff] ^ t[0][ b >> 24        ];
+        p += 8;
+        size -= 8;
+    }
+    while(size--)
+        crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Multiply a vector by a matrix over GF(2)
+inline
+std::uint32_t
+gf2_matrix_times(std::uint32_t const* mat, std::uint32_t vec)
+{
+    std::uint32_t sum = 0;
+    while(vec)
+    {
+        if(vec & 1)
+            sum ^= *mat;
+        vec >>= 1;
+        ++mat;
+    }
+    return sum;
+}
+
+inline
+void
+gf2_matrix_square(std::uint32_t* square, std::uint32_t const* mat)
+{
+    for(int n = 0; n < 32; ++n)
+        square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+/** Combine the CRC-32s of two adjacent buffers.
+
+    Returns the CRC of the concatenation, given the CRC of the
+    first buffer, and the CRC and size of the second buffer.
+    The result is the same as zlib's `crc32_combine`.
+*/
+inline
+std::uint32_t
+crc32_combine(std::uint32_t crc1,
+    std::uint32_t crc2, std::uint64_t len2)
+{
+    if(len2 == 0)
+        return crc1;
+    // Apply len2 zero bytes to crc1, the operator
+    // for one zero bit is squared for each bit of len2.
+    std::uint32_t even[32];
+    std::uint32_t odd[32];
+    odd[0] = 0xedb88320;
+    std::uint32_t row = 1;
+    for(int n = 1; n < 32; ++n)
+    {
+        odd[n] = row;
+        row <<= 1;
+    }
+    gf2_matrix_square(even, odd);   // two zero bits
+    gf2_matrix_square(odd, even);   // four zero bits
+    for(;;)
+    {
+        gf2_matrix_square(even, odd);
+        if(len2 & 1)
+            crc1 = gf2_matrix_times(even, crc1);
+        len2 >>= 1;
+        if(len2 == 0)
+            break;
+        gf2_matrix_square(odd, even);
+        if(len2 & 1)
+            crc1 = gf2_matrix_times(odd, crc1);
+        len2 >>= 1;
+        if(len2 == 0)
+            break;
+    }
+    return crc1 ^ crc2;
+}
+
+} // detail
+} // zlib
+} // beast
+
+#endif
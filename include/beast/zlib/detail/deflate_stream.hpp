@@ -37,8 +37,11 @@
 
 #include <beast/zlib/zlib.hpp>
 #include <beast/zlib/detail/ranges.hpp>
+#include <beast/core/detail/cpu_info.hpp>
+#include <beast/core/detail/ctz.hpp>
 #include <beast/core/detail/type_traits.hpp>
 #include <boost/assert.hpp>
+#include <boost/endian/conversion.hpp>
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <cstdlib>
@@ -47,6 +50,21 @@
 #include <stdexcept>
 #include <type_traits>
 
+/*  The match finder hashes strings with the CRC32C instruction
+    when the compiler targets SSE4.2. It is not chosen at run time
+    like the other vectorized paths: the hash is computed for nearly
+    every input byte, and a call into a function compiled for SSE4.2
+    costs more than the better hash saves.
+*/
+#ifndef BEAST_ZLIB_CRC_HASH
+# if BEAST_DETAIL_X86 && (defined(__SSE4_2__) || \
+    (defined(_MSC_VER) && defined(__AVX__)))
+#  define BEAST_ZLIB_CRC_HASH 1
+# else
+#  define BEAST_ZLIB_CRC_HASH 0
+# endif
+#endif
+
 namespace beast {
 namespace zlib {
 namespace detail {
@@ -317,12 +335,16 @@ protected:
         wSize-maxMatch bytes, but this ensures that IO is always
         performed with a length multiple of the block size. Also, it limits
         the window size to 64K.
-        To do: use the user input buffer as sliding window.
+        When the whole input and enough output space are supplied in one
+        call with Flush::finish, the window points into the user input
+        buffer instead, and slides by moving the pointer (see doWrite).
     */
     Byte *window_ = nullptr;
 
-    /*  Actual size of window: 2*wSize, except when the user input buffer
-        is directly used as sliding window.
+    // true while window_ points into the user input buffer
+    bool direct_ = false;
+
+    /*  Actual size of window: 2*wSize.
     */
     std::uint32_t window_size_;
 
@@ -334,13 +356,12 @@ protected:
 
     std::uint16_t* head_;           // Heads of the hash chains or 0
 
-    uInt  ins_h_;                   // hash index of string to be inserted
     uInt  hash_size_;               // number of elements in hash table
     uInt  hash_bits_;               // log2(hash_size)
     uInt  hash_mask_;               // hash_size-1
 
-    /*  Number of bits by which ins_h must be shifted at each input
-        step. It must be such that after minMatch steps,
+    /*  Number of bits by which each byte is shifted in the
+        zlib hash. It must be such that after minMatch steps,
         the oldest byte no longer takes part in the hash key, that is:
         hash_shift * minMatch >= hash_bits
     */
@@ -534,16 +555,25 @@ protected:
         return lut_.dist_code[256+(dist>>7)];
     }
 
-    /*  Update a hash value with the given input byte
-        IN  assertion: all calls to to update_hash are made with
-            consecutive input characters, so that a running hash
-            key can be computed from the previous key instead of
-            complete recalculation each time.
+    /*  Return the hash of the minMatch bytes at p
+
+        With BEAST_ZLIB_CRC_HASH this is the CRC32C of the bytes,
+        which spreads similar strings over the table better than
+        the shift and xor of zlib. Strings with the same hash may
+        differ in any byte, longest_match compares them all.
     */
-    void
-    update_hash(uInt& h, std::uint8_t c)
-    {
-        h = ((h << hash_shift_) ^ c) & hash_mask_;
+    uInt
+    hash(Byte const* p) const
+    {
+#if BEAST_ZLIB_CRC_HASH
+        return _mm_crc32_u32(0, p[0] |
+            (static_cast<std::uint32_t>(p[1]) << 8) |
+            (static_cast<std::uint32_t>(p[2]) << 16)) &
+                hash_mask_;
+#else
+        return ((((static_cast<uInt>(p[0]) << hash_shift_) ^
+            p[1]) << hash_shift_) ^ p[2]) & hash_mask_;
+#endif
     }
 
     /*  Initialize the hash table (avoiding 64K overflow for 16
@@ -582,9 +612,35 @@ protected:
     void
     insert_string(IPos& hash_head)
     {
-        update_hash(ins_h_, window_[strstart_ + (minMatch-1)]);
-        hash_head = prev_[strstart_ & w_mask_] = head_[ins_h_];
-        head_[ins_h_] = (std::uint16_t)strstart_;
+        auto const h = hash(window_ + strstart_);
+        hash_head = prev_[strstart_ & w_mask_] = head_[h];
+        head_[h] = (std::uint16_t)strstart_;
+    }
+
+    /*  Compare scan with match a word at a time, returning the first
+        position in scan which differs, or a position at or after strend
+        if every word before it matched. Whole words are read, so
+        strend - scan should be a multiple of eight.
+    */
+    static
+    Byte const*
+    compare(Byte const* scan, Byte const* match, Byte const* strend)
+    {
+        for(;;)
+        {
+            std::uint64_t a;
+            std::uint64_t b;
+            std::memcpy(&a, scan, 8);
+            std::memcpy(&b, match, 8);
+            auto const d =
+                boost::endian::native_to_little(a ^ b);
+            if(d != 0)
+                return scan + beast::detail::ctz(d) / 8;
+            scan += 8;
+            match += 8;
+            if(scan >= strend)
+                return scan;
+        }
     }
 
     //--------------------------------------------------------------------------
@@ -625,8 +681,8 @@ protected:
         {
         //              good lazy nice chain
         case 0: return {  0,   0,   0,    0, &self::deflate_stored}; // store only
-        case 1: return {  4,   4,   8,    4, &self::deflate_fast};   // max speed, no lazy matches
-        case 2: return {  4,   5,  16,    8, &self::deflate_fast};
+        case 1: return {  4,   4,   8,    1, &self::deflate_quick};  // max speed, one probe, static trees
+        case 2: return {  4,   5,  16,    8, &self::deflate_fast};   // no lazy matches
         case 3: return {  4,   6,  32,   32, &self::deflate_fast};
         case 4: return {  4,   4,  16,   16, &self::deflate_slow};   // lazy matches
         case 5: return {  8,  16,  32,   32, &self::deflate_slow};
@@ -693,15 +749,19 @@ protected:
     template<class = void> void tr_stored_block     (char *bu, std::uint32_t stored_len, int last);
     template<class = void> void tr_tally_dist       (std::uint16_t dist, std::uint8_t len, bool& flush);
     template<class = void> void tr_tally_lit        (std::uint8_t c, bool& flush);
+    template<class = void> std::uint32_t tr_static_len();
 
     template<class = void> void tr_flush_block      (z_params& zs, char *buf, std::uint32_t stored_len, int last);
     template<class = void> void fill_window         (z_params& zs);
     template<class = void> void flush_pending       (z_params& zs);
     template<class = void> void flush_block         (z_params& zs, bool last);
     template<class = void> int  read_buf            (z_params& zs, Byte *buf, unsigned size);
+    template<class = void> int  read_direct         (z_params& zs, unsigned size);
+    template<class = void> void own_window          ();
     template<class = void> uInt longest_match       (IPos cur_match);
 
     template<class = void> block_state f_stored     (z_params& zs, Flush flush);
+    template<class = void> block_state f_quick      (z_params& zs, Flush flush);
     template<class = void> block_state f_fast       (z_params& zs, Flush flush);
     template<class = void> block_state f_slow       (z_params& zs, Flush flush);
     template<class = void> block_state f_rle        (z_params& zs, Flush flush);
@@ -713,12 +773,27 @@ protected:
         return f_stored(zs, flush);
     }
 
+    block_state
+    deflate_quick(z_params& zs, Flush flush)
+    {
+        return f_quick(zs, flush);
+    }
+
     block_state
     deflate_fast(z_params& zs, Flush flush)
     {
         return f_fast(zs, flush);
     }
 
+    // true if blocks are produced by deflate_quick
+    bool
+    quick() const
+    {
+        return get_config(level_).func == &self::deflate_quick &&
+            strategy_ != Strategy::huffman &&
+            strategy_ != Strategy::rle;
+    }
+
     block_state
     deflate_slow(z_params& zs, Flush flush)
     {
@@ -1075,6 +1150,19 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
     {
         block_state bstate;
 
+        /*  If this call is certain to compress everything, the input
+            buffer can serve as the window, saving the copy into it.
+        */
+        if( flush == Flush::finish &&
+            strstart_ == 0 && lookahead_ == 0 && block_start_ == 0 &&
+            zs.avail_in > kMinLookahead &&
+            zs.avail_out >= doUpperBound(zs.avail_in))
+        {
+            window_ = const_cast<Byte*>(
+                static_cast<Byte const*>(zs.next_in));
+            direct_ = true;
+        }
+
         switch(strategy_)
         {
         case Strategy::huffman:
@@ -1090,6 +1178,10 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
         }
         }
 
+        // The window must not refer to the input after returning
+        if(direct_)
+            own_window();
+
         if(bstate == finish_started || bstate == finish_done)
         {
             status_ = FINISH_STATE;
@@ -1155,14 +1247,14 @@ void
 deflate_stream::
 doDictionary(Byte const* dict, uInt dictLength, error_code& ec)
 {
+    maybe_init();
+
     if(lookahead_)
     {
         ec = error::stream_error;
         return;
     }
 
-    maybe_init();
-
     /* if dict would fill window, just replace the history */
     if(dictLength >= w_size_)
     {
@@ -1187,9 +1279,9 @@ doDictionary(Byte const* dict, uInt dictLength, error_code& ec)
         uInt n = lookahead_ - (minMatch-1);
         do
         {
-            update_hash(ins_h_, window_[str + minMatch-1]);
-            prev_[str & w_mask_] = head_[ins_h_];
-            head_[ins_h_] = (std::uint16_t)str;
+            auto const h = hash(window_ + str);
+            prev_[str & w_mask_] = head_[h];
+            head_[h] = (std::uint16_t)str;
             str++;
         }
         while(--n);
@@ -1337,7 +1429,6 @@ lm_init()
     insert_ = 0;
     match_length_ = prev_length_ = minMatch-1;
     match_available_ = 0;
-    ins_h_ = 0;
 }
 
 // Initialize a new block.
@@ -2060,6 +2151,26 @@ tr_tally_lit(std::uint8_t c, bool& flush)
     flush = (last_lit_ == lit_bufsize_-1);
 }
 
+/*  Return the bit length of the current block with static trees,
+    computed from the symbol frequencies without building any trees.
+*/
+template<class>
+std::uint32_t
+deflate_stream::
+tr_static_len()
+{
+    std::uint32_t len = 0;
+    for(int n = 0; n <= END_BLOCK; ++n)
+        len += (std::uint32_t)dyn_ltree_[n].fc * lut_.ltree[n].dl;
+    for(int n = 0; n < lengthCodes; ++n)
+        len += (std::uint32_t)dyn_ltree_[END_BLOCK+1+n].fc *
+            (lut_.ltree[END_BLOCK+1+n].dl + lut_.extra_lbits[n]);
+    for(int n = 0; n < dCodes; ++n)
+        len += (std::uint32_t)dyn_dtree_[n].fc *
+            (lut_.dtree[n].dl + lut_.extra_dbits[n]);
+    return len;
+}
+
 //------------------------------------------------------------------------------
 
 /*  Determine the best encoding for the current block: dynamic trees,
@@ -2078,8 +2189,16 @@ tr_flush_block(
     std::uint32_t static_lenb;  // opt_len and static_len in bytes
     int max_blindex = 0;        // index of last bit length code of non zero freq
 
+    if(level_ > 0 && quick())
+    {
+        // Static trees, or a stored block if that is smaller
+        if(zs.data_type == Z_UNKNOWN)
+            zs.data_type = detect_data_type();
+        static_lenb = (tr_static_len()+3+7)>>3;
+        opt_lenb = static_lenb;
+    }
     // Build the Huffman trees unless a stored block is forced
-    if(level_ > 0)
+    else if(level_ > 0)
     {
         // Check if the file is binary or text
         if(zs.data_type == Z_UNKNOWN)
@@ -2200,7 +2319,10 @@ fill_window(z_params& zs)
         */
         if(strstart_ >= wsize+max_dist())
         {
-            std::memcpy(window_, window_+wsize, (unsigned)wsize);
+            if(direct_)
+                window_ += wsize;
+            else
+                std::memcpy(window_, window_+wsize, (unsigned)wsize);
             match_start_ -= wsize;
             strstart_    -= wsize; // we now have strstart >= max_dist
             block_start_ -= (long) wsize;
@@ -2247,29 +2369,34 @@ fill_window(z_params& zs)
             Otherwise, window_size == 2*WSIZE so more >= 2.
             If there was sliding, more >= WSIZE. So in all cases, more >= 2.
         */
-        n = read_buf(zs, window_ + strstart_ + lookahead_, more);
+        /*  When the window is the input buffer, the match routines could
+            read up to maxMatch bytes past the lookahead, so kMinLookahead
+            bytes are held back; they are copied with the rest of the
+            window into the internal one when nothing else remains.
+        */
+        if(direct_ && zs.avail_in <= kMinLookahead)
+            own_window();
+        if(direct_)
+            n = read_direct(zs, clamp(more, zs.avail_in - kMinLookahead));
+        else
+            n = read_buf(zs, window_ + strstart_ + lookahead_, more);
         lookahead_ += n;
 
         // Initialize the hash value now that we have some input:
         if(lookahead_ + insert_ >= minMatch)
         {
             uInt str = strstart_ - insert_;
-            ins_h_ = window_[str];
-            update_hash(ins_h_, window_[str + 1]);
             while(insert_)
             {
-                update_hash(ins_h_, window_[str + minMatch-1]);
-                prev_[str & w_mask_] = head_[ins_h_];
-                head_[ins_h_] = (std::uint16_t)str;
+                auto const h = hash(window_ + str);
+                prev_[str & w_mask_] = head_[h];
+                head_[h] = (std::uint16_t)str;
                 str++;
                 insert_--;
                 if(lookahead_ + insert_ < minMatch)
                     break;
             }
         }
-        /*  If the whole input has less than minMatch bytes, ins_h is garbage,
-            but this is not important since only literal bytes will be emitted.
-        */
     }
     while(lookahead_ < kMinLookahead && zs.avail_in != 0);
 
@@ -2280,7 +2407,7 @@ fill_window(z_params& zs)
         time through here.  kWinInit is set to maxMatch since the longest match
         routines allow scanning to strstart + maxMatch, ignoring lookahead.
     */
-    if(high_water_ < window_size_)
+    if(! direct_ && high_water_ < window_size_)
     {
         std::uint32_t curr = strstart_ + (std::uint32_t)(lookahead_);
         std::uint32_t init;
@@ -2380,6 +2507,40 @@ read_buf(z_params& zs, Byte *buf, unsigned size)
     return (int)len;
 }
 
+/*  Consume input which the window already covers, because the window
+    is the user input buffer.
+*/
+template<class>
+int
+deflate_stream::
+read_direct(z_params& zs, unsigned size)
+{
+    BOOST_ASSERT(window_ + strstart_ + lookahead_ == zs.next_in);
+    auto len = clamp(zs.avail_in, size);
+    zs.avail_in  -= len;
+    zs.next_in = static_cast<
+        std::uint8_t const*>(zs.next_in) + len;
+    zs.total_in += len;
+    return (int)len;
+}
+
+/*  Go back to the internal window, copying what the window holds so
+    that positions do not change.
+*/
+template<class>
+void
+deflate_stream::
+own_window()
+{
+    auto const p = reinterpret_cast<Byte*>(buf_.get());
+    auto const n = strstart_ + lookahead_;
+    BOOST_ASSERT(n <= window_size_);
+    std::memcpy(p, window_, n);
+    window_ = p;
+    direct_ = false;
+    high_water_ = n;
+}
+
 /*  Set match_start to the longest match starting at the given string and
     return its length. Matches shorter or equal to prev_length are discarded,
     in which case the result is equal to prev_length and match_start is
@@ -2397,8 +2558,8 @@ deflate_stream::
 longest_match(IPos cur_match)
 {
     unsigned chain_length = max_chain_length_;/* max hash chain length */
-    Byte *scan = window_ + strstart_; /* current string */
-    Byte *match;                       /* matched string */
+    Byte const* scan = window_ + strstart_; /* current string */
+    Byte const* match;                 /* matched string */
     int len;                           /* length of current match */
     int best_len = prev_length_;              /* best match length so far */
     int nice_match = nice_match_;             /* stop if match long enough */
@@ -2410,7 +2571,7 @@ longest_match(IPos cur_match)
     std::uint16_t *prev = prev_;
     uInt wmask = w_mask_;
 
-    Byte *strend = window_ + strstart_ + maxMatch;
+    Byte const* strend = window_ + strstart_ + maxMatch;
     Byte scan_end1  = scan[best_len-1];
     Byte scan_end   = scan[best_len];
 
@@ -2449,26 +2610,11 @@ longest_match(IPos cur_match)
                 *++match          != scan[1])
             continue;
 
-        /* The check at best_len-1 can be removed because it will be made
-         * again later. (This heuristic is not always a win.)
-         * It is not necessary to compare scan[2] and match[2] since they
-         * are always equal when the other bytes match, given that
-         * the hash keys are equal and that HASH_BITS >= 8.
+        /* Compare the rest starting at scan[2], since the hash
+         * does not guarantee that it matches. The 32 words end
+         * exactly at strstart+258.
          */
-        scan += 2, match++;
-        BOOST_ASSERT(*scan == *match);
-
-        /* We check for insufficient lookahead only every 8th comparison;
-         * the 256th check will be made at strstart+258.
-         */
-        do
-        {
-        }
-        while(  *++scan == *++match && *++scan == *++match &&
-                *++scan == *++match && *++scan == *++match &&
-                *++scan == *++match && *++scan == *++match &&
-                *++scan == *++match && *++scan == *++match &&
-                scan < strend);
+        scan = compare(scan + 2, match + 1, strend);
 
         BOOST_ASSERT(scan <= window_+(unsigned)(window_size_-1));
 
@@ -2652,11 +2798,6 @@ f_fast(z_params& zs, Flush flush) ->
             {
                 strstart_ += match_length_;
                 match_length_ = 0;
-                ins_h_ = window_[strstart_];
-                update_hash(ins_h_, window_[strstart_+1]);
-                /* If lookahead < minMatch, ins_h is garbage, but it does not
-                 * matter since it will be recomputed at next deflate call.
-                 */
             }
         }
         else
@@ -2690,6 +2831,98 @@ f_fast(z_params& zs, Flush flush) ->
     return block_done;
 }
 
+/*  Compress as much as possible from the input stream, return the current
+    block state.
+    This function looks for a match only at the head of the hash chain,
+    inserts strings only at positions where a literal or a match starts,
+    and its blocks are always sent with the static trees (or stored), so
+    no trees are built. It is used only for compression level 1.
+*/
+template<class>
+inline
+auto
+deflate_stream::
+f_quick(z_params& zs, Flush flush) ->
+    block_state
+{
+    IPos hash_head;       /* head of the hash chain */
+    bool bflush;           /* set if current block must be flushed */
+
+    for(;;)
+    {
+        /* Make sure that we always have enough lookahead, except
+         * at the end of the input file. We need maxMatch bytes
+         * for the next match, plus minMatch bytes to insert the
+         * string following the next match.
+         */
+        if(lookahead_ < kMinLookahead)
+        {
+            fill_window(zs);
+            if(lookahead_ < kMinLookahead && flush == Flush::none)
+                return need_more;
+            if(lookahead_ == 0)
+                break; /* flush the current block */
+        }
+
+        hash_head = 0;
+        if(lookahead_ >= minMatch)
+            insert_string(hash_head);
+
+        /* Try the head of the chain only. Like longest_match, this
+         * reads up to maxMatch bytes past strstart, and then limits
+         * the length to the lookahead.
+         */
+        uInt len = 0;
+        if(hash_head != 0 && strstart_ - hash_head <= max_dist())
+        {
+            auto const scan = window_ + strstart_;
+            auto const match = window_ + hash_head;
+            if(scan[0] == match[0] && scan[1] == match[1])
+            {
+                len = static_cast<uInt>(compare(scan + 2,
+                    match + 2, scan + maxMatch) - scan);
+                if(len > lookahead_)
+                    len = lookahead_;
+            }
+        }
+        if(len >= minMatch)
+        {
+            tr_tally_dist(strstart_ - hash_head,
+                len - minMatch, bflush);
+            lookahead_ -= len;
+            strstart_ += len;
+        }
+        else
+        {
+            /* No match, output a literal byte */
+            tr_tally_lit(window_[strstart_], bflush);
+            lookahead_--;
+            strstart_++;
+        }
+        if(bflush)
+        {
+            flush_block(zs, false);
+            if(zs.avail_out == 0)
+                return need_more;
+        }
+    }
+    insert_ = strstart_ < minMatch-1 ? strstart_ : minMatch-1;
+    if(flush == Flush::finish)
+    {
+        flush_block(zs, true);
+        if(zs.avail_out == 0)
+            return finish_started;
+        return finish_done;
+    }
+    if(last_lit_)
+    {
+        flush_block(zs, false);
+        if(zs.avail_out == 0)
+            return need_more;
+    }
+    return block_done;
+}
+
 /*  Same as above, but achieves better compression. We use a lazy
     evaluation for matches: a match is finally adopted only if there is
     no better match at the next window position.
@@ -149,6 +149,11 @@ private:
     static std::uint16_t constexpr kEnoughDists = 592;
     static std::uint16_t constexpr kEnough = kEnoughLens + kEnoughDists;
 
+    // inflate_fast loads 8 input bytes at a time, and writes a
+    // match of up to 258 bytes in chunks of up to 16 bytes
+    static std::size_t constexpr kFastIn = 8;
+    static std::size_t constexpr kFastOut = 258 + 15;
+
     struct codes
     {
         code const* lencode;
@@ -541,7 +546,7 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
 
         case LEN:
         {
-            if(r.in.avail() >= 6 && r.out.avail() >= 258)
+            if(r.in.avail() >= kFastIn && r.out.avail() >= kFastOut)
             {
                 inflate_fast(r, ec);
                 if(ec)
@@ -1176,23 +1181,29 @@ inflate_fast(ranges& r, error_code& ec)
     unsigned const dmask =
         (1U << distbits_) - 1;  // mask for first level of distance codes
 
-    last = r.in.next + (r.in.avail() - 5);
-    end = r.out.next + (r.out.avail() - 257);
+    // Work on local copies, stores through out may alias members
+    auto bi = bi_;
+    auto const first = r.in.next;
+    auto in = r.in.next;
+    auto out = r.out.next;
+
+    last = r.in.last - (kFastIn - 1);
+    end = r.out.last - (kFastOut - 1);
 
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
-    do
+    while(in < last && out < end)
     {
-        if(bi_.size() < 15)
-            bi_.fill_16(r.in.next);
-        auto cp = &lencode_[bi_.peek_fast() & lmask];
+        // enough bits for a length/distance pair
+        bi.fill_56(in);
+        auto cp = &lencode_[bi.peek_fast() & lmask];
     dolen:
-        bi_.drop(cp->bits);
+        bi.drop(cp->bits);
         op = (unsigned)(cp->op);
         if(op == 0)
         {
             // literal
-            *r.out.next++ = (unsigned char)(cp->val);
+            *out++ = (unsigned char)(cp->val);
         }
         else if(op & 16)
         {
@@ -1201,29 +1212,19 @@ inflate_fast(ranges& r, error_code& ec)
             op &= 15; // number of extra bits
             if(op)
             {
-                if(bi_.size() < op)
-                    bi_.fill_8(r.in.next);
-                len += (unsigned)bi_.peek_fast() & ((1U << op) - 1);
-                bi_.drop(op);
+                len += (unsigned)bi.peek_fast() & ((1U << op) - 1);
+                bi.drop(op);
             }
-            if(bi_.size() < 15)
-                bi_.fill_16(r.in.next);
-            cp = &distcode_[bi_.peek_fast() & dmask];
+            cp = &distcode_[bi.peek_fast() & dmask];
         dodist:
-            bi_.drop(cp->bits);
+            bi.drop(cp->bits);
             op = (unsigned)(cp->op);
             if(op & 16)
             {
                 // distance base
                 dist = (unsigned)(cp->val);
                 op &= 15; // number of extra bits
-                if(bi_.size() < op)
-                {
-                    bi_.fill_8(r.in.next);
-                    if(bi_.size() < op)
-                        bi_.fill_8(r.in.next);
-                }
-                dist += (unsigned)bi_.peek_fast() & ((1U << op) - 1);
+                dist += (unsigned)bi.peek_fast() & ((1U << op) - 1);
 #ifdef INFLATE_STRICT
                 if(dist > dmax_)
                 {
@@ -1232,9 +1233,9 @@ inflate_fast(ranges& r, error_code& ec)
                     break;
                 }
 #endif
-                bi_.drop(op);
+                bi.drop(op);
 
-                op = r.out.used();
+                op = out - r.out.first;
                 if(dist > op)
                 {
                     // copy from window
@@ -1246,24 +1247,56 @@ inflate_fast(ranges& r, error_code& ec)
                         break;
                     }
                     auto const n = clamp(len, op);
-                    w_.read(r.out.next, op, n);
-                    r.out.next += n;
+                    w_.read(out, op, n);
+                    out += n;
                     len -= n;
                 }
                 if(len > 0)
                 {
-                    // copy from output
-                    auto in = r.out.next - dist;
-                    auto n = clamp(len, r.out.avail());
-                    len -= n;
-                    while(n--)
-                        *r.out.next++ = *in++;
+                    // copy from output, whole chunks at a time
+                    // when they do not overlap, which can write
+                    // up to 15 bytes past the match.
+                    auto from = out - dist;
+                    auto const to = out + len;
+                    if(dist >= 16)
+                    {
+                        do
+                        {
+                            std::memcpy(out, from, 16);
+                            out += 16;
+                            from += 16;
+                        }
+                        while(out < to);
+                    }
+                    else if(dist >= 8)
+                    {
+                        do
+                        {
+                            std::memcpy(out, from, 8);
+                            out += 8;
+                            from += 8;
+                        }
+                        while(out < to);
+                    }
+                    else if(dist == 1)
+                    {
+                        std::memset(out, *from, len);
+                    }
+                    else
+                    {
+                        do
+                        {
+                            *out++ = *from++;
+                        }
+                        while(out < to);
+                    }
+                    out = to;
                 }
             }
             else if((op & 64) == 0)
             {
                 // 2nd level distance code
-                cp = &distcode_[cp->val + (bi_.peek_fast() & ((1U << op) - 1))];
+                cp = &distcode_[cp->val + (bi.peek_fast() & ((1U << op) - 1))];
                 goto dodist;
             }
             else
@@ -1276,7 +1309,7 @@ inflate_fast(ranges& r, error_code& ec)
         else if((op & 64) == 0)
         {
             // 2nd level length code
-            cp = &lencode_[cp->val + (bi_.peek_fast() & ((1U << op) - 1))];
+            cp = &lencode_[cp->val + (bi.peek_fast() & ((1U << op) - 1))];
             goto dolen;
         }
         else if(op & 32)
@@ -1292,10 +1325,12 @@ inflate_fast(ranges& r, error_code& ec)
             break;
         }
     }
-    while(r.in.next < last && r.out.next < end);
 
-    // return unused bytes (on entry, bits < 8, so in won't go too far back)
-    bi_.rewind(r.in.next);
+    // return unused bytes, keeping any bits held on entry
+    bi.rewind(in, in - first);
+    bi_ = bi;
+    r.in.next = in;
+    r.out.next = out;
 }
 
 } // detail
@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_ZLIB_IMPL_PARALLEL_DEFLATE_IPP
+#define BEAST_ZLIB_IMPL_PARALLEL_DEFLATE_IPP
+
+#include <beast/zlib/detail/adler32.hpp>
+#include <beast/zlib/detail/crc32.hpp>
+#include <boost/asio/buffer.hpp>
+#include <algorithm>
+#include <new>
+
+namespace beast {
+namespace zlib {
+
+inline
+parallel_deflate::
+parallel_deflate(std::size_t threads,
+        int level, std::size_t block_size)
+    : level_(level)
+    , block_size_(block_size > 0 ? block_size : default_block_size)
+    , next_(0)
+{
+    // Throws on a bad level
+    zo_.reset(level_, 15, 8, Strategy::normal);
+    if(threads == 0)
+        threads = (std::max)(1u, std::thread::hardware_concurrency());
+    threads_.reserve(threads - 1);
+    try
+    {
+        while(threads_.size() < threads - 1)
+            threads_.emplace_back([this]{ run(); });
+    }
+    catch(...)
+    {
+        stop();
+        throw;
+    }
+}
+
+inline
+parallel_deflate::
+~parallel_deflate()
+{
+    stop();
+}
+
+template<class DynamicBuffer>
+void
+parallel_deflate::
+compress(void const* data, std::size_t size,
+    DynamicBuffer& out, error_code& ec)
+{
+    using boost::asio::buffer;
+    using boost::asio::buffer_copy;
+    // Split the input
+    auto const p = static_cast<std::uint8_t const*>(data);
+    std::size_t const n = size > 0 ?
+        (size + block_size_ - 1) / block_size_ : 1;
+    blocks_.resize(n);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        auto& b = blocks_[i];
+        auto const offset = i * block_size_;
+        b.data = p + offset;
+        b.size = (std::min)(block_size_, size - offset);
+        b.dict = (std::min)(offset, std::size_t{32768});
+        b.last = i == n - 1;
+        b.ec = {};
+    }
+    // Compress the blocks
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        next_ = 0;
+        done_ = 0;
+        ++gen_;
+    }
+    cv_.notify_all();
+    work(zo_);
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        done_cv_.wait(lock,
+            [&]{ return done_ == threads_.size(); });
+    }
+    // Join the blocks
+    crc_ = 0;
+    adler_ = 1;
+    for(auto& b : blocks_)
+    {
+        if(b.ec)
+        {
+            ec = b.ec;
+            return;
+        }
+        out.commit(buffer_copy(out.prepare(b.out.size()),
+            buffer(b.out.data(), b.out.size())));
+        crc_ = detail::crc32_combine(crc_, b.crc, b.size);
+        adler_ = detail::adler32_combine(adler_, b.adler, b.size);
+    }
+}
+
+template<class DynamicBuffer>
+void
+parallel_deflate::
+compress(void const* data, std::size_t size,
+    DynamicBuffer& out)
+{
+    error_code ec;
+    compress(data, size, out, ec);
+    if(ec)
+        throw system_error{ec};
+}
+
+inline
+void
+parallel_deflate::
+stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for(auto& t : threads_)
+        t.join();
+    threads_.clear();
+}
+
+inline
+void
+parallel_deflate::
+run()
+{
+    deflate_stream zo;
+    std::size_t gen = 0;
+    std::unique_lock<std::mutex> lock(m_);
+    for(;;)
+    {
+        cv_.wait(lock,
+            [&]{ return stop_ || gen_ != gen; });
+        if(stop_)
+            break;
+        gen = gen_;
+        lock.unlock();
+        work(zo);
+        lock.lock();
+        if(++done_ == threads_.size())
+            done_cv_.notify_one();
+    }
+}
+
+inline
+void
+parallel_deflate::
+work(deflate_stream& zo)
+{
+    for(;;)
+    {
+        auto const i = next_++;
+        if(i >= blocks_.size())
+            break;
+        compress_block(zo, blocks_[i]);
+    }
+}
+
+inline
+void
+parallel_deflate::
+compress_block(deflate_stream& zo, block& b)
+{
+    b.crc = detail::crc32(0, b.data, b.size);
+    b.adler = detail::adler32(1, b.data, b.size);
+    try
+    {
+        zo.reset(level_, 15, 8, Strategy::normal);
+        if(b.dict > 0)
+        {
+            zo.dictionary(b.data - b.dict, b.dict, b.ec);
+            if(b.ec)
+                return;
+        }
+        // Room for the block and the sync marker
+        b.out.resize(zo.upper_bound(b.size) + 16);
+        z_params zs;
+        zs.next_in = b.data;
+        zs.avail_in = b.size;
+        zs.next_out = b.out.data();
+        zs.avail_out = b.out.size();
+        for(;;)
+        {
+            // Blocks other than the last end on a byte
+            // boundary, so they can be concatenated.
+            zo.write(zs, b.last ?
+                Flush::finish : Flush::sync, b.ec);
+            if(b.ec == error::end_of_stream)
+            {
+                b.ec = {};
+                break;
+            }
+            if(b.ec)
+                return;
+            if(! b.last && zs.avail_out > 0)
+                break;
+            auto const used = b.out.size();
+            b.out.resize(2 * used);
+            zs.next_out = b.out.data() + used;
+            zs.avail_out = b.out.size() - used;
+        }
+        b.out.resize(b.out.size() - zs.avail_out);
+    }
+    catch(std::bad_alloc const&)
+    {
+        b.ec = boost::system::errc::make_error_code(
+            boost::system::errc::not_enough_memory);
+    }
+}
+
+} // zlib
+} // beast
+
+#endif
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BEAST_ZLIB_PARALLEL_DEFLATE_HPP
+#define BEAST_ZLIB_PARALLEL_DEFLATE_HPP
+
+#include <beast/core/error.hpp>
+#include <beast/zlib/deflate_stream.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace beast {
+namespace zlib {
+
+/** Compress large buffers using several threads.
+
+    The input is split into blocks which are compressed
+    independently on a pool of threads, each block using the
+    32KB of input before it as a preset dictionary. The blocks
+    end on a byte boundary, and together they form one raw
+    deflate stream which any inflater accepts. Compared to
+    @ref deflate_stream at the same level, the output is larger
+    by a few bytes per block.
+
+    The CRC-32 and Adler-32 of the input are computed along with
+    the blocks, for use in gzip and zlib framing.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe.
+
+    @par Example
+    @code
+        parallel_deflate pd;
+        streambuf sb;
+        pd.compress(data.data(), data.size(), sb);
+    @endcode
+*/
+class parallel_deflate
+{
+    struct block
+    {
+        std::uint8_t const* data;
+        std::size_t size;
+        std::size_t dict;       // bytes of history before data
+        bool last;
+        std::vector<std::uint8_t> out;
+        std::uint32_t crc;
+        std::uint32_t adler;
+        error_code ec;
+    };
+
+    int level_;
+    std::size_t block_size_;
+    std::vector<std::thread> threads_;
+    std::mutex m_;
+    std::condition_variable cv_;        // wakes the workers
+    std::condition_variable done_cv_;   // wakes the caller
+    std::vector<block> blocks_;
+    std::atomic<std::size_t> next_;     // next block to compress
+    std::size_t gen_ = 0;               // incremented for each job
+    std::size_t done_ = 0;              // workers finished with the job
+    bool stop_ = false;
+    deflate_stream zo_;                 // used by the calling thread
+    std::uint32_t crc_ = 0;
+    std::uint32_t adler_ = 1;
+
+public:
+    /// The default size of the blocks compressed independently.
+    static std::size_t constexpr default_block_size = 128 * 1024;
+
+    /** Constructor.
+
+        @param threads The number of threads to use, including the
+        thread calling @ref compress. If zero, the number of hardware
+        threads is used.
+
+        @param level The compression level, from 0 to 9.
+
+        @param block_size The size of each block. Smaller blocks allow
+        more parallelism for small inputs, at a small cost in size.
+
+        @throws std::invalid_argument if the level is invalid.
+    */
+    explicit
+    parallel_deflate(std::size_t threads = 0,
+        int level = 6, std::size_t block_size = default_block_size);
+
+    /// Destructor. The threads are joined.
+    ~parallel_deflate();
+
+    parallel_deflate(parallel_deflate const&) = delete;
+    parallel_deflate& operator=(parallel_deflate const&) = delete;
+
+    /// Returns the number of threads used, including the caller.
+    std::size_t
+    threads() const
+    {
+        return threads_.size() + 1;
+    }
+
+    /** Compress a buffer into a complete raw deflate stream.
+
+        The compressed data is appended to `out`. The calling thread
+        compresses blocks along with the pool, and the function
+        returns when the stream is complete.
+
+        @param data A pointer to the input.
+
+        @param size The size of the input in bytes.
+
+        @param out The dynamic buffer to append the output to.
+
+        @param ec Set to the error, if any occurred.
+    */
+    template<class DynamicBuffer>
+    void
+    compress(void const* data, std::size_t size,
+        DynamicBuffer& out, error_code& ec);
+
+    /** Compress a buffer into a complete raw deflate stream.
+
+        The compressed data is appended to `out`.
+
+        @throws system_error Thrown on failure.
+    */
+    template<class DynamicBuffer>
+    void
+    compress(void const* data, std::size_t size,
+        DynamicBuffer& out);
+
+    /// Returns the CRC-32 of the input to the last call to @ref compress.
+    std::uint32_t
+    crc32() const
+    {
+        return crc_;
+    }
+
+    /// Returns the Adler-32 of the input to the last call to @ref compress.
+    std::uint32_t
+    adler32() const
+    {
+        return adler_;
+    }
+
+private:
+    void
+    stop();
+
+    void
+    run();
+
+    void
+    work(deflate_stream& zo);
+
+    void
+    compress_block(deflate_stream& zo, block& b);
+};
+
+} // zlib
+} // beast
+
+#include <beast/zlib/impl/parallel_deflate.ipp>
+
+#endif
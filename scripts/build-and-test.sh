@@ -68,7 +68,7 @@ function run_tests {
 
 function run_tests_with_valgrind {
   for x in bin/**/$VARIANT/**/*-tests; do
-    if [[ $(basename $x) == "bench-tests" ]]; then
+    if [[ $(basename $x) == *bench-tests ]]; then
       $x
     else
       # TODO --max-stackframe=8388608
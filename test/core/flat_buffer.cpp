@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/core/flat_buffer.hpp>
+
+#include <beast/core/buffer_concepts.hpp>
+#include <beast/core/to_string.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <boost/asio/buffer.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace beast {
+
+static_assert(is_DynamicBuffer<flat_buffer>::value, "");
+
+class flat_buffer_test : public beast::unit_test::suite
+{
+public:
+    template<class DynamicBuffer>
+    static
+    void
+    append(DynamicBuffer& b, std::string const& s)
+    {
+        using boost::asio::buffer;
+        using boost::asio::buffer_copy;
+        b.commit(buffer_copy(b.prepare(s.size()),
+            buffer(s.data(), s.size())));
+    }
+
+    void
+    testSpecialMembers()
+    {
+        flat_buffer b;
+        BEAST_EXPECT(b.size() == 0);
+        BEAST_EXPECT(b.capacity() == 0);
+        append(b, "Hello, world");
+        {
+            flat_buffer b2{b};
+            BEAST_EXPECT(to_string(b2.data()) == "Hello, world");
+            flat_buffer b3{std::move(b2)};
+            BEAST_EXPECT(to_string(b3.data()) == "Hello, world");
+            BEAST_EXPECT(b2.size() == 0);
+            BEAST_EXPECT(b2.capacity() == 0);
+        }
+        {
+            flat_buffer b2;
+            b2 = b;
+            BEAST_EXPECT(to_string(b2.data()) == "Hello, world");
+            flat_buffer b3;
+            append(b3, "x");
+            b3 = std::move(b2);
+            BEAST_EXPECT(to_string(b3.data()) == "Hello, world");
+            BEAST_EXPECT(b2.capacity() == 0);
+        }
+        {
+            basic_flat_buffer<std::allocator<double>> b2{b};
+            BEAST_EXPECT(to_string(b2.data()) == "Hello, world");
+        }
+        try
+        {
+            flat_buffer b2{0};
+            fail();
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testPrepare()
+    {
+        using boost::asio::buffer_cast;
+        using boost::asio::buffer_size;
+        flat_buffer b;
+        append(b, "0123456789");
+        BEAST_EXPECT(b.capacity() >= 10);
+        auto const cap = b.capacity();
+        auto const p = buffer_cast<char const*>(*b.data().begin());
+
+        // Moving the input to the front reuses the storage
+        b.consume(5);
+        b.prepare(cap - 5);
+        BEAST_EXPECT(b.capacity() == cap);
+        BEAST_EXPECT(buffer_cast<char const*>(
+            *b.data().begin()) == p);
+        BEAST_EXPECT(to_string(b.data()) == "56789");
+
+        // Growing keeps the input in one buffer
+        append(b, std::string(100, '*'));
+        BEAST_EXPECT(b.capacity() > cap);
+        {
+            auto const d = b.data();
+            BEAST_EXPECT(std::distance(d.begin(), d.end()) == 1);
+        }
+        BEAST_EXPECT(to_string(b.data()) ==
+            "56789" + std::string(100, '*'));
+
+        // Consuming everything reuses the storage
+        b.consume(b.size());
+        BEAST_EXPECT(b.size() == 0);
+        BEAST_EXPECT(buffer_size(b.prepare(b.capacity())) ==
+            b.capacity());
+
+        // Output prepared before consume stays valid
+        b.consume(0);
+        append(b, "abc");
+        auto const out = b.prepare(3);
+        b.consume(3);
+        boost::asio::buffer_copy(out, boost::asio::buffer("xyz", 3));
+        b.commit(3);
+        BEAST_EXPECT(to_string(b.data()) == "xyz");
+    }
+
+    void
+    testLimit()
+    {
+        flat_buffer b{10};
+        BEAST_EXPECT(b.max_size() == 10);
+        append(b, "0123456789");
+        BEAST_EXPECT(b.capacity() == 10);
+        try
+        {
+            b.prepare(1);
+            fail();
+        }
+        catch(std::length_error const&)
+        {
+            pass();
+        }
+        b.consume(4);
+        b.prepare(4);
+        BEAST_EXPECT(b.capacity() == 10);
+        try
+        {
+            b.prepare(5);
+            fail();
+        }
+        catch(std::length_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testShrink()
+    {
+        flat_buffer b;
+        append(b, std::string(1000, '*'));
+        b.consume(990);
+        b.shrink_to_fit();
+        BEAST_EXPECT(b.capacity() == 10);
+        BEAST_EXPECT(to_string(b.data()) == std::string(10, '*'));
+        b.consume(10);
+        b.shrink_to_fit();
+        BEAST_EXPECT(b.capacity() == 0);
+    }
+
+    void
+    testReadSize()
+    {
+        {
+            flat_buffer b;
+            BEAST_EXPECT(read_size_helper(b, 65536) == 512);
+            BEAST_EXPECT(read_size_helper(b, 100) == 100);
+            append(b, std::string(512, '*'));
+            BEAST_EXPECT(read_size_helper(b, 65536) == 512);
+            b.consume(12);
+            BEAST_EXPECT(read_size_helper(b, 65536) == 12);
+        }
+        {
+            flat_buffer b{100};
+            BEAST_EXPECT(read_size_helper(b, 65536) == 100);
+            append(b, std::string(100, '*'));
+            BEAST_EXPECT(read_size_helper(b, 65536) == 1);
+        }
+    }
+
+    void run() override
+    {
+        testSpecialMembers();
+        testPrepare();
+        testLimit();
+        testShrink();
+        testReadSize();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(flat_buffer,core,beast);
+
+} // beast
@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/core/handler_memory.hpp>
+
+#include <beast/core/handler_ptr.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <boost/asio/io_service.hpp>
+#include <cstdlib>
+#include <utility>
+
+namespace beast {
+
+class handler_memory_test : public beast::unit_test::suite
+{
+public:
+    // Counts uses of its own allocation hooks
+    struct handler
+    {
+        int* nalloc;
+        int* ninvoke;
+
+        void
+        operator()(int& v) const
+        {
+            ++*ninvoke;
+            v = 1;
+        }
+
+        void
+        operator()() const
+        {
+            ++*ninvoke;
+        }
+
+        friend
+        void*
+        asio_handler_allocate(std::size_t size, handler* h)
+        {
+            ++*h->nalloc;
+            return std::malloc(size);
+        }
+
+        friend
+        void
+        asio_handler_deallocate(void* p, std::size_t, handler* h)
+        {
+            --*h->nalloc;
+            std::free(p);
+        }
+    };
+
+    struct T
+    {
+        char buf[100];
+
+        template<class Handler>
+        explicit
+        T(Handler&)
+        {
+        }
+    };
+
+    void
+    testMemory()
+    {
+        handler_memory m;
+        auto const p1 = m.allocate(10);
+        BEAST_EXPECT(p1);
+        BEAST_EXPECT(m.deallocate(p1));
+        // same block is handed out again
+        auto const p2 = m.allocate(10);
+        BEAST_EXPECT(p2 == p1);
+        BEAST_EXPECT(m.deallocate(p2));
+        // a larger request grows a block
+        auto const p3 = m.allocate(1000);
+        BEAST_EXPECT(p3);
+        auto const p4 = m.allocate(500);
+        BEAST_EXPECT(p4 && p4 != p3);
+        BEAST_EXPECT(m.deallocate(p3));
+        BEAST_EXPECT(m.deallocate(p4));
+
+        // exhaust the blocks
+        void* v[8];
+        for(auto& p : v)
+        {
+            p = m.allocate(64);
+            BEAST_EXPECT(p);
+        }
+        BEAST_EXPECT(m.allocate(1) == nullptr);
+        int x;
+        BEAST_EXPECT(! m.deallocate(&x));
+        BEAST_EXPECT(! m.deallocate(nullptr));
+        for(auto p : v)
+            BEAST_EXPECT(m.deallocate(p));
+
+        // move keeps the blocks
+        auto const p5 = m.allocate(64);
+        BEAST_EXPECT(m.deallocate(p5));
+        handler_memory m2{std::move(m)};
+        BEAST_EXPECT(m2.allocate(64) == p5);
+        BEAST_EXPECT(m2.deallocate(p5));
+        m = std::move(m2);
+        BEAST_EXPECT(m.allocate(64) == p5);
+        BEAST_EXPECT(m.deallocate(p5));
+    }
+
+    void
+    testBindMemory()
+    {
+        int nalloc = 0;
+        int ninvoke = 0;
+        handler_memory m;
+        auto h = bind_memory(m, handler{&nalloc, &ninvoke});
+
+        // state comes from the memory, not the handler
+        {
+            using ptr = handler_ptr<T, decltype(h)>;
+            for(int i = 0; i < 3; ++i)
+            {
+                ptr p{h};
+                BEAST_EXPECT(nalloc == 0);
+                int v = 0;
+                p.invoke(std::ref(v));
+                BEAST_EXPECT(v == 1);
+            }
+            BEAST_EXPECT(ninvoke == 3);
+        }
+
+        // falls back to the handler when exhausted
+        {
+            void* v[9];
+            for(auto& p : v)
+                p = beast_asio_helpers::allocate(16, h);
+            BEAST_EXPECT(nalloc == 1);
+            for(auto p : v)
+                beast_asio_helpers::deallocate(p, 16, h);
+            BEAST_EXPECT(nalloc == 0);
+        }
+
+        // io_service uses the hooks
+        {
+            boost::asio::io_service ios;
+            ninvoke = 0;
+            for(int i = 0; i < 3; ++i)
+            {
+                ios.post(bind_memory(m, handler{&nalloc, &ninvoke}));
+                ios.run();
+                ios.reset();
+                BEAST_EXPECT(nalloc == 0);
+            }
+            BEAST_EXPECT(ninvoke == 3);
+        }
+    }
+
+    void
+    run() override
+    {
+        testMemory();
+        testBindMemory();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(handler_memory,core,beast);
+
+} // beast
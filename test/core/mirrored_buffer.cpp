@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/core/mirrored_buffer.hpp>
+
+#include <beast/core/buffer_concepts.hpp>
+#include <beast/core/dynabuf_readstream.hpp>
+#include <beast/core/to_string.hpp>
+#include <beast/test/string_istream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/read.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace beast {
+
+static_assert(is_DynamicBuffer<mirrored_buffer>::value, "");
+
+class mirrored_buffer_test : public beast::unit_test::suite
+{
+public:
+    static
+    void
+    append(mirrored_buffer& b, std::string const& s)
+    {
+        using boost::asio::buffer;
+        using boost::asio::buffer_copy;
+        b.commit(buffer_copy(b.prepare(s.size()),
+            buffer(s.data(), s.size())));
+    }
+
+    static
+    std::size_t
+    count(mirrored_buffer::const_buffers_type const& b)
+    {
+        return std::distance(b.begin(), b.end());
+    }
+
+    void
+    testMembers()
+    {
+        mirrored_buffer b{1};
+        BEAST_EXPECT(b.capacity() > 0);
+        BEAST_EXPECT(b.max_size() == b.capacity());
+        BEAST_EXPECT(b.size() == 0);
+        append(b, "Hello, world");
+        mirrored_buffer b2{std::move(b)};
+        BEAST_EXPECT(b.size() == 0);
+        BEAST_EXPECT(to_string(b2.data()) == "Hello, world");
+        b = std::move(b2);
+        BEAST_EXPECT(b2.size() == 0);
+        BEAST_EXPECT(to_string(b.data()) == "Hello, world");
+        try
+        {
+            mirrored_buffer b3{0};
+            fail();
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testWrap()
+    {
+        using boost::asio::buffer_cast;
+        using boost::asio::buffer_size;
+        mirrored_buffer b{4096};
+        auto const cap = b.capacity();
+        // Step around the ring several times with a size
+        // which does not divide the capacity, so that both
+        // sequences straddle the end of the storage.
+        std::size_t const step = cap / 3 + 7;
+        std::size_t written = 0;
+        std::size_t read = 0;
+        auto const ch =
+            [](std::size_t i)
+            {
+                return static_cast<char>('a' + i % 23);
+            };
+        for(int i = 0; i < 20; ++i)
+        {
+            auto const out = b.prepare(step);
+            BEAST_EXPECT(buffer_size(out) == step);
+            auto const p = buffer_cast<char*>(out);
+            for(std::size_t j = 0; j < step; ++j)
+                p[j] = ch(written + j);
+            b.commit(step);
+            written += step;
+            BEAST_EXPECT(count(b.data()) == 1);
+            BEAST_EXPECT(b.size() == written - read);
+            auto const in = buffer_cast<char const*>(*b.data().begin());
+            bool ok = true;
+            for(std::size_t j = 0; j < b.size(); ++j)
+                ok = ok && in[j] == ch(read + j);
+            BEAST_EXPECT(ok);
+            b.consume(b.size() > 100 ? b.size() - 100 : 0);
+            read = written - b.size();
+        }
+        BEAST_EXPECT(b.capacity() == cap);
+    }
+
+    void
+    testOverflow()
+    {
+        mirrored_buffer b{4096};
+        auto const cap = b.capacity();
+        append(b, std::string(cap, '*'));
+        BEAST_EXPECT(b.size() == cap);
+        BEAST_EXPECT(read_size_helper(b, 65536) == 1);
+        try
+        {
+            b.prepare(1);
+            fail();
+        }
+        catch(std::length_error const&)
+        {
+            pass();
+        }
+        b.consume(10);
+        BEAST_EXPECT(read_size_helper(b, 65536) == 10);
+        BEAST_EXPECT(read_size_helper(b, 5) == 5);
+        append(b, "0123456789");
+        BEAST_EXPECT(b.size() == cap);
+        b.consume(cap - 10);
+        BEAST_EXPECT(to_string(b.data()) == "0123456789");
+    }
+
+    void
+    testReadStream()
+    {
+        boost::asio::io_service ios;
+        std::string const s(10000, 'x');
+        dynabuf_readstream<
+            test::string_istream, mirrored_buffer> srs(ios, s, 100);
+        srs.capacity(1000);
+        std::string got;
+        got.resize(s.size());
+        boost::asio::read(srs, boost::asio::buffer(&got[0], got.size()));
+        BEAST_EXPECT(got == s);
+    }
+
+    void run() override
+    {
+        testMembers();
+        testWrap();
+        testOverflow();
+        testReadStream();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(mirrored_buffer,core,beast);
+
+} // beast
@@ -11,8 +11,12 @@
 #include "buffer_test.hpp"
 #include <beast/core/buffer_concepts.hpp>
 #include <beast/core/to_string.hpp>
+#include <beast/http/read.hpp>
+#include <beast/http/string_body.hpp>
+#include <beast/test/string_istream.hpp>
 #include <beast/unit_test/suite.hpp>
 #include <boost/asio/buffer.hpp>
+#include <boost/asio/io_service.hpp>
 #include <algorithm>
 #include <atomic>
 #include <memory>
@@ -27,6 +31,7 @@ struct test_allocator_info
     std::size_t ncopy = 0;
     std::size_t nmove = 0;
     std::size_t nselect = 0;
+    std::size_t nalloc = 0;
 };
 
 template<class T,
@@ -116,6 +121,7 @@ public:
     value_type*
     allocate(std::size_t n)
     {
+        ++info_->nalloc;
         return static_cast<value_type*>(
             ::operator new (n*sizeof(value_type)));
     }
@@ -463,6 +469,68 @@ public:
         }
     }
 
+    void testFreeList()
+    {
+        using alloc_type =
+            test_allocator<char, false, false, false, false>;
+        using sb_type = basic_streambuf<alloc_type>;
+        // Pipelined requests, arriving in pieces which end
+        // part way through a message, as a client would send.
+        std::string const body(3000, '*');
+        std::string s;
+        for(int i = 0; i < 120; ++i)
+            s.append(
+                "POST /upload HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Content-Length: 3000\r\n"
+                "\r\n" + body);
+        boost::asio::io_service ios;
+        test::string_istream is{ios, s, 1500};
+        sb_type sb(1024);
+        // Read, parse and consume a message
+        auto const once =
+            [&]
+            {
+                http::request<http::string_body> req;
+                http::read(is, sb, req);
+                BEAST_EXPECT(req.body == body);
+            };
+        // Warm up until the largest footprint is reached
+        for(int i = 0; i < 20; ++i)
+            once();
+        auto const nalloc = sb.get_allocator()->nalloc;
+        for(int i = 0; i < 100; ++i)
+            once();
+        BEAST_EXPECT(sb.get_allocator()->nalloc == nalloc);
+        BEAST_EXPECT(sb.size() == 0);
+    }
+
+    void testShrinkToFit()
+    {
+        using boost::asio::buffer;
+        using boost::asio::buffer_copy;
+        using alloc_type =
+            test_allocator<char, false, false, false, false>;
+        using sb_type = basic_streambuf<alloc_type>;
+        std::string const s(3000, '*');
+        sb_type sb(1024);
+        sb.commit(buffer_copy(sb.prepare(s.size()), buffer(s)));
+        sb.consume(2500);
+        // Released buffers are no longer reused
+        sb.shrink_to_fit();
+        BEAST_EXPECT(to_string(sb.data()) == s.substr(2500));
+        auto const nalloc = sb.get_allocator()->nalloc;
+        sb.commit(buffer_copy(sb.prepare(s.size()), buffer(s)));
+        BEAST_EXPECT(sb.get_allocator()->nalloc > nalloc);
+        BEAST_EXPECT(sb.size() == 3500);
+        // An empty buffer releases everything
+        sb.consume(sb.size());
+        sb.shrink_to_fit();
+        BEAST_EXPECT(sb.capacity() == 0);
+        sb.commit(buffer_copy(sb.prepare(5), buffer("Hello", 5)));
+        BEAST_EXPECT(to_string(sb.data()) == "Hello");
+    }
+
     void run() override
     {
         testSpecialMembers();
@@ -474,6 +542,8 @@ public:
         testIterators();
         testOutputStream();
         testCapacity();
+        testFreeList();
+        testShrinkToFit();
     }
 };
 
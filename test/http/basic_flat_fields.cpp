@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/basic_flat_fields.hpp>
+
+#include <beast/http/basic_fields.hpp>
+#include <beast/http/parser_v1.hpp>
+#include <beast/http/string_body.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <boost/lexical_cast.hpp>
+#include <string>
+
+namespace beast {
+namespace http {
+
+class basic_flat_fields_test : public beast::unit_test::suite
+{
+public:
+    using bh = basic_flat_fields<std::allocator<char>>;
+
+    template<class Allocator>
+    static
+    void
+    fill(std::size_t n, basic_flat_fields<Allocator>& h)
+    {
+        for(std::size_t i = 1; i<= n; ++i)
+            h.insert(boost::lexical_cast<std::string>(i), i);
+    }
+
+    template<class U, class V>
+    static
+    void
+    self_assign(U& u, V&& v)
+    {
+        u = std::forward<V>(v);
+    }
+
+    static
+    std::string
+    str(bh const& h)
+    {
+        std::string s;
+        for(auto const& f : h)
+        {
+            s.append(f.name().data(), f.name().size());
+            s.append(": ");
+            s.append(f.value().data(), f.value().size());
+            s.append("\r\n");
+        }
+        return s;
+    }
+
+    void testHeaders()
+    {
+        bh h1;
+        BEAST_EXPECT(h1.empty());
+        fill(1, h1);
+        BEAST_EXPECT(h1.size() == 1);
+        bh h2;
+        h2 = h1;
+        BEAST_EXPECT(h2.size() == 1);
+        h2.insert("2", "2");
+        BEAST_EXPECT(std::distance(h2.begin(), h2.end()) == 2);
+        h1 = std::move(h2);
+        BEAST_EXPECT(h1.size() == 2);
+        BEAST_EXPECT(h2.size() == 0);
+        bh h3(std::move(h1));
+        BEAST_EXPECT(h3.size() == 2);
+        BEAST_EXPECT(h1.size() == 0);
+        self_assign(h3, std::move(h3));
+        BEAST_EXPECT(h3.size() == 2);
+        BEAST_EXPECT(h2.erase("Not-Present") == 0);
+        BEAST_EXPECT(! h1.exists("1"));
+        BEAST_EXPECT(h1.find("1") == h1.end());
+    }
+
+    void testRFC2616()
+    {
+        bh h;
+        h.insert("a", "w");
+        h.insert("a", "x");
+        h.insert("aa", "y");
+        h.insert("b", "z");
+        BEAST_EXPECT(h.count("a") == 2);
+    }
+
+    void testLookup()
+    {
+        bh h;
+        h.insert("Content-Type", "text/html");
+        h.insert("Set-Cookie", "a=1");
+        h.insert("set-cookie", "b=2");
+        h.insert("X-Empty", "  ");
+        BEAST_EXPECT(h.exists("CONTENT-TYPE"));
+        BEAST_EXPECT(h["content-type"] == "text/html");
+        BEAST_EXPECT(h["SET-COOKIE"] == "a=1");
+        BEAST_EXPECT(h.count("Set-cookie") == 2);
+        BEAST_EXPECT(h.exists("X-Empty"));
+        BEAST_EXPECT(h["X-Empty"].empty());
+        BEAST_EXPECT(h["Missing"].empty());
+        BEAST_EXPECT(! h.exists("Content-Typ"));
+        BEAST_EXPECT(! h.exists("Content-Type-"));
+        auto it = h.find("set-cookie");
+        BEAST_EXPECT(it->name() == "Set-Cookie");
+        ++it;
+        BEAST_EXPECT(it->name() == "set-cookie");
+        BEAST_EXPECT(it->value() == "b=2");
+        --it;
+        BEAST_EXPECT(it->value() == "a=1");
+
+        // Enough fields to force the table to grow
+        bh h2;
+        fill(1000, h2);
+        BEAST_EXPECT(h2.size() == 1000);
+        for(std::size_t i = 1; i <= 1000; ++i)
+        {
+            auto const s = boost::lexical_cast<std::string>(i);
+            if(! BEAST_EXPECT(h2[s] == s))
+                break;
+        }
+        BEAST_EXPECT(! h2.exists("1001"));
+        BEAST_EXPECT(! h2.exists("0"));
+    }
+
+    void testErase()
+    {
+        bh h;
+        h.insert("a", "w");
+        h.insert("a", "x");
+        h.insert("aa", "y");
+        h.insert("b", "z");
+        BEAST_EXPECT(h.size() == 4);
+        BEAST_EXPECT(h.erase("A") == 2);
+        BEAST_EXPECT(h.size() == 2);
+        BEAST_EXPECT(str(h) == "aa: y\r\nb: z\r\n");
+        BEAST_EXPECT(h["aa"] == "y");
+        BEAST_EXPECT(h["b"] == "z");
+        BEAST_EXPECT(! h.exists("a"));
+
+        h.replace("aa", "1");
+        BEAST_EXPECT(str(h) == "b: z\r\naa: 1\r\n");
+        h.replace("b", 2);
+        BEAST_EXPECT(str(h) == "aa: 1\r\nb: 2\r\n");
+
+        // Arguments which refer to the container itself
+        h.insert(h.begin()->name(), h.begin()->value());
+        BEAST_EXPECT(h.count("aa") == 2);
+        BEAST_EXPECT(h.erase(h.begin()->name()) == 2);
+        BEAST_EXPECT(str(h) == "b: 2\r\n");
+        h.replace(h.begin()->name(), h.begin()->value());
+        BEAST_EXPECT(str(h) == "b: 2\r\n");
+
+        h.clear();
+        BEAST_EXPECT(h.empty());
+        BEAST_EXPECT(h.begin() == h.end());
+        BEAST_EXPECT(! h.exists("b"));
+        h.insert("b", "3");
+        BEAST_EXPECT(h["b"] == "3");
+    }
+
+    void testConvert()
+    {
+        basic_fields<std::allocator<char>> f;
+        f.insert("Host", "example.com");
+        f.insert("Accept", " */* ");
+        bh h(f.begin(), f.end());
+        BEAST_EXPECT(str(h) ==
+            "Host: example.com\r\nAccept: */*\r\n");
+        bh h2;
+        h2.reserve(16, 1024);
+        h2 = h;
+        BEAST_EXPECT(str(h2) == str(h));
+        bh h3(h2);
+        BEAST_EXPECT(h3["host"] == "example.com");
+    }
+
+    void testFieldIds()
+    {
+        bh h;
+        h.insert("content-length", "1");
+        h.insert(field::connection, "close");
+        h.insert("X-Custom", "a");
+        h.insert(field::content_length, 2);
+        BEAST_EXPECT(str(h) ==
+            "content-length: 1\r\n"
+            "Connection: close\r\n"
+            "X-Custom: a\r\n"
+            "Content-Length: 2\r\n");
+        // Names inserted by id are not copied
+        BEAST_EXPECT(h.find(field::connection)->name().data() ==
+            to_string(field::connection).data());
+        BEAST_EXPECT(h.exists(field::content_length));
+        BEAST_EXPECT(h.count(field::content_length) == 2);
+        BEAST_EXPECT(h[field::content_length] == "1");
+        BEAST_EXPECT(h["CONNECTION"] == "close");
+        BEAST_EXPECT(h.count("Content-Length") == 2);
+        BEAST_EXPECT(! h.exists(field::host));
+        BEAST_EXPECT(h[field::host].empty());
+        BEAST_EXPECT(h.find(field::host) == h.end());
+        BEAST_EXPECT(h.erase(field::host) == 0);
+        BEAST_EXPECT(h.erase(field::content_length) == 2);
+        BEAST_EXPECT(str(h) ==
+            "Connection: close\r\n"
+            "X-Custom: a\r\n");
+        h.replace(field::connection, h[field::connection]);
+        BEAST_EXPECT(str(h) ==
+            "X-Custom: a\r\n"
+            "Connection: close\r\n");
+        h.replace(field::connection, "upgrade");
+        BEAST_EXPECT(h[field::connection] == "upgrade");
+        h.erase("connection");
+        BEAST_EXPECT(! h.exists(field::connection));
+        BEAST_EXPECT(h.size() == 1);
+    }
+
+    void testMessage()
+    {
+        std::string const s =
+            "GET / HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "X-Multi: 1\r\n"
+            "x-multi: 2\r\n"
+            "Content-Length: 3\r\n"
+            "\r\n"
+            "abc";
+        parser_v1<true, string_body, bh> p;
+        error_code ec;
+        p.write(boost::asio::buffer(s), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.complete());
+        auto m = p.release();
+        BEAST_EXPECT(m.fields.size() == 4);
+        BEAST_EXPECT(m.fields["host"] == "example.com");
+        BEAST_EXPECT(m.fields.count("X-Multi") == 2);
+        BEAST_EXPECT(m.body == "abc");
+        m.body = "abcdef";
+        m.fields.erase("Content-Length");
+        prepare(m);
+        BEAST_EXPECT(m.fields["Content-Length"] == "6");
+    }
+
+    void run() override
+    {
+        testHeaders();
+        testRFC2616();
+        testLookup();
+        testErase();
+        testConvert();
+        testFieldIds();
+        testMessage();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(basic_flat_fields,http,beast);
+
+} // http
+} // beast
@@ -497,6 +497,81 @@ public:
         bad<true>(m("f: v\r \r\n"),                 parse_error::bad_crlf);
         bad<true>(m("f: \r v\r\n"),                 parse_error::bad_crlf);
         bad<true>("GET / HTTP/1.1\r\n\r \n",        parse_error::bad_crlf);
+
+        // long enough to exercise the vectorized scanners
+        std::string const f = "X-Very-Long-Field_Name-0123456789-abcdefghijklmnopqrstuvwxyz";
+        std::string const v = "Mozilla/5.0 (X11; Linux x86_64) \x80\xff AppleWebKit/537.36 (KHTML, like Gecko)";
+        good<true>(m(f + ": " + v + "\r\n"));
+        good<true>(m(f + ":\t" + v + "\t" + v + "\r\n"));
+        good<true>(m(f + ": " + v + "\r\n " + v + "\r\n"));
+        bad<true>(m(f + "@: " + v + "\r\n"),        parse_error::bad_field);
+        bad<true>(m(f + " : " + v + "\r\n"),        parse_error::bad_field);
+        bad<true>(m(f + ": " + v + "\x7f\r\n"),    parse_error::bad_value);
+        bad<true>(m(f + ": " + v + "\x01" + v + "\r\n"), parse_error::bad_value);
+        bad<true>(m(f + ": " + v + "\n\r\n"),      parse_error::bad_value);
+    }
+
+    // Compare each vectorized scanner against the character tables
+    template<class Pred>
+    void
+    checkScan(detail::skip_chars_fn f, Pred const& pred)
+    {
+        std::string s;
+        for(int i = 0; i < 256; ++i)
+        {
+            for(std::size_t n = 0; n < 70; n += 3)
+            {
+                for(std::size_t pos = 0; pos <= n; ++pos)
+                {
+                    s.assign(n, 'a');
+                    if(pos < n)
+                        s[pos] = static_cast<char>(i);
+                    auto const p = f(s.data(), s.data() + n);
+                    if(pos < n && ! pred(s[pos]))
+                        BEAST_EXPECT(p == s.data() + pos);
+                    else
+                        BEAST_EXPECT(p == s.data() + n);
+                }
+            }
+        }
+    }
+
+    void
+    testScan()
+    {
+        auto const field =
+            [](char c)
+            {
+                return detail::is_plain_field_char(c);
+            };
+        auto const value =
+            [](char c)
+            {
+                return detail::is_plain_value_char(c);
+            };
+        for(int i = 0; i < 256; ++i)
+        {
+            auto const c = static_cast<char>(i);
+            if(detail::is_plain_field_char(c))
+                BEAST_EXPECT(detail::to_field_char(c));
+            if(detail::is_plain_value_char(c))
+                BEAST_EXPECT(c != '\r' && detail::to_value_char(c));
+        }
+        checkScan(&detail::skip_field_chars_scalar, field);
+        checkScan(&detail::skip_value_chars_scalar, value);
+#if BEAST_DETAIL_X86
+        auto const& ci = beast::detail::get_cpu_info();
+        if(ci.sse2)
+        {
+            checkScan(&detail::skip_field_chars_sse2, field);
+            checkScan(&detail::skip_value_chars_sse2, value);
+        }
+        if(ci.avx2)
+        {
+            checkScan(&detail::skip_field_chars_avx2, field);
+            checkScan(&detail::skip_value_chars_avx2, value);
+        }
+#endif
     }
 
     //--------------------------------------------------------------------------
@@ -1159,6 +1234,7 @@ public:
         testRequestLine();
         testStatusLine();
         testHeaders();
+        testScan();
         testConnectionHeader();
         testContentLengthHeader();
         testTransferEncodingHeader();
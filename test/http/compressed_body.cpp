@@ -0,0 +1,689 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/compressed_body.hpp>
+
+#include <beast/core/streambuf.hpp>
+#include <beast/http/fields.hpp>
+#include <beast/http/parser_v1.hpp>
+#include <beast/http/read.hpp>
+#include <beast/http/string_body.hpp>
+#include <beast/http/write.hpp>
+#include <beast/test/string_istream.hpp>
+#include <beast/test/string_ostream.hpp>
+#include <beast/test/yield_to.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/zlib/inflate_stream.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace beast {
+namespace http {
+
+class compressed_body_test
+    : public beast::unit_test::suite
+    , public test::enable_yield_to
+{
+public:
+    // Produces the body in small pieces, suspending before each
+    struct pieces_body
+    {
+        using value_type = std::string;
+
+        class writer
+        {
+            value_type const& body_;
+            std::size_t n_ = 0;
+            bool suspend_ = false;
+            enable_yield_to yt_;
+
+        public:
+            template<bool isRequest, class Fields>
+            explicit
+            writer(message<isRequest, pieces_body, Fields> const& msg) noexcept
+                : body_(msg.body)
+            {
+            }
+
+            void
+            init(error_code& ec) noexcept
+            {
+                beast::detail::ignore_unused(ec);
+            }
+
+            class do_resume
+            {
+                resume_context rc_;
+
+            public:
+                explicit
+                do_resume(resume_context&& rc)
+                    : rc_(std::move(rc))
+                {
+                }
+
+                void
+                operator()()
+                {
+                    rc_();
+                }
+            };
+
+            template<class WriteFunction>
+            boost::tribool
+            write(resume_context&& rc, error_code&,
+                WriteFunction&& wf) noexcept
+            {
+                suspend_ = ! suspend_;
+                if(suspend_)
+                {
+                    yt_.get_io_service().post(do_resume{std::move(rc)});
+                    return boost::indeterminate;
+                }
+                auto const n = std::min<std::size_t>(
+                    997, body_.size() - n_);
+                wf(boost::asio::buffer(body_.data() + n_, n));
+                n_ += n;
+                return n_ == body_.size();
+            }
+        };
+    };
+
+    // Counts copies of the body, and can fail to construct its writer
+    struct probe_body
+    {
+        struct value_type
+        {
+            static int copies;
+
+            std::string s;
+            bool fail = false;
+
+            value_type() = default;
+
+            value_type(value_type const& other)
+                : s(other.s)
+                , fail(other.fail)
+            {
+                ++copies;
+            }
+
+            value_type&
+            operator=(value_type const& other)
+            {
+                s = other.s;
+                fail = other.fail;
+                ++copies;
+                return *this;
+            }
+        };
+
+        class writer
+        {
+            value_type const& body_;
+
+        public:
+            template<bool isRequest, class Fields>
+            explicit
+            writer(message<isRequest, probe_body, Fields> const& msg)
+                : body_(msg.body)
+            {
+                if(body_.fail)
+                    throw 42;
+            }
+
+            void
+            init(error_code& ec) noexcept
+            {
+                beast::detail::ignore_unused(ec);
+            }
+
+            template<class WriteFunction>
+            boost::tribool
+            write(resume_context&&, error_code&,
+                WriteFunction&& wf) noexcept
+            {
+                wf(boost::asio::buffer(body_.s));
+                return true;
+            }
+        };
+    };
+
+    static
+    std::string
+    make_text(std::size_t size)
+    {
+        static char const words[] =
+            "the quick brown fox jumps over the lazy dog ";
+        std::string s;
+        s.reserve(size);
+        while(s.size() < size)
+            s.push_back(words[(s.size() * 7 + s.size() / 13) %
+                (sizeof(words) - 1)]);
+        return s;
+    }
+
+    static
+    std::string
+    make_random(std::size_t size)
+    {
+        std::mt19937 g;
+        std::string s;
+        s.reserve(size);
+        while(s.size() < size)
+            s.push_back(static_cast<char>(g()));
+        return s;
+    }
+
+    static
+    std::uint32_t
+    get_le(std::string const& s, std::size_t pos)
+    {
+        std::uint32_t v = 0;
+        for(int i = 3; i >= 0; --i)
+            v = (v << 8) | static_cast<std::uint8_t>(s[pos + i]);
+        return v;
+    }
+
+    static
+    std::uint32_t
+    get_be(std::string const& s, std::size_t pos)
+    {
+        std::uint32_t v = 0;
+        for(int i = 0; i < 4; ++i)
+            v = (v << 8) | static_cast<std::uint8_t>(s[pos + i]);
+        return v;
+    }
+
+    // Returns the body of a chunked message, or "<error>"
+    static
+    std::string
+    dechunk(std::string const& s)
+    {
+        auto pos = s.find("\r\n\r\n");
+        if(pos == std::string::npos)
+            return "<error>";
+        pos += 4;
+        std::string body;
+        for(;;)
+        {
+            auto const eol = s.find("\r\n", pos);
+            if(eol == std::string::npos)
+                return "<error>";
+            auto const n = static_cast<std::size_t>(std::strtoul(
+                s.substr(pos, eol - pos).c_str(), nullptr, 16));
+            pos = eol + 2;
+            if(n == 0)
+                break;
+            // No chunk is larger than the writer's buffer
+            if(n > compressed_body<string_body>::writer::buffer_size ||
+                    pos + n + 2 > s.size())
+                return "<error>";
+            body.append(s, pos, n);
+            pos += n + 2;
+        }
+        if(s.substr(pos) != "\r\n")
+            return "<error>";
+        return body;
+    }
+
+    // Decompress a raw deflate stream, or return "<error>"
+    static
+    std::string
+    inflate(std::string const& in)
+    {
+        zlib::inflate_stream zi;
+        std::string out;
+        char buf[4096];
+        zlib::z_params zs;
+        zs.next_in = in.data();
+        zs.avail_in = in.size();
+        for(;;)
+        {
+            zs.next_out = buf;
+            zs.avail_out = sizeof(buf);
+            error_code ec;
+            zi.write(zs, zlib::Flush::sync, ec);
+            out.append(buf, sizeof(buf) - zs.avail_out);
+            if(ec == zlib::error::end_of_stream)
+                break;
+            if(ec || zs.avail_out == sizeof(buf))
+                return "<error>";
+        }
+        // Only the trailer follows
+        if(zs.avail_in != 0)
+            return "<error>";
+        return out;
+    }
+
+    // Decode the content, checking the framing
+    static
+    std::string
+    decode(std::string const& body, content_coding coding)
+    {
+        if(coding == content_coding::gzip)
+        {
+            if(body.size() < 18 ||
+                static_cast<std::uint8_t>(body[0]) != 0x1f ||
+                static_cast<std::uint8_t>(body[1]) != 0x8b ||
+                    body[2] != 8 || body[3] != 0)
+                return "<header>";
+            auto const s = inflate(body.substr(10, body.size() - 18));
+            if(get_le(body, body.size() - 8) !=
+                    zlib::detail::crc32(0, s.data(), s.size()))
+                return "<crc>";
+            if(get_le(body, body.size() - 4) !=
+                    static_cast<std::uint32_t>(s.size()))
+                return "<isize>";
+            return s;
+        }
+        if(body.size() < 6 ||
+            (static_cast<std::uint8_t>(body[0]) & 0x0f) != 8 ||
+            (static_cast<std::uint8_t>(body[0]) * 256 +
+                static_cast<std::uint8_t>(body[1])) % 31 != 0 ||
+                    (body[1] & 0x20) != 0)
+            return "<header>";
+        auto const s = inflate(body.substr(2, body.size() - 6));
+        if(get_be(body, body.size() - 4) !=
+                zlib::detail::adler32(1, s.data(), s.size()))
+            return "<adler>";
+        return s;
+    }
+
+    template<class Body>
+    static
+    response<compressed_body<Body>, fields>
+    make_response(std::string const& s,
+        content_coding coding, int level)
+    {
+        response<compressed_body<Body>, fields> m;
+        m.version = 11;
+        m.status = 200;
+        m.reason = "OK";
+        if(coding != content_coding::identity)
+            m.fields.insert("Content-Encoding",
+                coding == content_coding::gzip ? "gzip" : "deflate");
+        m.body.inner = s;
+        m.body.coding = coding;
+        m.body.level = level;
+        prepare(m);
+        return m;
+    }
+
+    void
+    testPrepare()
+    {
+        auto const m = make_response<string_body>(
+            "*****", content_coding::gzip, 6);
+        BEAST_EXPECT(m.fields["Transfer-Encoding"] == "chunked");
+        BEAST_EXPECT(! m.fields.exists("Content-Length"));
+    }
+
+    void
+    testWrite()
+    {
+        for(auto coding : {
+            content_coding::gzip, content_coding::deflate})
+        {
+            for(int level : {0, 1, 6, 9})
+            {
+                for(std::size_t size : {0, 1, 1000, 100000})
+                {
+                    for(auto const& s : {
+                        make_text(size), make_random(size)})
+                    {
+                        auto const m = make_response<string_body>(
+                            s, coding, level);
+                        test::string_ostream ss{ios_};
+                        error_code ec;
+                        write(ss, m, ec);
+                        if(! BEAST_EXPECTS(! ec, ec.message()))
+                            continue;
+                        BEAST_EXPECTS(decode(dechunk(ss.str),
+                            coding) == s, std::to_string(level) +
+                                " " + std::to_string(size));
+                    }
+                }
+            }
+        }
+        {
+            // Text compresses
+            auto const s = make_text(100000);
+            auto const m = make_response<string_body>(
+                s, content_coding::gzip, 6);
+            test::string_ostream ss{ios_};
+            write(ss, m);
+            BEAST_EXPECT(dechunk(ss.str).size() < s.size() / 4);
+        }
+        {
+            // No coding
+            auto const s = make_text(1000);
+            auto const m = make_response<string_body>(
+                s, content_coding::identity, 6);
+            test::string_ostream ss{ios_};
+            write(ss, m);
+            BEAST_EXPECT(dechunk(ss.str) == s);
+        }
+    }
+
+    void
+    testPieces()
+    {
+        auto const s = make_text(50000);
+        for(auto coding : {
+            content_coding::gzip, content_coding::deflate})
+        {
+            auto const m = make_response<pieces_body>(s, coding, 6);
+            test::string_ostream ss{ios_};
+            write(ss, m);
+            BEAST_EXPECT(decode(dechunk(ss.str), coding) == s);
+        }
+    }
+
+    void
+    testAsyncWrite(yield_context do_yield)
+    {
+        auto const s = make_random(30000) + make_text(70000);
+        for(auto coding : {
+            content_coding::gzip, content_coding::deflate})
+        {
+            {
+                auto const m = make_response<string_body>(
+                    s, coding, 6);
+                error_code ec;
+                test::string_ostream ss{ios_};
+                async_write(ss, m, do_yield[ec]);
+                if(BEAST_EXPECTS(! ec, ec.message()))
+                    BEAST_EXPECT(decode(
+                        dechunk(ss.str), coding) == s);
+            }
+            {
+                auto const m = make_response<pieces_body>(
+                    s, coding, 1);
+                error_code ec;
+                test::string_ostream ss{ios_};
+                async_write(ss, m, do_yield[ec]);
+                if(BEAST_EXPECTS(! ec, ec.message()))
+                    BEAST_EXPECT(decode(
+                        dechunk(ss.str), coding) == s);
+            }
+        }
+    }
+
+    // Returns a response with the encoded body
+    std::string
+    encode(std::string const& s, content_coding coding, int level = 6)
+    {
+        auto const m = make_response<string_body>(s, coding, level);
+        test::string_ostream ss{ios_};
+        write(ss, m);
+        return ss.str;
+    }
+
+    static
+    std::string
+    response_with(std::string const& coding, std::string const& body)
+    {
+        std::string s =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        if(! coding.empty())
+            s += "Content-Encoding: " + coding + "\r\n";
+        return s + "\r\n" + body;
+    }
+
+    using parser_type =
+        parser_v1<false, compressed_body<string_body>, fields>;
+
+    // Parse a message given in pieces of at most n bytes
+    static
+    error_code
+    parse(parser_type& p, std::string const& s, std::size_t n)
+    {
+        error_code ec;
+        for(std::size_t pos = 0; pos < s.size();)
+        {
+            auto const used = p.write(boost::asio::buffer(
+                s.data() + pos, std::min(n, s.size() - pos)), ec);
+            if(ec)
+                break;
+            if(used == 0)
+            {
+                if(n >= s.size() - pos)
+                    break;
+                n = s.size() - pos;
+                continue;
+            }
+            pos += used;
+        }
+        return ec;
+    }
+
+    void
+    testRead()
+    {
+        for(auto coding : {
+            content_coding::gzip, content_coding::deflate})
+        {
+            for(std::size_t size : {0, 1, 1000, 100000})
+            {
+                for(auto const& s : {
+                    make_text(size), make_random(size)})
+                {
+                    auto const in = encode(s, coding);
+                    std::size_t const pieces[] = {
+                        1, 7, 1000, in.size()};
+                    for(auto n : pieces)
+                    {
+                        if(size > 1000 && n < 1000)
+                            continue;
+                        parser_type p;
+                        auto const ec = parse(p, in, n);
+                        if(! BEAST_EXPECTS(! ec, ec.message()))
+                            continue;
+                        BEAST_EXPECT(p.complete());
+                        BEAST_EXPECT(p.get().body.coding == coding);
+                        BEAST_EXPECTS(p.get().body.inner == s,
+                            std::to_string(size) + " " +
+                                std::to_string(n));
+                    }
+                }
+            }
+        }
+        {
+            // Using read
+            auto const s = make_text(50000);
+            test::string_istream is{ios_,
+                encode(s, content_coding::gzip), 1000};
+            streambuf sb;
+            response<compressed_body<string_body>, fields> m;
+            read(is, sb, m);
+            BEAST_EXPECT(m.body.inner == s);
+        }
+        {
+            // No coding
+            parser_type p;
+            auto const ec = parse(p,
+                response_with("", "*****"), 2);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body.coding ==
+                content_coding::identity);
+            BEAST_EXPECT(p.get().body.inner == "*****");
+        }
+        {
+            // Case-insensitive name, empty body
+            parser_type p;
+            auto const ec = parse(p,
+                response_with("X-GZip", ""), 100);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.complete());
+            BEAST_EXPECT(p.get().body.coding ==
+                content_coding::gzip);
+        }
+        {
+            // Deflate without the zlib wrapper
+            auto const s = make_text(5000);
+            auto const z = dechunk(encode(
+                s, content_coding::deflate));
+            parser_type p;
+            auto const ec = parse(p, response_with("deflate",
+                z.substr(2, z.size() - 6)), 100);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body.inner == s);
+        }
+        {
+            // gzip header with every optional field
+            auto const s = make_text(5000);
+            auto z = dechunk(encode(s, content_coding::gzip));
+            z[3] = 2 | 4 | 8 | 16;
+            z.insert(10, std::string("\x03\x00" "xyz"
+                "name\x00" "comment\x00" "\x12\x34", 20));
+            parser_type p;
+            auto const ec = parse(p, response_with("gzip", z), 3);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body.inner == s);
+        }
+    }
+
+    void
+    testReadErrors()
+    {
+        auto const s = make_text(5000);
+        auto const check =
+            [&](std::string const& coding,
+                std::string const& body, error_code const& ev)
+            {
+                parser_type p;
+                auto ec = parse(p, response_with(coding, body), 100);
+                BEAST_EXPECTS(ec == ev, ec.message());
+            };
+        auto const gz = dechunk(encode(s, content_coding::gzip));
+        auto const zl = dechunk(encode(s, content_coding::deflate));
+        check("br", "*****", parse_error::unknown_content_coding);
+        check("gzip, gzip", gz, parse_error::unknown_content_coding);
+        {
+            auto z = gz;
+            z[0] = 'x';
+            check("gzip", z, parse_error::bad_content_coding);
+        }
+        {
+            auto z = gz;
+            z[z.size() - 8] ^= 1;
+            check("gzip", z, parse_error::bad_content_coding);
+        }
+        {
+            auto z = gz;
+            z[z.size() - 1] ^= 1;
+            check("gzip", z, parse_error::bad_content_coding);
+        }
+        {
+            auto z = zl;
+            z[z.size() - 1] ^= 1;
+            check("deflate", z, parse_error::bad_content_coding);
+        }
+        check("gzip", gz + "*", parse_error::bad_content_coding);
+        check("gzip", gz.substr(0, gz.size() - 1),
+            parse_error::bad_content_coding);
+        check("gzip", gz.substr(0, 5),
+            parse_error::bad_content_coding);
+        {
+            // The limit applies to the decoded body
+            auto const big = make_text(100000);
+            auto const in = encode(big, content_coding::gzip);
+            {
+                parser_type p;
+                p.set_option(body_max_size{big.size() - 1});
+                auto const ec = parse(p, in, in.size());
+                BEAST_EXPECTS(ec == parse_error::body_too_big,
+                    ec.message());
+            }
+            {
+                parser_type p;
+                p.set_option(body_max_size{big.size()});
+                auto const ec = parse(p, in, in.size());
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(p.get().body.inner == big);
+            }
+        }
+    }
+
+    void
+    testBadLevel()
+    {
+        auto const m = make_response<string_body>(
+            "*****", content_coding::gzip, 10);
+        test::string_ostream ss{ios_};
+        error_code ec;
+        write(ss, m, ec);
+        BEAST_EXPECT(ec == boost::system::errc::invalid_argument);
+        BEAST_EXPECT(ss.str.empty());
+    }
+
+    void
+    testInnerBody()
+    {
+        auto const s = make_text(1000);
+        response<compressed_body<probe_body>, fields> m;
+        m.version = 11;
+        m.status = 200;
+        m.reason = "OK";
+        m.fields.insert("Content-Encoding", "gzip");
+        m.body.inner.s = s;
+        prepare(m);
+        {
+            // The body is not copied
+            probe_body::value_type::copies = 0;
+            test::string_ostream ss{ios_};
+            error_code ec;
+            write(ss, m, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(decode(dechunk(ss.str),
+                content_coding::gzip) == s);
+            BEAST_EXPECT(probe_body::value_type::copies == 0);
+        }
+        {
+            // Any exception becomes an error
+            m.body.inner.fail = true;
+            test::string_ostream ss{ios_};
+            error_code ec;
+            write(ss, m, ec);
+            BEAST_EXPECT(ec == boost::system::errc::io_error);
+        }
+        {
+            // Copies refer to their own body
+            auto m2 = m;
+            m2.body.inner.s = "*";
+            BEAST_EXPECT(m.body.inner.s == s);
+            m2.body = m.body;
+            BEAST_EXPECT(m2.body.inner.s == s);
+            BEAST_EXPECT(&m2.body.inner != &m.body.inner);
+        }
+    }
+
+    void
+    run() override
+    {
+        testPrepare();
+        testWrite();
+        testPieces();
+        yield_to(&compressed_body_test::testAsyncWrite, this);
+        testBadLevel();
+        testInnerBody();
+        testRead();
+        testReadErrors();
+    }
+};
+
+int compressed_body_test::probe_body::value_type::copies = 0;
+
+BEAST_DEFINE_TESTSUITE(compressed_body,http,beast);
+
+} // http
+} // beast
@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/field.hpp>
+
+#include <beast/http/fields.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <sstream>
+#include <string>
+
+namespace beast {
+namespace http {
+
+class field_test : public beast::unit_test::suite
+{
+public:
+    void
+    testTable()
+    {
+        BEAST_EXPECT(to_string(field::unknown).empty());
+        BEAST_EXPECT(string_to_field("") == field::unknown);
+        for(std::size_t i = 1; i <= detail::field_count; ++i)
+        {
+            auto const f = static_cast<field>(i);
+            auto const s = to_string(f);
+            BEAST_EXPECTS(! s.empty(), std::to_string(i));
+            BEAST_EXPECTS(detail::field_hash(i) ==
+                beast::detail::ci_hash(s), s.to_string());
+            BEAST_EXPECTS(string_to_field(s) == f, s.to_string());
+            std::string lower;
+            std::string upper;
+            for(auto const c : s)
+            {
+                lower.push_back(beast::detail::tolower(c));
+                upper.push_back(static_cast<char>(
+                    std::toupper(static_cast<unsigned char>(c))));
+            }
+            BEAST_EXPECTS(string_to_field(lower) == f, lower);
+            BEAST_EXPECTS(string_to_field(upper) == f, upper);
+            // Near misses
+            BEAST_EXPECT(string_to_field(
+                s.substr(0, s.size() - 1)) == field::unknown);
+            BEAST_EXPECT(string_to_field(
+                s.to_string() + "x") == field::unknown);
+        }
+        BEAST_EXPECT(to_string(static_cast<field>(
+            detail::field_count + 1)).empty());
+    }
+
+    void
+    testNames()
+    {
+        BEAST_EXPECT(to_string(field::content_length) == "Content-Length");
+        BEAST_EXPECT(to_string(field::www_authenticate) == "WWW-Authenticate");
+        BEAST_EXPECT(string_to_field("transfer-encoding") ==
+            field::transfer_encoding);
+        BEAST_EXPECT(string_to_field("Sec-Websocket-Key") ==
+            field::sec_websocket_key);
+        BEAST_EXPECT(string_to_field("X-Custom") == field::unknown);
+        BEAST_EXPECT(string_to_field("Content-Lengtj") == field::unknown);
+        std::stringstream ss;
+        ss << field::host;
+        BEAST_EXPECT(ss.str() == "Host");
+    }
+
+    void
+    testFields()
+    {
+        fields f;
+        f.insert(field::content_length, 42);
+        f.insert("connection", "close");
+        BEAST_EXPECT(f.exists(field::connection));
+        BEAST_EXPECT(f.count(field::content_length) == 1);
+        BEAST_EXPECT(f[field::connection] == "close");
+        BEAST_EXPECT(f["Content-Length"] == "42");
+        BEAST_EXPECT(f.find(field::content_length)->name() ==
+            "Content-Length");
+        f.replace(field::connection, "keep-alive");
+        BEAST_EXPECT(f[field::connection] == "keep-alive");
+        BEAST_EXPECT(f.erase(field::content_length) == 1);
+        BEAST_EXPECT(! f.exists(field::content_length));
+    }
+
+    void
+    run() override
+    {
+        testTable();
+        testNames();
+        testFields();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(field,http,beast);
+
+} // http
+} // beast
@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/http/fields.hpp>
+#include <beast/http/flat_fields.hpp>
+#include <beast/core/streambuf.hpp>
+#include <beast/core/write_dynabuf.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace beast {
+namespace http {
+
+class fields_bench_test : public beast::unit_test::suite
+{
+public:
+    static std::size_t constexpr N = 100000;
+
+    using field_list =
+        std::vector<std::pair<std::string, std::string>>;
+
+    field_list list_;
+    std::vector<std::string> keys_;
+    std::vector<field> ids_;
+
+    fields_bench_test()
+    {
+        // A typical browser request
+        list_ = {
+            {"Host", "www.example.com"},
+            {"Connection", "keep-alive"},
+            {"Cache-Control", "max-age=0"},
+            {"Upgrade-Insecure-Requests", "1"},
+            {"User-Agent", "Mozilla/5.0 (X11; Linux x86_64) "
+                "AppleWebKit/537.36 (KHTML, like Gecko) "
+                "Chrome/56.0.2924.87 Safari/537.36"},
+            {"Accept", "text/html,application/xhtml+xml,"
+                "application/xml;q=0.9,image/webp,*/*;q=0.8"},
+            {"Accept-Encoding", "gzip, deflate, sdch, br"},
+            {"Accept-Language", "en-US,en;q=0.8"},
+            {"Cookie", "session=0123456789abcdef; theme=dark"},
+            {"If-None-Match", "\"5f1b-5474aa8e47a40\""},
+            {"If-Modified-Since", "Mon, 13 Feb 2017 19:49:25 GMT"},
+        };
+        // Lookups done by a typical server
+        keys_ = {
+            "host", "Content-Length", "Transfer-Encoding",
+            "connection", "upgrade", "expect", "Cookie",
+            "accept-encoding", "If-None-Match", "Authorization",
+        };
+        for(auto const& key : keys_)
+            ids_.push_back(string_to_field(key));
+    }
+
+    template<class Function>
+    void
+    timedTest(std::size_t repeat, std::string const& name, Function&& f)
+    {
+        using namespace std::chrono;
+        using clock_type = std::chrono::high_resolution_clock;
+        log << name << std::endl;
+        for(std::size_t trial = 1; trial <= repeat; ++trial)
+        {
+            auto const t0 = clock_type::now();
+            f();
+            auto const elapsed = clock_type::now() - t0;
+            log <<
+                "Trial " << trial << ": " <<
+                duration_cast<milliseconds>(elapsed).count() << " ms" << std::endl;
+        }
+    }
+
+    // Build a fresh container for every message
+    template<class Fields>
+    std::size_t
+    build()
+    {
+        std::size_t n = 0;
+        for(std::size_t i = 0; i < N; ++i)
+        {
+            Fields f;
+            for(auto const& e : list_)
+                f.insert(e.first, e.second);
+            n += f.size();
+        }
+        return n;
+    }
+
+    // Reuse one container for every message
+    template<class Fields>
+    std::size_t
+    rebuild()
+    {
+        std::size_t n = 0;
+        Fields f;
+        for(std::size_t i = 0; i < N; ++i)
+        {
+            f.clear();
+            for(auto const& e : list_)
+                f.insert(e.first, e.second);
+            n += f.size();
+        }
+        return n;
+    }
+
+    template<class Fields>
+    std::size_t
+    lookup()
+    {
+        Fields f;
+        for(auto const& e : list_)
+            f.insert(e.first, e.second);
+        std::size_t n = 0;
+        for(std::size_t i = 0; i < N; ++i)
+            for(auto const& key : keys_)
+                n += f[key].size();
+        return n;
+    }
+
+    template<class Fields>
+    std::size_t
+    lookup_id()
+    {
+        Fields f;
+        for(auto const& e : list_)
+            f.insert(e.first, e.second);
+        std::size_t n = 0;
+        for(std::size_t i = 0; i < N; ++i)
+            for(auto const id : ids_)
+                n += f[id].size();
+        return n;
+    }
+
+    template<class Fields>
+    std::size_t
+    serialize()
+    {
+        Fields f;
+        for(auto const& e : list_)
+            f.insert(e.first, e.second);
+        std::size_t n = 0;
+        streambuf sb;
+        for(std::size_t i = 0; i < N; ++i)
+        {
+            for(auto const& field : f)
+            {
+                write(sb, field.name());
+                write(sb, ": ");
+                write(sb, field.value());
+                write(sb, "\r\n");
+            }
+            n += sb.size();
+            sb.consume(sb.size());
+        }
+        return n;
+    }
+
+    template<class Fields>
+    void
+    testFields(std::string const& name)
+    {
+        static std::size_t constexpr Trials = 3;
+        std::size_t n = 0;
+        timedTest(Trials, name + " build",
+            [&]{ n += build<Fields>(); });
+        timedTest(Trials, name + " rebuild",
+            [&]{ n += rebuild<Fields>(); });
+        timedTest(Trials, name + " lookup",
+            [&]{ n += lookup<Fields>(); });
+        timedTest(Trials, name + " lookup by id",
+            [&]{ n += lookup_id<Fields>(); });
+        timedTest(Trials, name + " serialize",
+            [&]{ n += serialize<Fields>(); });
+        BEAST_EXPECT(n > 0);
+    }
+
+    void
+    testSpeed()
+    {
+        testcase << "Fields speed test, " <<
+            N << " messages of " << list_.size() << " fields";
+        testFields<fields>("http::fields");
+        testFields<flat_fields>("http::flat_fields");
+    }
+
+    void run() override
+    {
+        pass();
+        testSpeed();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(fields_bench,http,beast);
+
+} // http
+} // beast
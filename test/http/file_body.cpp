@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/file_body.hpp>
+
+#include <beast/http/detail/sendfile.hpp>
+#include <beast/http/fields.hpp>
+#include <beast/http/write.hpp>
+#include <beast/test/string_ostream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace beast {
+namespace http {
+
+class file_body_test : public beast::unit_test::suite
+{
+public:
+    boost::filesystem::path path_;
+    std::string data_;
+
+    file_body_test()
+    {
+        path_ = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path();
+        // Larger than a socket buffer, and not a
+        // multiple of the writer's buffer size
+        data_.resize(300001);
+        for(std::size_t i = 0; i < data_.size(); ++i)
+            data_[i] = "0123456789abcdef"[(i * 7 + i / 13) % 16];
+        std::ofstream os{path_.string(), std::ios::binary};
+        os.write(data_.data(), data_.size());
+    }
+
+    ~file_body_test()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_, ec);
+    }
+
+    using response_type = response<file_body, fields>;
+
+    response_type
+    make_response()
+    {
+        response_type m;
+        m.version = 11;
+        m.status = 200;
+        m.reason = "OK";
+        m.body.open(path_.string());
+        return m;
+    }
+
+    static
+    std::string
+    header(std::size_t n)
+    {
+        return
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: " + std::to_string(n) + "\r\n"
+            "\r\n";
+    }
+
+    void
+    testValue()
+    {
+        file_body::value_type v;
+        BEAST_EXPECT(v.size() == 0);
+        error_code ec;
+        v.open((path_.string() + ".missing"), ec);
+        BEAST_EXPECT(ec);
+        BEAST_EXPECT(v.path().empty());
+        ec = {};
+        v.open(path_.string(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(v.path() == path_.string());
+        BEAST_EXPECT(v.file_size() == data_.size());
+        BEAST_EXPECT(v.offset() == 0);
+        BEAST_EXPECT(v.size() == data_.size());
+        v.range(100, 50);
+        BEAST_EXPECT(v.offset() == 100);
+        BEAST_EXPECT(v.size() == 50);
+        v.range(data_.size(), 0);
+        BEAST_EXPECT(v.size() == 0);
+        try
+        {
+            v.range(data_.size() - 1, 2);
+            fail();
+        }
+        catch(std::out_of_range const&)
+        {
+            pass();
+        }
+    }
+
+    // Writes through the Writer, the stream is not a socket
+    void
+    testWriter()
+    {
+        boost::asio::io_service ios;
+        {
+            auto m = make_response();
+            m.fields.insert("Content-Length", data_.size());
+            test::string_ostream ss{ios};
+            write(ss, m);
+            BEAST_EXPECT(ss.str == header(data_.size()) + data_);
+        }
+        {
+            auto m = make_response();
+            m.body.range(70000, 70000);
+            m.fields.insert("Content-Length", 70000);
+            test::string_ostream ss{ios};
+            write(ss, m);
+            BEAST_EXPECT(ss.str ==
+                header(70000) + data_.substr(70000, 70000));
+        }
+        {
+            auto m = make_response();
+            m.body.range(5, 0);
+            m.fields.insert("Content-Length", 0);
+            test::string_ostream ss{ios};
+            write(ss, m);
+            BEAST_EXPECT(ss.str == header(0));
+        }
+        {
+            auto m = make_response();
+            m.body.range(0, 3);
+            m.fields.insert("Transfer-Encoding", "chunked");
+            test::string_ostream ss{ios};
+            write(ss, m);
+            BEAST_EXPECT(ss.str ==
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "3\r\n" + data_.substr(0, 3) + "\r\n"
+                "0\r\n\r\n");
+        }
+        {
+            response_type m;
+            m.version = 11;
+            m.status = 200;
+            m.reason = "OK";
+            m.body.open(path_.string());
+            prepare(m);
+            BEAST_EXPECT(m.fields["Content-Length"] ==
+                std::to_string(data_.size()));
+        }
+    }
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    using socket_type =
+        boost::asio::local::stream_protocol::socket;
+
+    static
+    std::string
+    read_all(socket_type& sock)
+    {
+        std::string s;
+        char buf[8192];
+        error_code ec;
+        for(;;)
+        {
+            auto const n = sock.read_some(
+                boost::asio::buffer(buf), ec);
+            if(ec)
+                break;
+            s.append(buf, n);
+        }
+        return s;
+    }
+
+    // Sends the file with sendfile, where supported
+    void
+    testSocket()
+    {
+        BEAST_EXPECT((detail::can_sendfile<socket_type,
+            file_body::writer>::value == BEAST_HTTP_SENDFILE));
+        BEAST_EXPECT((! detail::can_sendfile<test::string_ostream,
+            file_body::writer>::value));
+        {
+            boost::asio::io_service ios;
+            socket_type s1{ios};
+            socket_type s2{ios};
+            boost::asio::local::connect_pair(s1, s2);
+            auto m = make_response();
+            m.body.range(1, data_.size() - 2);
+            m.fields.insert("Content-Length", data_.size() - 2);
+            std::thread t{
+                [&]
+                {
+                    write(s1, m);
+                    s1.close();
+                }};
+            auto const s = read_all(s2);
+            t.join();
+            BEAST_EXPECT(s == header(data_.size() - 2) +
+                data_.substr(1, data_.size() - 2));
+        }
+        {
+            boost::asio::io_service ios;
+            socket_type s1{ios};
+            socket_type s2{ios};
+            boost::asio::local::connect_pair(s1, s2);
+            auto m = make_response();
+            m.fields.insert("Content-Length", data_.size());
+            error_code result;
+            async_write(s1, m,
+                [&](error_code ec)
+                {
+                    result = ec;
+                    s1.close();
+                });
+            std::thread t{[&]{ ios.run(); }};
+            auto const s = read_all(s2);
+            t.join();
+            BEAST_EXPECTS(! result, result.message());
+            BEAST_EXPECT(s == header(data_.size()) + data_);
+        }
+    }
+#endif
+
+    void
+    run() override
+    {
+        testValue();
+        testWriter();
+    #if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        testSocket();
+    #endif
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(file_body,http,beast);
+
+} // http
+} // beast
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/http/file_body.hpp>
+#include <beast/http/fields.hpp>
+#include <beast/http/write.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace beast {
+namespace http {
+
+class file_body_bench_test : public beast::unit_test::suite
+{
+public:
+    static std::size_t constexpr Size = 64 * 1024 * 1024;
+    static std::size_t constexpr Repeat = 8;
+
+    // The file body from the examples before file_body was
+    // added: 4KB blocks are read with fread and then written.
+    struct fread_body
+    {
+        using value_type = std::string;
+
+        class writer
+        {
+            std::uint64_t size_ = 0;
+            std::uint64_t offset_ = 0;
+            std::string const& path_;
+            FILE* file_ = nullptr;
+            char buf_[4096];
+
+        public:
+            template<bool isRequest, class Fields>
+            explicit
+            writer(message<isRequest, fread_body, Fields> const& m) noexcept
+                : path_(m.body)
+            {
+            }
+
+            ~writer()
+            {
+                if(file_)
+                    fclose(file_);
+            }
+
+            void
+            init(error_code& ec) noexcept
+            {
+                file_ = fopen(path_.c_str(), "rb");
+                if(! file_)
+                    ec = boost::system::errc::make_error_code(
+                        boost::system::errc::no_such_file_or_directory);
+                else
+                    size_ = boost::filesystem::file_size(path_);
+            }
+
+            template<class WriteFunction>
+            boost::tribool
+            write(resume_context&&, error_code&,
+                WriteFunction&& wf) noexcept
+            {
+                auto const n = fread(buf_, 1, sizeof(buf_), file_);
+                offset_ += n;
+                wf(boost::asio::buffer(buf_, n));
+                return offset_ >= size_;
+            }
+        };
+    };
+
+    boost::filesystem::path path_;
+
+    file_body_bench_test()
+    {
+        path_ = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path();
+        std::string s;
+        s.resize(1024 * 1024);
+        for(std::size_t i = 0; i < s.size(); ++i)
+            s[i] = static_cast<char>(i * 31);
+        std::ofstream os{path_.string(), std::ios::binary};
+        for(std::size_t i = 0; i < Size / s.size(); ++i)
+            os.write(s.data(), s.size());
+    }
+
+    ~file_body_bench_test()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_, ec);
+    }
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    using socket_type =
+        boost::asio::local::stream_protocol::socket;
+
+    // Send the message Repeat times, and drain the other end
+    template<class Body, class Init>
+    void
+    transfer(std::string const& name, Init const& init)
+    {
+        using namespace std::chrono;
+        using clock_type = std::chrono::high_resolution_clock;
+        boost::asio::io_service ios;
+        socket_type s1{ios};
+        socket_type s2{ios};
+        boost::asio::local::connect_pair(s1, s2);
+        std::uint64_t total = 0;
+        std::thread t{
+            [&]
+            {
+                char buf[65536];
+                error_code ec;
+                for(;;)
+                {
+                    auto const n = s2.read_some(
+                        boost::asio::buffer(buf), ec);
+                    if(ec)
+                        break;
+                    total += n;
+                }
+            }};
+        auto const t0 = clock_type::now();
+        for(std::size_t i = 0; i < Repeat; ++i)
+        {
+            response<Body, fields> m;
+            m.version = 11;
+            m.status = 200;
+            m.reason = "OK";
+            m.fields.insert("Content-Length", std::to_string(Size));
+            init(m.body);
+            error_code ec;
+            write(s1, m, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                break;
+        }
+        s1.shutdown(socket_type::shutdown_send);
+        t.join();
+        auto const elapsed = clock_type::now() - t0;
+        auto const ms = duration_cast<milliseconds>(elapsed).count();
+        log << name << ": " << ms << " ms, " <<
+            (ms > 0 ? (total / 1024 / 1024 * 1000 / ms) : 0) <<
+                " MB/s" << std::endl;
+        BEAST_EXPECT(total >= Repeat * Size);
+    }
+
+    void
+    testSpeed()
+    {
+        static std::size_t constexpr Trials = 3;
+        testcase << "File body speed test, " <<
+            (Repeat * Size) / (1024 * 1024) << "MB per trial";
+        auto const path = path_.string();
+        for(std::size_t i = 0; i < Trials; ++i)
+            transfer<fread_body>("fread 4KB blocks",
+                [&](std::string& body)
+                {
+                    body = path;
+                });
+        for(std::size_t i = 0; i < Trials; ++i)
+            transfer<file_body>("http::file_body",
+                [&](file_body::value_type& body)
+                {
+                    body.open(path);
+                });
+    }
+#endif
+
+    void run() override
+    {
+        pass();
+    #if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        testSpeed();
+    #endif
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(file_body_bench,http,beast);
+
+} // http
+} // beast
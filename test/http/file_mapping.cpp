@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/file_mapping.hpp>
+
+#include <beast/unit_test/suite.hpp>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+namespace beast {
+namespace http {
+
+class file_mapping_test : public beast::unit_test::suite
+{
+public:
+    static
+    boost::filesystem::path
+    temp_path()
+    {
+        return boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path();
+    }
+
+    static
+    void
+    write_file(boost::filesystem::path const& path,
+        std::string const& s)
+    {
+        std::ofstream os{path.string(),
+            std::ios::binary | std::ios::trunc};
+        os.write(s.data(), s.size());
+    }
+
+    // Replace the file the way served files must be
+    static
+    void
+    replace_file(boost::filesystem::path const& path,
+        std::string const& s)
+    {
+        auto const tmp = temp_path();
+        write_file(tmp, s);
+        boost::filesystem::rename(tmp, path);
+    }
+
+    static
+    std::string
+    str(file_mapping const& m)
+    {
+        return {static_cast<char const*>(m.data()), m.size()};
+    }
+
+    void
+    testMapping()
+    {
+        auto const path = temp_path();
+        write_file(path, "Hello, world!");
+        {
+            error_code ec;
+            auto const m = file_mapping::open(path.string(), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(! BEAST_EXPECT(m))
+                return;
+            BEAST_EXPECT(str(*m) == "Hello, world!");
+            BEAST_EXPECT(boost::asio::buffer_size(
+                m->buffer()) == 13);
+        }
+        {
+            write_file(path, "");
+            error_code ec;
+            auto const m = file_mapping::open(path.string(), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(m))
+                BEAST_EXPECT(m->size() == 0);
+        }
+        {
+            error_code ec;
+            auto const m = file_mapping::open(
+                path.string() + ".missing", ec);
+            BEAST_EXPECT(ec);
+            BEAST_EXPECT(! m);
+        }
+        boost::filesystem::remove(path);
+    }
+
+    void
+    testCache()
+    {
+        auto const path = temp_path();
+        write_file(path, "1234");
+        file_mapping_cache cache;
+        error_code ec;
+        auto const m1 = cache.get(path.string(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        auto const m2 = cache.get(path.string(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        if(! BEAST_EXPECT(m1 && m2))
+            return;
+        BEAST_EXPECT(m1 == m2);
+        BEAST_EXPECT(cache.size() == 4);
+
+        // A replaced file is mapped again
+        replace_file(path, "123456");
+        boost::filesystem::last_write_time(path,
+            boost::filesystem::last_write_time(path) + 10);
+        auto const m3 = cache.get(path.string(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        if(! BEAST_EXPECT(m3))
+            return;
+        BEAST_EXPECT(m3 != m1);
+        BEAST_EXPECT(str(*m3) == "123456");
+        BEAST_EXPECT(cache.size() == 6);
+        // The old mapping is still valid
+        BEAST_EXPECT(str(*m1) == "1234");
+
+        cache.clear();
+        BEAST_EXPECT(cache.size() == 0);
+        auto const m4 = cache.get(path.string(), ec);
+        BEAST_EXPECT(m4 && m4 != m3);
+
+        // A change of size alone is noticed
+        auto const t = boost::filesystem::last_write_time(path);
+        write_file(path, "12345678");
+        boost::filesystem::last_write_time(path, t);
+        auto const m5 = cache.get(path.string(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        if(BEAST_EXPECT(m5))
+            BEAST_EXPECT(str(*m5) == "12345678");
+
+        cache.get(path.string() + ".missing", ec);
+        BEAST_EXPECT(ec);
+        boost::filesystem::remove(path);
+    }
+
+    void
+    testEvict()
+    {
+        auto const p1 = temp_path();
+        auto const p2 = temp_path();
+        auto const p3 = temp_path();
+        write_file(p1, std::string(40, '1'));
+        write_file(p2, std::string(40, '2'));
+        write_file(p3, std::string(200, '3'));
+        file_mapping_cache cache{100};
+        error_code ec;
+        {
+            auto const m1 = cache.get(p1.string(), ec);
+            BEAST_EXPECT(cache.size() == 40);
+            auto const m2 = cache.get(p2.string(), ec);
+            BEAST_EXPECT(cache.size() == 80);
+            // Larger than the limit, not cached
+            auto const m3 = cache.get(p3.string(), ec);
+            BEAST_EXPECT(m3 && m3->size() == 200);
+            BEAST_EXPECT(cache.size() == 80);
+            BEAST_EXPECT(cache.get(p3.string(), ec) != m3);
+        }
+        // Nothing is in use, so the oldest entries go
+        write_file(p3, std::string(60, '3'));
+        auto const m3 = cache.get(p3.string(), ec);
+        BEAST_EXPECT(cache.size() <= 100);
+        BEAST_EXPECT(cache.get(p3.string(), ec) == m3);
+        boost::filesystem::remove(p1);
+        boost::filesystem::remove(p2);
+        boost::filesystem::remove(p3);
+    }
+
+    void
+    testGlobal()
+    {
+        BEAST_EXPECT(&file_mapping_cache::global() ==
+            &file_mapping_cache::global());
+    }
+
+    void
+    run() override
+    {
+        testMapping();
+        testCache();
+        testEvict();
+        testGlobal();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(file_mapping,http,beast);
+
+} // http
+} // beast
@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/header_block.hpp>
+
+#include <beast/http/detail/header_buffer.hpp>
+#include <beast/http/fields.hpp>
+#include <beast/http/flat_fields.hpp>
+#include <beast/core/to_string.hpp>
+#include <beast/unit_test/suite.hpp>
+
+namespace beast {
+namespace http {
+
+class header_block_test : public beast::unit_test::suite
+{
+public:
+    template<bool isRequest, class Fields>
+    static
+    std::string
+    str(header<isRequest, Fields> const& h)
+    {
+        return to_string(detail::header_buffer{h}.data());
+    }
+
+    void
+    testBlock()
+    {
+        header_block b0;
+        BEAST_EXPECT(b0.empty());
+        BEAST_EXPECT(b0.size() == 0);
+        BEAST_EXPECT(boost::asio::buffer_size(b0.data()) == 0);
+
+        fields f;
+        f.insert("Server", "test");
+        f.insert("X-Empty", "");
+        header_block const b1{f};
+        BEAST_EXPECT(! b1.empty());
+        BEAST_EXPECT(to_string(b1.data()) ==
+            "Server: test\r\nX-Empty: \r\n");
+        BEAST_EXPECT(b1.size() == 25);
+        auto const b2 = b1;
+        BEAST_EXPECT(boost::asio::buffer_cast<void const*>(b2.data()) ==
+            boost::asio::buffer_cast<void const*>(b1.data()));
+    }
+
+    void
+    testBuffer()
+    {
+        {
+            header<true, fields> h;
+            h.version = 11;
+            h.method = "GET";
+            h.url = "/";
+            BEAST_EXPECT(str(h) == "GET / HTTP/1.1\r\n\r\n");
+            h.version = 10;
+            h.fields.insert("Host", "localhost");
+            BEAST_EXPECT(str(h) ==
+                "GET / HTTP/1.0\r\nHost: localhost\r\n\r\n");
+        }
+        {
+            header<false, flat_fields> h;
+            h.version = 11;
+            h.status = 200;
+            h.reason = "OK";
+            h.fields.insert(field::content_length, 0);
+            BEAST_EXPECT(str(h) ==
+                "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+            h.status = 0;
+            h.reason = "";
+            BEAST_EXPECT(str(h) ==
+                "HTTP/1.1 0 \r\nContent-Length: 0\r\n\r\n");
+            h.status = 1000;
+            BEAST_EXPECT(str(h) ==
+                "HTTP/1.1 1000 \r\nContent-Length: 0\r\n\r\n");
+        }
+        {
+            fields f;
+            f.insert("Server", "test");
+            header<false, prebuilt_fields<fields>> h;
+            h.version = 11;
+            h.status = 404;
+            h.reason = "Not Found";
+            h.fields.insert("Content-Length", "0");
+            BEAST_EXPECT(str(h) ==
+                "HTTP/1.1 404 Not Found\r\n"
+                "Content-Length: 0\r\n\r\n");
+            h.fields.prebuilt(header_block{f});
+            BEAST_EXPECT(h.fields["Content-Length"] == "0");
+            BEAST_EXPECT(str(h) ==
+                "HTTP/1.1 404 Not Found\r\n"
+                "Server: test\r\n"
+                "Content-Length: 0\r\n\r\n");
+
+            // Partial consumption across every buffer
+            auto const s = str(h);
+            for(std::size_t i = 0; i <= s.size(); ++i)
+            {
+                detail::header_buffer hb{h};
+                hb.consume(i);
+                BEAST_EXPECT(hb.size() == s.size() - i);
+                if(! BEAST_EXPECT(
+                        to_string(hb.data()) == s.substr(i)))
+                    break;
+            }
+        }
+    }
+
+    void
+    run() override
+    {
+        testBlock();
+        testBuffer();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(header_block,http,beast);
+
+} // http
+} // beast
@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/header_view_parser_v1.hpp>
+
+#include <beast/unit_test/suite.hpp>
+#include <boost/asio/buffer.hpp>
+#include <iterator>
+#include <string>
+
+namespace beast {
+namespace http {
+
+class header_view_parser_v1_test : public beast::unit_test::suite
+{
+public:
+    void testRequest()
+    {
+        std::string const s =
+            "GET /index.html HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "User-Agent: test \r\n"
+            "x-Empty:\r\n"
+            "Accept: text/html\r\n"
+            "Accept: */*\r\n"
+            "\r\n"
+            "*****";
+        error_code ec;
+        header_view_parser_v1<true> p;
+        auto const n = p.write(boost::asio::buffer(s), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.complete());
+        BEAST_EXPECT(n == s.size() - 5);
+        BEAST_EXPECT(p.fields().size() == 5);
+        auto const v = p.view(s.data());
+        BEAST_EXPECT(v.method() == "GET");
+        BEAST_EXPECT(v.url() == "/index.html");
+        BEAST_EXPECT(v.size() == 5);
+        BEAST_EXPECT(v["host"] == "example.com");
+        BEAST_EXPECT(v["USER-AGENT"] == "test");
+        BEAST_EXPECT(v.exists("X-Empty"));
+        BEAST_EXPECT(v["X-Empty"].empty());
+        BEAST_EXPECT(v["Accept"] == "text/html");
+        BEAST_EXPECT(v.count("Accept") == 2);
+        BEAST_EXPECT(! v.exists("Accept-Encoding"));
+        BEAST_EXPECT(! v.exists("Accep"));
+        std::string names;
+        for(auto const& e : v)
+        {
+            names.append(e.name().data(), e.name().size());
+            names.push_back(';');
+        }
+        BEAST_EXPECT(names == "Host;User-Agent;x-Empty;Accept;Accept;");
+
+        // views point into the input
+        BEAST_EXPECT(v["Host"].data() == s.data() + 32);
+
+        // iterators outlive the view they came from
+        auto const it = p.view(s.data()).find("User-Agent");
+        auto const last = p.view(s.data()).end();
+        BEAST_EXPECT(it != last);
+        BEAST_EXPECT(it->value() == "test");
+        BEAST_EXPECT(std::next(it)->name() == "x-Empty");
+    }
+
+    void testResponse()
+    {
+        std::string const s =
+            "HTTP/1.1 404 Not Found\r\n"
+            "Server: test\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n";
+        error_code ec;
+        header_view_parser_v1<false> p;
+        p.write(boost::asio::buffer(s), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.complete());
+        BEAST_EXPECT(p.status_code() == 404);
+        auto const v = p.view(boost::asio::buffer(s));
+        BEAST_EXPECT(v.reason() == "Not Found");
+        BEAST_EXPECT(v["server"] == "test");
+        BEAST_EXPECT(v["content-length"] == "0");
+    }
+
+    void testSplit()
+    {
+        std::string const s =
+            "POST /upload HTTP/1.1\r\n"
+            "Content-Type: application/octet-stream\r\n"
+            "X-Folded: one\r\n two\r\n"
+            "Content-Length: 3\r\n"
+            "\r\n";
+        for(std::size_t i = 0; i <= s.size(); ++i)
+        {
+            error_code ec;
+            header_view_parser_v1<true> p;
+            auto n = p.write(boost::asio::buffer(s.data(), i), ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                break;
+            BEAST_EXPECT(n == i);
+            n = p.write(boost::asio::buffer(
+                s.data() + i, s.size() - i), ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                break;
+            BEAST_EXPECT(p.complete());
+            auto const v = p.view(s.data());
+            BEAST_EXPECT(v.method() == "POST");
+            BEAST_EXPECT(v.url() == "/upload");
+            BEAST_EXPECT(v.size() == 3);
+            BEAST_EXPECT(v["Content-Type"] ==
+                "application/octet-stream");
+            BEAST_EXPECT(v["X-Folded"] == "one\r\n two");
+            BEAST_EXPECT(v["Content-Length"] == "3");
+        }
+    }
+
+    void testReuse()
+    {
+        std::string const s1 =
+            "GET / HTTP/1.1\r\n"
+            "A: 1\r\nB: 2\r\nC: 3\r\nD: 4\r\n"
+            "\r\n";
+        std::string const s2 =
+            "GET /x HTTP/1.1\r\n"
+            "E: 5\r\n"
+            "\r\n";
+        error_code ec;
+        header_view_parser_v1<true> p{16};
+        auto const cap = p.fields().capacity();
+        BEAST_EXPECT(cap >= 16);
+        p.write(boost::asio::buffer(s1), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.complete());
+        BEAST_EXPECT(p.view(s1.data())["D"] == "4");
+        p.reset();
+        BEAST_EXPECT(! p.complete());
+        p.write(boost::asio::buffer(s2), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.complete());
+        auto const v = p.view(s2.data());
+        BEAST_EXPECT(v.url() == "/x");
+        BEAST_EXPECT(v.size() == 1);
+        BEAST_EXPECT(v["E"] == "5");
+        BEAST_EXPECT(p.fields().capacity() == cap);
+    }
+
+    void testBad()
+    {
+        error_code ec;
+        header_view_parser_v1<true> p;
+        p.write(boost::asio::buffer(
+            "GET / HTTP/1.1\r\n"
+            "F\x01: v\r\n"
+            "\r\n"), ec);
+        BEAST_EXPECT(ec == parse_error::bad_field);
+    }
+
+    void run() override
+    {
+        testRequest();
+        testResponse();
+        testSplit();
+        testReuse();
+        testBad();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(header_view_parser_v1,http,beast);
+
+} // http
+} // beast
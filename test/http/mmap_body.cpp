@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/http/mmap_body.hpp>
+
+#include <beast/http/fields.hpp>
+#include <beast/http/write.hpp>
+#include <beast/test/string_ostream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace beast {
+namespace http {
+
+class mmap_body_test : public beast::unit_test::suite
+{
+public:
+    boost::filesystem::path path_;
+    std::string data_;
+
+    mmap_body_test()
+    {
+        path_ = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path();
+        data_ = "<html><body>Hello, world!</body></html>";
+        std::ofstream os{path_.string(), std::ios::binary};
+        os.write(data_.data(), data_.size());
+    }
+
+    ~mmap_body_test()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_, ec);
+    }
+
+    // Counts the calls to write_some
+    class counting_stream : public test::string_ostream
+    {
+    public:
+        std::size_t writes = 0;
+
+        using test::string_ostream::string_ostream;
+
+        template<class ConstBufferSequence>
+        std::size_t
+        write_some(ConstBufferSequence const& buffers)
+        {
+            ++writes;
+            return test::string_ostream::write_some(buffers);
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        write_some(
+            ConstBufferSequence const& buffers, error_code& ec)
+        {
+            ++writes;
+            return test::string_ostream::write_some(buffers, ec);
+        }
+    };
+
+    void
+    testValue()
+    {
+        mmap_body::value_type v;
+        BEAST_EXPECT(v.size() == 0);
+        BEAST_EXPECT(boost::asio::buffer_size(v.data()) == 0);
+        error_code ec;
+        v = file_mapping::open(path_.string(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(v.size() == data_.size());
+        v.range(6, 6);
+        BEAST_EXPECT(v.offset() == 6);
+        BEAST_EXPECT(v.size() == 6);
+        BEAST_EXPECT(boost::asio::buffer_size(v.data()) == 6);
+        try
+        {
+            v.range(data_.size(), 1);
+            fail();
+        }
+        catch(std::out_of_range const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testWrite()
+    {
+        boost::asio::io_service ios;
+        error_code ec;
+        {
+            response<mmap_body, fields> m;
+            m.version = 11;
+            m.status = 200;
+            m.reason = "OK";
+            m.body = file_mapping::open(path_.string(), ec);
+            prepare(m);
+            counting_stream ss{ios};
+            write(ss, m);
+            BEAST_EXPECT(ss.str ==
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: " +
+                    std::to_string(data_.size()) + "\r\n"
+                "\r\n" + data_);
+            // Header and body were gathered
+            BEAST_EXPECT(ss.writes == 1);
+        }
+        {
+            response<mmap_body, fields> m;
+            m.version = 11;
+            m.status = 206;
+            m.reason = "Partial Content";
+            m.body = file_mapping_cache::global().get(
+                path_.string(), ec);
+            m.body.range(12, 13);
+            prepare(m);
+            counting_stream ss{ios};
+            write(ss, m);
+            BEAST_EXPECT(ss.str ==
+                "HTTP/1.1 206 Partial Content\r\n"
+                "Content-Length: 13\r\n"
+                "\r\n"
+                "Hello, world!");
+            file_mapping_cache::global().clear();
+        }
+        {
+            response<mmap_body, fields> m;
+            m.version = 11;
+            m.status = 204;
+            m.reason = "No Content";
+            prepare(m);
+            counting_stream ss{ios};
+            write(ss, m);
+            BEAST_EXPECT(ss.str ==
+                "HTTP/1.1 204 No Content\r\n"
+                "\r\n");
+        }
+    }
+
+    void
+    run() override
+    {
+        testValue();
+        testWrite();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(mmap_body,http,beast);
+
+} // http
+} // beast
@@ -51,6 +51,8 @@ public:
         check("http", parse_error::header_too_big);
         check("http", parse_error::body_too_big);
         check("http", parse_error::short_read);
+        check("http", parse_error::unknown_content_coding);
+        check("http", parse_error::bad_content_coding);
     }
 };
 
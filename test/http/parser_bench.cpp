@@ -9,6 +9,8 @@
 #include "message_fuzz.hpp"
 
 #include <beast/http.hpp>
+#include <beast/core/detail/cpu_info.hpp>
+#include <beast/core/flat_buffer.hpp>
 #include <beast/core/streambuf.hpp>
 #include <beast/core/to_string.hpp>
 #include <beast/unit_test/suite.hpp>
@@ -25,15 +27,32 @@ public:
     static std::size_t constexpr N = 2000;
 
     using corpus = std::vector<streambuf>;
+    using flat_corpus = std::vector<flat_buffer>;
 
     corpus creq_;
     corpus cres_;
+    flat_corpus freq_;
+    flat_corpus fres_;
     std::size_t size_ = 0;
 
     parser_bench_test()
     {
         creq_ = build_corpus(N/2, std::true_type{});
         cres_ = build_corpus(N/2, std::false_type{});
+        freq_ = flatten(creq_);
+        fres_ = flatten(cres_);
+    }
+
+    static
+    flat_corpus
+    flatten(corpus const& v)
+    {
+        flat_corpus fv;
+        fv.resize(v.size());
+        for(std::size_t i = 0; i < v.size(); ++i)
+            fv[i].commit(boost::asio::buffer_copy(
+                fv[i].prepare(v[i].size()), v[i].data()));
+        return fv;
     }
 
     corpus
@@ -64,9 +83,9 @@ public:
         return v;
     }
 
-    template<class Parser>
+    template<class Parser, class Corpus>
     void
-    testParser(std::size_t repeat, corpus const& v)
+    testParser(std::size_t repeat, Corpus const& v)
     {
         while(repeat--)
             for(auto const& sb : v)
@@ -114,6 +133,14 @@ public:
         log << "sizeof(response parser) == " <<
             sizeof(basic_parser_v1<false, null_parser<true>>)<< '\n';
 
+        {
+            auto const& ci = beast::detail::get_cpu_info();
+            log << "header scanner          == " << (
+                BEAST_DETAIL_X86 && ci.avx2 ? "avx2" :
+                BEAST_DETAIL_X86 && ci.sse2 ? "sse2" :
+                    "scalar") << '\n';
+        }
+
         testcase << "Parser speed test, " <<
             ((Repeat * size_ + 512) / 1024) << "KB in " <<
                 (Repeat * (creq_.size() + cres_.size())) << " messages";
@@ -138,6 +165,26 @@ public:
                     false, streambuf_body, fields>>(
                         Repeat, cres_);
             });
+        timedTest(Trials, "http::basic_parser_v1, flat_fields",
+            [&]
+            {
+                testParser<parser_v1<
+                    true, streambuf_body, flat_fields>>(
+                        Repeat, creq_);
+                testParser<parser_v1<
+                    false, streambuf_body, flat_fields>>(
+                        Repeat, cres_);
+            });
+        timedTest(Trials, "http::basic_parser_v1, flat_buffer",
+            [&]
+            {
+                testParser<parser_v1<
+                    true, streambuf_body, fields>>(
+                        Repeat, freq_);
+                testParser<parser_v1<
+                    false, streambuf_body, fields>>(
+                        Repeat, fres_);
+            });
         pass();
     }
 
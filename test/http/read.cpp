@@ -10,6 +10,9 @@
 
 #include "fail_parser.hpp"
 
+#include <beast/core/flat_buffer.hpp>
+#include <beast/core/mirrored_buffer.hpp>
+#include <beast/core/to_string.hpp>
 #include <beast/http/fields.hpp>
 #include <beast/http/streambuf_body.hpp>
 #include <beast/test/fail_stream.hpp>
@@ -374,14 +377,74 @@ public:
         }
     }
 
+    void testFlatBuffer(yield_context do_yield)
+    {
+        // The header straddles many reads
+        std::string const s =
+            "GET / HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "User-Agent: test\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "*****";
+        {
+            test::string_istream ss(ios_, s, 3);
+            flat_buffer fb;
+            request<streambuf_body> m;
+            read(ss, fb, m);
+            BEAST_EXPECT(m.fields["User-Agent"] == "test");
+            BEAST_EXPECT(to_string(m.body.data()) == "*****");
+        }
+        {
+            test::string_istream ss(ios_, s, 3);
+            flat_buffer fb;
+            request<streambuf_body> m;
+            error_code ec;
+            async_read(ss, fb, m, do_yield[ec]);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(m.fields["User-Agent"] == "test");
+            BEAST_EXPECT(to_string(m.body.data()) == "*****");
+        }
+    }
+
+    void testMirroredBuffer()
+    {
+        // Several messages on one connection, so
+        // the buffer wraps around its end.
+        std::string s;
+        for(int i = 0; i < 200; ++i)
+            s.append(
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "User-Agent: test\r\n"
+                "Content-Length: 5\r\n"
+                "\r\n"
+                "*****");
+        test::string_istream ss(ios_, s, 1000);
+        mirrored_buffer mb{4096};
+        for(int i = 0; i < 200; ++i)
+        {
+            request<streambuf_body> m;
+            error_code ec;
+            read(ss, mb, m, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                break;
+            BEAST_EXPECT(m.fields["Host"] == "localhost");
+            BEAST_EXPECT(to_string(m.body.data()) == "*****");
+        }
+        BEAST_EXPECT(mb.size() == 0);
+    }
+
     void run() override
     {
         testThrow();
+        testMirroredBuffer();
 
         yield_to(&read_test::testFailures, this);
         yield_to(&read_test::testReadHeaders, this);
         yield_to(&read_test::testRead, this);
         yield_to(&read_test::testEof, this);
+        yield_to(&read_test::testFlatBuffer, this);
     }
 };
 
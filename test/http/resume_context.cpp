@@ -7,3 +7,121 @@
 
 // Test that header file is self-contained.
 #include <beast/http/resume_context.hpp>
+
+#include <beast/unit_test/suite.hpp>
+#include <array>
+#include <memory>
+
+namespace beast {
+namespace http {
+
+class resume_context_test : public beast::unit_test::suite
+{
+public:
+    // Counts invocations and live copies
+    template<std::size_t N>
+    struct counter
+    {
+        std::shared_ptr<int> calls;
+        std::array<char, N> pad;
+
+        counter()
+            : calls(std::make_shared<int>(0))
+        {
+        }
+
+        void
+        operator()()
+        {
+            ++*calls;
+        }
+    };
+
+    template<std::size_t N>
+    void
+    testContext()
+    {
+        counter<N> c;
+        {
+            resume_context rc{c};
+            BEAST_EXPECT(rc);
+            BEAST_EXPECT(c.calls.use_count() == 2);
+            rc();
+            BEAST_EXPECT(*c.calls == 1);
+
+            // copy
+            auto rc2 = rc;
+            BEAST_EXPECT(c.calls.use_count() == 3);
+            rc2();
+            BEAST_EXPECT(*c.calls == 2);
+
+            // move
+            resume_context rc3{std::move(rc2)};
+            BEAST_EXPECT(! rc2);
+            BEAST_EXPECT(c.calls.use_count() == 3);
+            rc3();
+            BEAST_EXPECT(*c.calls == 3);
+
+            // assign
+            rc2 = rc3;
+            BEAST_EXPECT(c.calls.use_count() == 4);
+            rc2 = std::move(rc3);
+            BEAST_EXPECT(! rc3);
+            BEAST_EXPECT(c.calls.use_count() == 3);
+            rc3 = rc3;
+            BEAST_EXPECT(! rc3);
+            rc2 = rc2;
+            BEAST_EXPECT(rc2);
+            BEAST_EXPECT(c.calls.use_count() == 3);
+
+            // clear
+            rc2 = {};
+            BEAST_EXPECT(! rc2);
+            BEAST_EXPECT(c.calls.use_count() == 2);
+            rc = nullptr;
+            BEAST_EXPECT(! rc);
+        }
+        BEAST_EXPECT(c.calls.use_count() == 1);
+        BEAST_EXPECT(*c.calls == 3);
+    }
+
+    void
+    testEmpty()
+    {
+        resume_context rc;
+        BEAST_EXPECT(! rc);
+        resume_context rc2{nullptr};
+        BEAST_EXPECT(! rc2);
+        rc = rc2;
+        BEAST_EXPECT(! rc);
+        rc = std::move(rc2);
+        BEAST_EXPECT(! rc);
+    }
+
+    void
+    testLambda()
+    {
+        int n = 0;
+        resume_context rc{[&]{ ++n; }};
+        rc();
+        auto rc2 = rc;
+        rc2();
+        BEAST_EXPECT(n == 2);
+    }
+
+    void
+    run() override
+    {
+        testEmpty();
+        testLambda();
+        // stored inline
+        testContext<1>();
+        // stored on the heap
+        testContext<256>();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(resume_context,http,beast);
+
+} // http
+} // beast
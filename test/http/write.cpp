@@ -9,6 +9,7 @@
 #include <beast/http/write.hpp>
 
 #include <beast/http/fields.hpp>
+#include <beast/http/header_block.hpp>
 #include <beast/http/message.hpp>
 #include <beast/http/empty_body.hpp>
 #include <beast/http/string_body.hpp>
@@ -639,6 +640,60 @@ public:
         }
     }
 
+    void testPrebuilt()
+    {
+        fields f;
+        f.insert("Server", "test");
+        f.insert("Cache-Control", "no-cache");
+        header_block const block{f};
+        {
+            message<false, string_body, prebuilt_fields<fields>> m;
+            m.version = 11;
+            m.status = 200;
+            m.reason = "OK";
+            m.fields.prebuilt(block);
+            m.fields.insert("Content-Length", "1");
+            m.body = "*";
+            BEAST_EXPECT(str(m) ==
+                "HTTP/1.1 200 OK\r\n"
+                "Server: test\r\n"
+                "Cache-Control: no-cache\r\n"
+                "Content-Length: 1\r\n"
+                "\r\n"
+                "*"
+            );
+            // The block is shared, not copied
+            auto m2 = m;
+            m2.status = 404;
+            m2.reason = "Not Found";
+            BEAST_EXPECT(boost::asio::buffer_cast<void const*>(
+                m2.fields.prebuilt().data()) ==
+                    boost::asio::buffer_cast<void const*>(
+                        block.data()));
+            BEAST_EXPECT(str(m2) ==
+                "HTTP/1.1 404 Not Found\r\n"
+                "Server: test\r\n"
+                "Cache-Control: no-cache\r\n"
+                "Content-Length: 1\r\n"
+                "\r\n"
+                "*"
+            );
+        }
+        {
+            header<false, prebuilt_fields<fields>> h;
+            h.version = 10;
+            h.status = 204;
+            h.reason = "No Content";
+            h.fields.prebuilt(block);
+            BEAST_EXPECT(boost::lexical_cast<std::string>(h) ==
+                "HTTP/1.0 204 No Content\r\n"
+                "Server: test\r\n"
+                "Cache-Control: no-cache\r\n"
+                "\r\n"
+            );
+        }
+    }
+
     void run() override
     {
         yield_to(&write_test::testAsyncWriteHeaders, this);
@@ -647,6 +702,7 @@ public:
         testOutput();
         test_std_ostream();
         testOstream();
+        testPrebuilt();
     }
 };
 
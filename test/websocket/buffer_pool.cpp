@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/websocket/detail/buffer_pool.hpp>
+
+#include <beast/core/streambuf.hpp>
+#include <beast/core/to_string.hpp>
+#include <beast/test/string_istream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/websocket/stream.hpp>
+#include <boost/asio/io_service.hpp>
+#include <string>
+
+namespace beast {
+namespace test {
+
+// Nothing to tear down
+inline
+void
+teardown(websocket::teardown_tag, string_istream&, error_code&)
+{
+}
+
+} // test
+
+namespace websocket {
+namespace detail {
+
+class buffer_pool_test : public beast::unit_test::suite
+{
+public:
+    boost::asio::io_service ios_;
+
+    using ws_type = stream<test::string_istream>;
+
+    void
+    testPool()
+    {
+        auto& pool = buffer_pool::instance();
+        pool.limit(0);
+        pool.limit(2);
+        {
+            auto b1 = pool.get(4096);
+            auto b2 = pool.get(4096);
+            auto b3 = pool.get(4096);
+            BEAST_EXPECT(b1 && b2 && b3);
+            BEAST_EXPECT(pool.idle() == 0);
+        }
+        // Only up to the limit are kept
+        BEAST_EXPECT(pool.idle() == 2);
+        {
+            auto const p = pool.get(4096).get();
+            auto b = pool.get(4096);
+            BEAST_EXPECT(b.get() == p);
+            BEAST_EXPECT(pool.idle() == 1);
+        }
+        BEAST_EXPECT(pool.idle() == 2);
+        {
+            // Sizes must match
+            auto b = pool.get(100);
+            BEAST_EXPECT(pool.idle() == 2);
+        }
+        BEAST_EXPECT(pool.idle() == 2);
+        pool.limit(64);
+    }
+
+    // An upgrade request offering permessage-deflate
+    static
+    std::string
+    make_request()
+    {
+        return
+            "GET / HTTP/1.1\r\n"
+            "Host: localhost:80\r\n"
+            "Upgrade: WebSocket\r\n"
+            "Connection: upgrade\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+            "Sec-WebSocket-Version: 13\r\n"
+            "Sec-WebSocket-Extensions: permessage-deflate"
+                "; client_no_context_takeover"
+                "; server_no_context_takeover\r\n"
+            "\r\n";
+    }
+
+    // The request, then a compressed and an
+    // uncompressed message with a zero mask key
+    static
+    std::string
+    make_input()
+    {
+        auto s = make_request();
+        // "Hello" compressed, from rfc7692
+        static char const deflated[] = {
+            '\xc1', '\x87', 0, 0, 0, 0,
+            '\xf2', '\x48', '\xcd', '\xc9', '\xc9', '\x07', '\x00'};
+        static char const plain[] = {
+            '\x81', '\x85', 0, 0, 0, 0, 'H', 'e', 'l', 'l', 'o'};
+        s.append(deflated, sizeof(deflated));
+        s.append(plain, sizeof(plain));
+        return s;
+    }
+
+    void
+    testStream()
+    {
+        auto& pool = buffer_pool::instance();
+        pool.limit(0);
+        pool.limit(64);
+        // Read the request by itself
+        ws_type ws{ios_, make_input(), make_request().size()};
+        permessage_deflate pmd;
+        pmd.server_enable = true;
+        ws.set_option(pmd);
+        ws.accept();
+        BEAST_EXPECT(pool.idle() == 0);
+        {
+            // The read buffer is returned at the end of the
+            // message, then the write buffer reuses it
+            streambuf sb;
+            opcode op;
+            ws.read(op, sb);
+            BEAST_EXPECT(to_string(sb.data()) == "Hello");
+            BEAST_EXPECT(pool.idle() == 1);
+            ws.write(sb.data());
+            BEAST_EXPECT(pool.idle() == 1);
+        }
+        {
+            // Uncompressed messages need no read buffer
+            streambuf sb;
+            opcode op;
+            ws.read(op, sb);
+            BEAST_EXPECT(to_string(sb.data()) == "Hello");
+            BEAST_EXPECT(pool.idle() == 1);
+        }
+    }
+
+    void
+    run() override
+    {
+        testPool();
+        testStream();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(buffer_pool,websocket,beast);
+
+} // detail
+} // websocket
+} // beast
@@ -9,6 +9,9 @@
 #include <beast/websocket/detail/mask.hpp>
 
 #include <beast/unit_test/suite.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
 
 namespace beast {
 namespace websocket {
@@ -40,10 +43,233 @@ public:
         }
     };
 
+    // Byte at a time, the definition from rfc6455
+    static
+    void
+    mask_reference(std::uint8_t* p, std::size_t n,
+        std::size_t pos, std::uint32_t key)
+    {
+        for(std::size_t i = 0; i < n; ++i, ++pos)
+            p[i] ^= static_cast<std::uint8_t>(
+                key >> (8 * (pos % 4)));
+    }
+
+    struct kernel
+    {
+        char const* name;
+        mask_bulk_fn f;
+    };
+
+    static
+    std::vector<kernel>
+    kernels()
+    {
+        std::vector<kernel> v;
+        v.push_back({"scalar", &mask_bulk_scalar});
+    #if BEAST_DETAIL_X86
+        auto const& ci = beast::detail::get_cpu_info();
+        if(ci.sse2)
+            v.push_back({"sse2", &mask_bulk_sse2});
+        if(ci.avx2)
+            v.push_back({"avx2", &mask_bulk_avx2});
+    #endif
+        return v;
+    }
+
+    // Mask with a bulk kernel followed by the scalar leftovers,
+    // the same way mask_inplace does.
+    template<class KeyType>
+    static
+    void
+    mask_with(mask_bulk_fn f, std::uint8_t* p,
+        std::size_t n, KeyType& key)
+    {
+        auto const used = f(p, p, n,
+            static_cast<std::uint32_t>(key));
+        mask_inplace_fast(boost::asio::mutable_buffer{
+            p + used, n - used}, key);
+    }
+
+    template<class KeyType>
+    void
+    testKernel(kernel const& k)
+    {
+        std::uint32_t const key = 0xa1b2c3d4;
+        std::uint8_t src[300];
+        for(std::size_t i = 0; i < sizeof(src); ++i)
+            src[i] = static_cast<std::uint8_t>(i * 7 + 1);
+        std::uint8_t buf[300];
+        std::uint8_t ref[300];
+        for(std::size_t offset = 0; offset < 32; ++offset)
+        {
+            for(std::size_t n = 0; n + offset <= 260; ++n)
+            {
+                std::memcpy(buf, src, sizeof(buf));
+                std::memcpy(ref, src, sizeof(ref));
+                // Split into two pieces at every position modulo 4,
+                // so the second piece starts with a rotated key.
+                auto const split = n / 2 + n % 4;
+                auto const a = split < n ? split : n;
+                KeyType pk;
+                prepare_key(pk, key);
+                mask_with(k.f, buf + offset, a, pk);
+                mask_with(k.f, buf + offset + a, n - a, pk);
+                mask_reference(ref + offset, n, 0, key);
+                if(! BEAST_EXPECTS(std::memcmp(
+                        buf, ref, sizeof(buf)) == 0,
+                        std::string{k.name} + " offset=" +
+                        std::to_string(offset) + " n=" +
+                        std::to_string(n)))
+                    return;
+                KeyType pk2;
+                prepare_key(pk2, key);
+                pk2 = ror(pk2, static_cast<unsigned>(8 * n));
+                BEAST_EXPECT(pk == pk2);
+            }
+        }
+    }
+
+    void
+    testKernels()
+    {
+        for(auto const& k : kernels())
+        {
+            testcase << "kernel " << k.name;
+            testKernel<std::uint32_t>(k);
+            testKernel<std::uint64_t>(k);
+        }
+    }
+
+    void
+    testMaskInplace()
+    {
+        // Buffer sequence with pieces of odd sizes
+        std::uint32_t const key = 0x01020304;
+        std::vector<std::uint8_t> v(1000);
+        for(std::size_t i = 0; i < v.size(); ++i)
+            v[i] = static_cast<std::uint8_t>(i);
+        auto ref = v;
+        mask_reference(ref.data(), ref.size(), 0, key);
+        std::array<boost::asio::mutable_buffer, 4> bs{{
+            {v.data(), 3},
+            {v.data() + 3, 129},
+            {v.data() + 132, 67},
+            {v.data() + 199, 801}}};
+        prepared_key pk;
+        prepare_key(pk, key);
+        mask_inplace(bs, pk);
+        BEAST_EXPECT(v == ref);
+    }
+
+    void
+    testMaskCopy()
+    {
+        std::uint32_t const key = 0xa1b2c3d4;
+        std::uint8_t src[320];
+        for(std::size_t i = 0; i < sizeof(src); ++i)
+            src[i] = static_cast<std::uint8_t>(i * 13 + 5);
+        std::uint8_t out[320];
+        std::uint8_t ref[320];
+        for(std::size_t offset = 0; offset < 8; ++offset)
+        {
+            for(std::size_t n = 0; n <= 300; ++n)
+            {
+                // Source and destination differently aligned
+                std::memset(out, 0, sizeof(out));
+                std::memset(ref, 0, sizeof(ref));
+                std::memcpy(ref + offset, src + 3, n);
+                mask_reference(ref + offset, n, 0, key);
+                prepared_key pk;
+                prepare_key(pk, key);
+                mask_copy(out + offset, src + 3, n, pk);
+                if(! BEAST_EXPECTS(std::memcmp(
+                        out, ref, sizeof(out)) == 0,
+                        "offset=" + std::to_string(offset) +
+                        " n=" + std::to_string(n)))
+                    return;
+                prepared_key pk2;
+                prepare_key(pk2, key);
+                pk2 = ror(pk2, static_cast<unsigned>(8 * n));
+                BEAST_EXPECT(pk == pk2);
+            }
+        }
+
+        // Buffer sequence source, destination smaller
+        {
+            std::array<boost::asio::const_buffer, 3> bs{{
+                {src, 5},
+                {src + 5, 100},
+                {src + 105, 200}}};
+            std::memcpy(ref, src, 250);
+            mask_reference(ref, 250, 0, key);
+            prepared_key pk;
+            prepare_key(pk, key);
+            BEAST_EXPECT(mask_copy(boost::asio::mutable_buffer{
+                out, 250}, bs, pk) == 250);
+            BEAST_EXPECT(std::memcmp(out, ref, 250) == 0);
+            // Source smaller
+            prepare_key(pk, key);
+            BEAST_EXPECT(mask_copy(boost::asio::mutable_buffer{
+                out, sizeof(out)}, bs, pk) == 305);
+        }
+    }
+
+    void
+    testMaskInplaceEach()
+    {
+        std::uint32_t const key = 0x55aa33cc;
+        std::vector<std::uint8_t> v(3 * mask_piece_size + 17);
+        for(std::size_t i = 0; i < v.size(); ++i)
+            v[i] = static_cast<std::uint8_t>(i);
+        auto ref = v;
+        mask_reference(ref.data(), ref.size(), 0, key);
+        auto const orig = v;
+        std::array<boost::asio::mutable_buffer, 2> bs{{
+            {v.data(), 7},
+            {v.data() + 7, v.size() - 7}}};
+        {
+            // Every piece is unmasked when f sees it
+            prepared_key pk;
+            prepare_key(pk, key);
+            std::size_t pos = 0;
+            BEAST_EXPECT(mask_inplace_each(bs, pk,
+                [&](std::uint8_t const* p, std::size_t n)
+                {
+                    BEAST_EXPECT(p == v.data() + pos);
+                    BEAST_EXPECT(n <= mask_piece_size);
+                    BEAST_EXPECT(std::memcmp(
+                        p, ref.data() + pos, n) == 0);
+                    pos += n;
+                    return true;
+                }));
+            BEAST_EXPECT(pos == v.size());
+            BEAST_EXPECT(v == ref);
+        }
+        {
+            // Stops at the first piece rejected by f
+            v = orig;
+            prepared_key pk;
+            prepare_key(pk, key);
+            std::size_t calls = 0;
+            BEAST_EXPECT(! mask_inplace_each(bs, pk,
+                [&](std::uint8_t const*, std::size_t)
+                {
+                    return ++calls < 2;
+                }));
+            BEAST_EXPECT(calls == 2);
+            BEAST_EXPECT(v.back() == orig.back());
+        }
+    }
+
     void run() override
     {
         maskgen_t<test_generator> mg;
         BEAST_EXPECT(mg() != 0);
+
+        testKernels();
+        testMaskInplace();
+        testMaskCopy();
+        testMaskInplaceEach();
     }
 };
 
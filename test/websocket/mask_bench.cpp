@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/websocket/detail/mask.hpp>
+
+#include <beast/unit_test/suite.hpp>
+#include <chrono>
+#include <vector>
+
+namespace beast {
+namespace websocket {
+namespace detail {
+
+class mask_bench_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::high_resolution_clock;
+
+    static std::size_t constexpr size = 1024 * 1024 + 3;
+    static std::size_t constexpr repeat = 256;
+
+    struct kernel
+    {
+        char const* name;
+        mask_bulk_fn f;
+    };
+
+    static
+    std::vector<kernel>
+    kernels()
+    {
+        std::vector<kernel> v;
+        v.push_back({"scalar", &mask_bulk_scalar});
+    #if BEAST_DETAIL_X86
+        auto const& ci = beast::detail::get_cpu_info();
+        if(ci.sse2)
+            v.push_back({"sse2", &mask_bulk_sse2});
+        if(ci.avx2)
+            v.push_back({"avx2", &mask_bulk_avx2});
+    #endif
+        return v;
+    }
+
+    static
+    double
+    rate(clock_type::duration elapsed)
+    {
+        auto const us = std::chrono::duration_cast<
+            std::chrono::microseconds>(elapsed).count();
+        return us > 0 ? static_cast<double>(
+            repeat * size) / us / 1000 : 0;
+    }
+
+    void
+    testKernels()
+    {
+        std::vector<std::uint8_t> v(size);
+        for(auto const& k : kernels())
+        {
+            prepared_key pk;
+            prepare_key(pk, 0x12345678);
+            auto const t0 = clock_type::now();
+            for(std::size_t i = 0; i < repeat; ++i)
+            {
+                // Start one byte in to measure unaligned buffers
+                auto const p = v.data() + 1;
+                auto const used = k.f(p, p, size - 1,
+                    static_cast<std::uint32_t>(pk));
+                mask_inplace_fast(boost::asio::mutable_buffer{
+                    p + used, size - 1 - used}, pk);
+            }
+            log << "mask " << k.name << ": " <<
+                rate(clock_type::now() - t0) << " GB/s" << std::endl;
+        }
+    }
+
+    // Copy then mask, versus the fused copy
+    void
+    testCopy()
+    {
+        std::vector<std::uint8_t> v(size);
+        std::vector<std::uint8_t> out(size);
+        auto const b = boost::asio::buffer(out);
+        auto const cb = boost::asio::buffer(
+            static_cast<std::uint8_t const*>(v.data()), size);
+        prepared_key pk;
+        prepare_key(pk, 0x12345678);
+        auto t0 = clock_type::now();
+        for(std::size_t i = 0; i < repeat; ++i)
+        {
+            boost::asio::buffer_copy(b, cb);
+            mask_inplace(b, pk);
+        }
+        log << "buffer_copy, mask_inplace: " <<
+            rate(clock_type::now() - t0) << " GB/s" << std::endl;
+        t0 = clock_type::now();
+        for(std::size_t i = 0; i < repeat; ++i)
+            mask_copy(b, cb, pk);
+        log << "mask_copy: " <<
+            rate(clock_type::now() - t0) << " GB/s" << std::endl;
+    }
+
+    void
+    run() override
+    {
+        testKernels();
+        testCopy();
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(mask_bench,websocket,beast);
+
+} // detail
+} // websocket
+} // beast
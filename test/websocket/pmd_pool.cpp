@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/websocket/detail/pmd_pool.hpp>
+
+#include <beast/core/streambuf.hpp>
+#include <beast/core/to_string.hpp>
+#include <beast/http/empty_body.hpp>
+#include <beast/http/message.hpp>
+#include <beast/test/string_istream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/websocket/stream.hpp>
+#include <boost/asio/io_service.hpp>
+#include <memory>
+#include <string>
+
+namespace beast {
+namespace test {
+
+// Nothing to tear down
+inline
+void
+teardown(websocket::teardown_tag, string_istream&, error_code&)
+{
+}
+
+} // test
+
+namespace websocket {
+namespace detail {
+
+class pmd_pool_test : public beast::unit_test::suite
+{
+public:
+    boost::asio::io_service ios_;
+
+    using ws_type = stream<test::string_istream>;
+
+    // An upgrade request offering permessage-deflate
+    static
+    http::request<http::empty_body>
+    make_request(bool no_context_takeover)
+    {
+        http::request<http::empty_body> req;
+        req.method = "GET";
+        req.url = "/";
+        req.version = 11;
+        req.fields.insert("Host", "localhost:80");
+        req.fields.insert("Upgrade", "WebSocket");
+        req.fields.insert("Connection", "upgrade");
+        req.fields.insert("Sec-WebSocket-Key", "dGhlIHNhbXBsZSBub25jZQ==");
+        req.fields.insert("Sec-WebSocket-Version", "13");
+        req.fields.insert("Sec-WebSocket-Extensions",
+            no_context_takeover ? "permessage-deflate"
+                "; client_no_context_takeover"
+                "; server_no_context_takeover" :
+            "permessage-deflate");
+        return req;
+    }
+
+    // Two masked compressed messages
+    static
+    std::string
+    make_input()
+    {
+        // "Hello" compressed, from rfc7692, with a zero mask key
+        static char const frame[] = {
+            '\xc1', '\x87', 0, 0, 0, 0,
+            '\xf2', '\x48', '\xcd', '\xc9', '\xc9', '\x07', '\x00'};
+        std::string s;
+        s.append(frame, sizeof(frame));
+        s.append(frame, sizeof(frame));
+        return s;
+    }
+
+    std::unique_ptr<ws_type>
+    make_stream(bool no_context_takeover)
+    {
+        std::unique_ptr<ws_type> ws{
+            new ws_type{ios_, make_input()}};
+        permessage_deflate pmd;
+        pmd.server_enable = true;
+        ws->set_option(pmd);
+        ws->accept(make_request(no_context_takeover));
+        return ws;
+    }
+
+    // Receive a message and send it back
+    void
+    echo(ws_type& ws)
+    {
+        streambuf sb;
+        opcode op;
+        ws.read(op, sb);
+        BEAST_EXPECT(to_string(sb.data()) == "Hello");
+        ws.write(sb.data());
+    }
+
+    void
+    testPool()
+    {
+        auto& pool = pmd_pool::instance();
+        pool.limit(0);
+        pool.limit(2);
+        {
+            auto zo1 = pool.get_deflate();
+            auto zo2 = pool.get_deflate();
+            auto zo3 = pool.get_deflate();
+            auto zi = pool.get_inflate();
+            BEAST_EXPECT(zo1 && zo2 && zo3 && zi);
+            BEAST_EXPECT(pool.deflate_idle() == 0);
+        }
+        // Only up to the limit are kept
+        BEAST_EXPECT(pool.deflate_idle() == 2);
+        BEAST_EXPECT(pool.inflate_idle() == 1);
+        {
+            auto zo = pool.get_deflate();
+            BEAST_EXPECT(pool.deflate_idle() == 1);
+        }
+        BEAST_EXPECT(pool.deflate_idle() == 2);
+        pool.limit(32);
+    }
+
+    void
+    testStream()
+    {
+        auto& pool = pmd_pool::instance();
+        pool.limit(0);
+        pool.limit(32);
+        {
+            // Context takeover: held until close
+            auto ws = make_stream(false);
+            echo(*ws);
+            echo(*ws);
+            BEAST_EXPECT(pool.deflate_idle() == 0);
+            BEAST_EXPECT(pool.inflate_idle() == 0);
+        }
+        BEAST_EXPECT(pool.deflate_idle() == 1);
+        BEAST_EXPECT(pool.inflate_idle() == 1);
+        {
+            // No context takeover: returned after each message
+            auto ws = make_stream(true);
+            echo(*ws);
+            BEAST_EXPECT(pool.deflate_idle() == 1);
+            BEAST_EXPECT(pool.inflate_idle() == 1);
+            echo(*ws);
+            BEAST_EXPECT(pool.deflate_idle() == 1);
+            BEAST_EXPECT(pool.inflate_idle() == 1);
+        }
+        BEAST_EXPECT(pool.deflate_idle() == 1);
+        BEAST_EXPECT(pool.inflate_idle() == 1);
+    }
+
+    void
+    run() override
+    {
+        testPool();
+        testStream();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(pmd_pool,websocket,beast);
+
+} // detail
+} // websocket
+} // beast
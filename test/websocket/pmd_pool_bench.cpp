@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/websocket/detail/pmd_pool.hpp>
+
+#include <beast/core/streambuf.hpp>
+#include <beast/http/empty_body.hpp>
+#include <beast/http/message.hpp>
+#include <beast/test/string_istream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/websocket/stream.hpp>
+#include <boost/asio/io_service.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace beast {
+namespace test {
+
+// Nothing to tear down
+inline
+void
+teardown(websocket::teardown_tag, string_istream&, error_code&)
+{
+}
+
+} // test
+
+namespace websocket {
+namespace detail {
+
+/*  Resident memory of permessage-deflate connections.
+
+    Each connection negotiates permessage-deflate, receives one
+    compressed message and sends it back. With context takeover
+    the compressor and decompressor stay with the connection,
+    without it they go back to the pool after the message. The
+    growth in resident memory is reported per connection.
+
+    The number of connections defaults to a size suitable for
+    every test run. Pass a larger number as the argument string,
+    for example `--arg=10000`.
+*/
+class pmd_pool_bench_test : public beast::unit_test::suite
+{
+public:
+    using ws_type = stream<test::string_istream>;
+
+    static std::size_t constexpr default_count = 100;
+
+    boost::asio::io_service ios_;
+
+    // Returns the resident set size in bytes, or 0
+    static
+    std::size_t
+    resident()
+    {
+    #if defined(__linux__)
+        std::size_t size = 0;
+        std::size_t pages = 0;
+        auto const f = std::fopen("/proc/self/statm", "r");
+        if(! f)
+            return 0;
+        if(std::fscanf(f, "%zu %zu", &size, &pages) != 2)
+            pages = 0;
+        std::fclose(f);
+        return pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    #else
+        return 0;
+    #endif
+    }
+
+    // Give freed memory back so earlier runs do not hide growth
+    static
+    void
+    trim()
+    {
+    #if defined(__GLIBC__)
+        malloc_trim(0);
+    #endif
+    }
+
+    static
+    http::request<http::empty_body>
+    make_request(bool no_context_takeover)
+    {
+        http::request<http::empty_body> req;
+        req.method = "GET";
+        req.url = "/";
+        req.version = 11;
+        req.fields.insert("Host", "localhost:80");
+        req.fields.insert("Upgrade", "WebSocket");
+        req.fields.insert("Connection", "upgrade");
+        req.fields.insert("Sec-WebSocket-Key", "dGhlIHNhbXBsZSBub25jZQ==");
+        req.fields.insert("Sec-WebSocket-Version", "13");
+        req.fields.insert("Sec-WebSocket-Extensions",
+            no_context_takeover ? "permessage-deflate"
+                "; client_no_context_takeover"
+                "; server_no_context_takeover" :
+            "permessage-deflate");
+        return req;
+    }
+
+    // "Hello" compressed, from rfc7692, with a zero mask key
+    static
+    std::string
+    make_input()
+    {
+        static char const frame[] = {
+            '\xc1', '\x87', 0, 0, 0, 0,
+            '\xf2', '\x48', '\xcd', '\xc9', '\xc9', '\x07', '\x00'};
+        return {frame, sizeof(frame)};
+    }
+
+    void
+    measure(std::size_t n, bool no_context_takeover)
+    {
+        auto& pool = pmd_pool::instance();
+        pool.limit(0);
+        pool.limit(32);
+        auto const req = make_request(no_context_takeover);
+        permessage_deflate pmd;
+        pmd.server_enable = true;
+        std::vector<std::unique_ptr<ws_type>> v;
+        v.reserve(n);
+        trim();
+        auto const before = resident();
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            std::unique_ptr<ws_type> ws{
+                new ws_type{ios_, make_input()}};
+            ws->set_option(pmd);
+            error_code ec;
+            ws->accept(req, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            streambuf sb;
+            opcode op;
+            ws->read(op, sb, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            ws->write(sb.data(), ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            v.emplace_back(std::move(ws));
+        }
+        auto const after = resident();
+        if(after == 0)
+        {
+            log << "resident memory is unavailable" << std::endl;
+            return;
+        }
+        log <<
+            (no_context_takeover ?
+                "no context takeover, " : "context takeover, ") <<
+            n << " connections: " <<
+            (after - before) / n << " bytes per connection" <<
+            std::endl;
+    }
+
+    void
+    run() override
+    {
+        pass();
+        std::size_t n = default_count;
+        if(! arg().empty())
+            n = static_cast<std::size_t>(
+                std::strtoull(arg().c_str(), nullptr, 10));
+        if(n == 0)
+            n = default_count;
+        measure(n, false);
+        measure(n, true);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(pmd_pool_bench,websocket,beast);
+
+} // detail
+} // websocket
+} // beast
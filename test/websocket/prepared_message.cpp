@@ -0,0 +1,322 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/websocket/prepared_message.hpp>
+
+#include <beast/core/streambuf.hpp>
+#include <beast/core/to_string.hpp>
+#include <beast/http/empty_body.hpp>
+#include <beast/http/message.hpp>
+#include <beast/test/string_ostream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/websocket/stream.hpp>
+#include <beast/zlib/inflate_stream.hpp>
+#include <boost/asio/io_service.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace beast {
+namespace test {
+
+// Nothing to tear down
+inline
+void
+teardown(websocket::teardown_tag, string_ostream&, error_code&)
+{
+}
+
+} // test
+
+namespace websocket {
+
+class prepared_message_test : public beast::unit_test::suite
+{
+public:
+    boost::asio::io_service ios_;
+
+    // A frame sent by the server
+    struct frame
+    {
+        opcode op;
+        bool fin;
+        bool rsv1;
+        std::string payload;
+    };
+
+    static
+    http::request<http::empty_body>
+    make_request(std::string const& extensions)
+    {
+        http::request<http::empty_body> req;
+        req.method = "GET";
+        req.url = "/";
+        req.version = 11;
+        req.fields.insert("Host", "localhost:80");
+        req.fields.insert("Upgrade", "WebSocket");
+        req.fields.insert("Connection", "upgrade");
+        req.fields.insert("Sec-WebSocket-Key", "dGhlIHNhbXBsZSBub25jZQ==");
+        req.fields.insert("Sec-WebSocket-Version", "13");
+        if(! extensions.empty())
+            req.fields.insert("Sec-WebSocket-Extensions", extensions);
+        return req;
+    }
+
+    // Accept a request offering the given extensions
+    template<class Stream>
+    static
+    void
+    open(Stream& ws, std::string const& extensions)
+    {
+        permessage_deflate pmd;
+        pmd.server_enable = true;
+        ws.set_option(pmd);
+        ws.accept(make_request(extensions));
+    }
+
+    // Parse the unmasked frames following the upgrade response
+    static
+    std::vector<frame>
+    parse(std::string const& s)
+    {
+        std::vector<frame> v;
+        auto pos = s.find("\r\n\r\n");
+        if(pos == std::string::npos)
+            return v;
+        pos += 4;
+        auto const byte =
+            [&](std::size_t i)
+            {
+                return static_cast<std::uint8_t>(s[i]);
+            };
+        while(pos + 2 <= s.size())
+        {
+            frame f;
+            f.fin = (byte(pos) & 0x80) != 0;
+            f.rsv1 = (byte(pos) & 0x40) != 0;
+            f.op = static_cast<opcode>(byte(pos) & 0x0f);
+            std::uint64_t len = byte(pos + 1) & 0x7f;
+            pos += 2;
+            std::size_t n = 0;
+            if(len == 126)
+                n = 2;
+            else if(len == 127)
+                n = 8;
+            if(n > 0)
+            {
+                len = 0;
+                for(std::size_t i = 0; i < n; ++i)
+                    len = (len << 8) | byte(pos + i);
+                pos += n;
+            }
+            f.payload = s.substr(pos,
+                static_cast<std::size_t>(len));
+            pos += static_cast<std::size_t>(len);
+            v.emplace_back(std::move(f));
+        }
+        return v;
+    }
+
+    // Decompress a message, keeping the window in zi
+    static
+    std::string
+    inflate(zlib::inflate_stream& zi, std::string s)
+    {
+        s.append("\x00\x00\xff\xff", 4);
+        streambuf sb;
+        error_code ec;
+        detail::inflate(zi, sb,
+            boost::asio::buffer(s.data(), s.size()), ec);
+        if(ec)
+            return "<" + ec.message() + ">";
+        return to_string(sb.data());
+    }
+
+    static
+    std::string
+    make_text(std::size_t size)
+    {
+        static char const words[] =
+            "the quick brown fox jumps over the lazy dog ";
+        std::string s;
+        s.reserve(size);
+        while(s.size() < size)
+            s.push_back(words[s.size() % (sizeof(words) - 1)]);
+        return s;
+    }
+
+    static
+    std::string
+    make_random(std::size_t size)
+    {
+        std::mt19937 g;
+        std::string s;
+        s.reserve(size);
+        while(s.size() < size)
+            s.push_back(static_cast<char>(g()));
+        return s;
+    }
+
+    void
+    testMessage()
+    {
+        auto const s = make_text(1000);
+        {
+            prepared_message msg{
+                message_type{opcode::binary},
+                    boost::asio::buffer(s)};
+            BEAST_EXPECT(msg.op() == opcode::binary);
+            BEAST_EXPECT(msg.size() == s.size());
+            BEAST_EXPECT(! msg.compressed());
+        }
+        {
+            prepared_message msg{
+                message_type{opcode::text},
+                    boost::asio::buffer(s), permessage_deflate{}};
+            BEAST_EXPECT(msg.op() == opcode::text);
+            BEAST_EXPECT(msg.size() == s.size());
+            BEAST_EXPECT(msg.compressed());
+            // Copies share the buffer
+            auto msg2 = msg;
+            BEAST_EXPECT(msg2.size() == msg.size());
+        }
+        {
+            // Not worth compressing
+            auto const r = make_random(1000);
+            prepared_message msg{
+                message_type{opcode::binary},
+                    boost::asio::buffer(r), permessage_deflate{}};
+            BEAST_EXPECT(! msg.compressed());
+        }
+    }
+
+    void
+    testUncompressed()
+    {
+        for(std::size_t size : {
+            0, 1, 125, 126, 127, 65535, 65536, 70000})
+        {
+            auto const s = make_text(size);
+            prepared_message msg{
+                message_type{opcode::binary},
+                    boost::asio::buffer(s), permessage_deflate{}};
+            stream<test::string_ostream> ws{ios_};
+            open(ws, "");
+            ws.write_prepared(msg);
+            ws.write_prepared(msg);
+            auto const v = parse(ws.next_layer().str);
+            if(! BEAST_EXPECT(v.size() == 2))
+                continue;
+            for(auto const& f : v)
+            {
+                BEAST_EXPECT(f.op == opcode::binary);
+                BEAST_EXPECT(f.fin);
+                BEAST_EXPECT(! f.rsv1);
+                BEAST_EXPECTS(f.payload == s,
+                    std::to_string(size));
+            }
+        }
+    }
+
+    void
+    testCompressed()
+    {
+        auto const s = make_text(5000);
+        prepared_message msg{
+            message_type{opcode::text},
+                boost::asio::buffer(s), permessage_deflate{}};
+        BEAST_EXPECT(msg.compressed());
+        {
+            // Between messages compressed by the stream,
+            // decoded by a peer with context takeover.
+            stream<test::string_ostream> ws{ios_};
+            open(ws, "permessage-deflate");
+            ws.write(boost::asio::buffer(s));
+            ws.write_prepared(msg);
+            ws.write(boost::asio::buffer(s));
+            ws.write_prepared(msg);
+            auto const v = parse(ws.next_layer().str);
+            if(BEAST_EXPECT(v.size() == 4))
+            {
+                zlib::inflate_stream zi;
+                for(auto const& f : v)
+                {
+                    BEAST_EXPECT(f.op == opcode::text);
+                    BEAST_EXPECT(f.fin);
+                    BEAST_EXPECT(f.rsv1);
+                    BEAST_EXPECT(f.payload.size() < s.size());
+                    BEAST_EXPECT(inflate(zi, f.payload) == s);
+                }
+            }
+        }
+        {
+            // No context takeover
+            stream<test::string_ostream> ws{ios_};
+            open(ws, "permessage-deflate; "
+                "server_no_context_takeover");
+            ws.write_prepared(msg);
+            ws.write(boost::asio::buffer(s));
+            auto const v = parse(ws.next_layer().str);
+            if(BEAST_EXPECT(v.size() == 2))
+            {
+                for(auto const& f : v)
+                {
+                    BEAST_EXPECT(f.rsv1);
+                    zlib::inflate_stream zi;
+                    BEAST_EXPECT(inflate(zi, f.payload) == s);
+                }
+            }
+        }
+        {
+            // The peer's window is too small
+            stream<test::string_ostream> ws{ios_};
+            open(ws, "permessage-deflate; "
+                "server_max_window_bits=10");
+            ws.write_prepared(msg);
+            auto const v = parse(ws.next_layer().str);
+            if(BEAST_EXPECT(v.size() == 1))
+            {
+                BEAST_EXPECT(! v[0].rsv1);
+                BEAST_EXPECT(v[0].payload == s);
+            }
+        }
+        {
+            // Compressed for the smaller window
+            permessage_deflate pmd;
+            pmd.server_max_window_bits = 10;
+            prepared_message msg10{
+                message_type{opcode::text},
+                    boost::asio::buffer(s), pmd};
+            stream<test::string_ostream> ws{ios_};
+            open(ws, "permessage-deflate; "
+                "server_max_window_bits=10");
+            ws.write_prepared(msg10);
+            auto const v = parse(ws.next_layer().str);
+            if(BEAST_EXPECT(v.size() == 1))
+            {
+                BEAST_EXPECT(v[0].rsv1);
+                zlib::inflate_stream zi;
+                zi.reset(10);
+                BEAST_EXPECT(inflate(zi, v[0].payload) == s);
+            }
+        }
+    }
+
+    void
+    run() override
+    {
+        testMessage();
+        testUncompressed();
+        testCompressed();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(prepared_message,websocket,beast);
+
+} // websocket
+} // beast
@@ -0,0 +1,151 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/websocket/prepared_message.hpp>
+
+#include <beast/http/empty_body.hpp>
+#include <beast/http/message.hpp>
+#include <beast/test/string_ostream.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/websocket/stream.hpp>
+#include <boost/asio/io_service.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace beast {
+namespace websocket {
+
+/*  Messages per second sent to many subscribers.
+
+    Each message is written to every stream, first with
+    stream::write and then once prepared with write_prepared.
+*/
+class prepared_message_bench_test : public beast::unit_test::suite
+{
+public:
+    boost::asio::io_service ios_;
+
+    // Discards everything written
+    class sink_stream : public test::string_ostream
+    {
+    public:
+        using test::string_ostream::string_ostream;
+
+        template<class ConstBufferSequence>
+        std::size_t
+        write_some(ConstBufferSequence const& buffers)
+        {
+            return boost::asio::buffer_size(buffers);
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        write_some(
+            ConstBufferSequence const& buffers, error_code&)
+        {
+            return boost::asio::buffer_size(buffers);
+        }
+
+        friend
+        void
+        teardown(teardown_tag, sink_stream&, error_code&)
+        {
+        }
+    };
+
+    // Accept a request offering the given extensions
+    static
+    void
+    open(stream<sink_stream>& ws, std::string const& extensions)
+    {
+        http::request<http::empty_body> req;
+        req.method = "GET";
+        req.url = "/";
+        req.version = 11;
+        req.fields.insert("Host", "localhost:80");
+        req.fields.insert("Upgrade", "WebSocket");
+        req.fields.insert("Connection", "upgrade");
+        req.fields.insert("Sec-WebSocket-Key", "dGhlIHNhbXBsZSBub25jZQ==");
+        req.fields.insert("Sec-WebSocket-Version", "13");
+        if(! extensions.empty())
+            req.fields.insert("Sec-WebSocket-Extensions", extensions);
+        permessage_deflate pmd;
+        pmd.server_enable = true;
+        ws.set_option(pmd);
+        ws.accept(req);
+    }
+
+    static
+    std::string
+    make_text(std::size_t size)
+    {
+        static char const words[] =
+            "the quick brown fox jumps over the lazy dog ";
+        std::string s;
+        s.reserve(size);
+        while(s.size() < size)
+            s.push_back(words[s.size() % (sizeof(words) - 1)]);
+        return s;
+    }
+
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        using clock_type = std::chrono::high_resolution_clock;
+        std::size_t const subscribers = 1000;
+        std::size_t const repeat = 10;
+        auto const s = make_text(1024);
+        for(auto compress : {false, true})
+        {
+            std::vector<std::unique_ptr<
+                stream<sink_stream>>> v;
+            v.reserve(subscribers);
+            for(std::size_t i = 0; i < subscribers; ++i)
+            {
+                v.emplace_back(new stream<sink_stream>{ios_});
+                open(*v.back(), compress ? "permessage-deflate; "
+                    "server_no_context_takeover" : "");
+            }
+            auto const rate =
+                [&](clock_type::duration elapsed)
+                {
+                    auto const us = duration_cast<
+                        microseconds>(elapsed).count();
+                    return us > 0 ? static_cast<double>(
+                        subscribers * repeat) * 1000000 / us : 0;
+                };
+            auto t0 = clock_type::now();
+            for(std::size_t i = 0; i < repeat; ++i)
+                for(auto& ws : v)
+                    ws->write(boost::asio::buffer(s));
+            log << (compress ? "deflate" : "plain") <<
+                " write: " << rate(clock_type::now() - t0) <<
+                    " messages/s" << std::endl;
+            t0 = clock_type::now();
+            for(std::size_t i = 0; i < repeat; ++i)
+            {
+                prepared_message msg{
+                    message_type{opcode::text},
+                        boost::asio::buffer(s), permessage_deflate{}};
+                for(auto& ws : v)
+                    ws->write_prepared(msg);
+            }
+            log << (compress ? "deflate" : "plain") <<
+                " write_prepared: " << rate(clock_type::now() - t0) <<
+                    " messages/s" << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(prepared_message_bench,websocket,beast);
+
+} // websocket
+} // beast
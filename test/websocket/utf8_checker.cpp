@@ -12,6 +12,9 @@
 #include <beast/core/streambuf.hpp>
 #include <beast/unit_test/suite.hpp>
 #include <array>
+#include <random>
+#include <string>
+#include <vector>
 
 namespace beast {
 namespace websocket {
@@ -90,6 +93,18 @@ public:
             BEAST_EXPECT(! utf8.write(&buf[1], 1));
             utf8.reset();
         }
+
+        {
+            // Overlong sequences in the middle of text
+            std::uint8_t const c0[] = {
+                'a', 'b', 0xC0, 0x80, 'c', 'd', 'e', 'f', 'g', 'h'};
+            std::uint8_t const c1[] = {
+                'a', 'b', 0xC1, 0xBF, 'c', 'd', 'e', 'f', 'g', 'h'};
+            BEAST_EXPECT(! utf8.write(c0, sizeof(c0)));
+            utf8.reset();
+            BEAST_EXPECT(! utf8.write(c1, sizeof(c1)));
+            utf8.reset();
+        }
     }
 
     void
@@ -393,6 +408,141 @@ public:
         }
     }
 
+    struct kernel
+    {
+        char const* name;
+        utf8_skip_fn f;
+    };
+
+    static
+    std::vector<kernel>
+    kernels()
+    {
+        std::vector<kernel> v;
+        v.push_back({"scalar", &utf8_skip_scalar});
+    #if BEAST_DETAIL_X86
+        auto const& ci = beast::detail::get_cpu_info();
+        if(ci.ssse3)
+            v.push_back({"ssse3", &utf8_skip_ssse3});
+        if(ci.avx2)
+            v.push_back({"avx2", &utf8_skip_avx2});
+    #endif
+        return v;
+    }
+
+    static
+    void
+    encode(std::uint32_t cp, std::string& s)
+    {
+        if(cp < 0x80)
+        {
+            s.push_back(static_cast<char>(cp));
+        }
+        else if(cp < 0x800)
+        {
+            s.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        else if(cp < 0x10000)
+        {
+            s.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        else
+        {
+            s.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+    }
+
+    // Text with `ascii` percent of ASCII, the rest drawn from
+    // `lo` to `hi` skipping surrogates.
+    static
+    std::string
+    make_text(std::size_t size, unsigned ascii,
+        std::uint32_t lo, std::uint32_t hi, std::uint32_t seed = 1)
+    {
+        std::mt19937 g{seed};
+        std::string s;
+        while(s.size() < size)
+        {
+            if(g() % 100 < ascii)
+            {
+                encode(0x20 + g() % 0x5f, s);
+                continue;
+            }
+            auto const cp = lo + g() % (hi - lo + 1);
+            if(cp >= 0xd800 && cp <= 0xdfff)
+                continue;
+            encode(cp, s);
+        }
+        return s;
+    }
+
+    static
+    bool
+    check(std::string const& s, utf8_skip_fn f,
+        std::size_t split = 0)
+    {
+        auto const p = reinterpret_cast<
+            std::uint8_t const*>(s.data());
+        utf8_checker utf8;
+        if(! utf8.write(p, split, f))
+            return false;
+        if(! utf8.write(p + split, s.size() - split, f))
+            return false;
+        return utf8.finish();
+    }
+
+    void
+    testKernels()
+    {
+        // Boundary code points of every length
+        std::string text;
+        for(std::uint32_t cp : {0x7fu, 0x80u, 0x7ffu, 0x800u,
+                0xd7ffu, 0xe000u, 0xfffdu, 0xffffu, 0x10000u,
+                0x10ffffu})
+            encode(cp, text);
+        text += make_text(500, 20, 0x80, 0x10ffff);
+        std::uint8_t const values[] = {
+            0x00, 0x41, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf,
+            0xc0, 0xc1, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0, 0xf4,
+            0xf5, 0xf8, 0xff};
+        for(auto const& k : kernels())
+        {
+            testcase << "kernel " << k.name;
+            for(std::size_t i = 0; i <= text.size(); ++i)
+                if(! BEAST_EXPECTS(check(text, k.f, i),
+                        "split " + std::to_string(i)))
+                    break;
+            // Every corruption is judged the same as
+            // the scalar checker does, split or not.
+            for(std::size_t i = 0; i < text.size(); ++i)
+            {
+                for(auto c : values)
+                {
+                    auto t = text;
+                    t[i] = static_cast<char>(c);
+                    auto const expected =
+                        check(t, &utf8_skip_scalar);
+                    if(! BEAST_EXPECTS(
+                        check(t, k.f) == expected &&
+                        check(t, k.f, i / 2) == expected,
+                            "index " + std::to_string(i) +
+                            " value " + std::to_string(c)))
+                        return;
+                }
+                // Truncated
+                auto const t = text.substr(0, i);
+                BEAST_EXPECT(check(t, k.f) ==
+                    check(t, &utf8_skip_scalar));
+            }
+        }
+    }
+
     void run() override
     {
         testOneByteSequence();
@@ -400,6 +550,7 @@ public:
         testThreeByteSequence();
         testFourByteSequence();
         testWithStreamBuffer();
+        testKernels();
     }
 };
 
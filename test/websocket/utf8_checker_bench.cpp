@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/websocket/detail/utf8_checker.hpp>
+
+#include <beast/unit_test/suite.hpp>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace beast {
+namespace websocket {
+namespace detail {
+
+class utf8_checker_bench_test : public beast::unit_test::suite
+{
+public:
+    struct kernel
+    {
+        char const* name;
+        utf8_skip_fn f;
+    };
+
+    static
+    std::vector<kernel>
+    kernels()
+    {
+        std::vector<kernel> v;
+        v.push_back({"scalar", &utf8_skip_scalar});
+    #if BEAST_DETAIL_X86
+        auto const& ci = beast::detail::get_cpu_info();
+        if(ci.ssse3)
+            v.push_back({"ssse3", &utf8_skip_ssse3});
+        if(ci.avx2)
+            v.push_back({"avx2", &utf8_skip_avx2});
+    #endif
+        return v;
+    }
+
+    static
+    void
+    encode(std::uint32_t cp, std::string& s)
+    {
+        if(cp < 0x80)
+        {
+            s.push_back(static_cast<char>(cp));
+        }
+        else if(cp < 0x800)
+        {
+            s.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        else if(cp < 0x10000)
+        {
+            s.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        else
+        {
+            s.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+    }
+
+    // Text with `ascii` percent of ASCII, the rest drawn from
+    // `lo` to `hi` skipping surrogates.
+    static
+    std::string
+    make_text(std::size_t size, unsigned ascii,
+        std::uint32_t lo, std::uint32_t hi)
+    {
+        std::mt19937 g;
+        std::string s;
+        while(s.size() < size)
+        {
+            if(g() % 100 < ascii)
+            {
+                encode(0x20 + g() % 0x5f, s);
+                continue;
+            }
+            auto const cp = lo + g() % (hi - lo + 1);
+            if(cp >= 0xd800 && cp <= 0xdfff)
+                continue;
+            encode(cp, s);
+        }
+        return s;
+    }
+
+    static
+    bool
+    check(std::string const& s, utf8_skip_fn f)
+    {
+        utf8_checker utf8;
+        if(! utf8.write(reinterpret_cast<
+                std::uint8_t const*>(s.data()), s.size(), f))
+            return false;
+        return utf8.finish();
+    }
+
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        using clock_type = std::chrono::high_resolution_clock;
+        std::size_t const size = 1024 * 1024;
+        std::size_t const repeat = 16;
+        struct corpus
+        {
+            char const* name;
+            std::string text;
+        };
+        corpus const corpora[] = {
+            {"ascii", make_text(size, 100, 0, 0)},
+            // Latin text with accents and some Greek
+            {"mixed", make_text(size, 80, 0xa0, 0x3ff)},
+            // CJK unified ideographs
+            {"cjk", make_text(size, 5, 0x4e00, 0x9fff)}
+        };
+        for(auto const& c : corpora)
+        {
+            for(auto const& k : kernels())
+            {
+                auto const t0 = clock_type::now();
+                for(std::size_t i = 0; i < repeat; ++i)
+                    BEAST_EXPECT(check(c.text, k.f));
+                auto const us = duration_cast<microseconds>(
+                    clock_type::now() - t0).count();
+                log << c.name << " " << k.name << ": " << (us > 0 ?
+                    static_cast<double>(repeat * c.text.size()) /
+                        us / 1000 : 0) << " GB/s" << std::endl;
+            }
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(utf8_checker_bench,websocket,beast);
+
+} // detail
+} // websocket
+} // beast
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/zlib/detail/adler32.hpp>
+
+#include "ztest.hpp"
+#include <beast/unit_test/suite.hpp>
+
+namespace beast {
+namespace zlib {
+namespace detail {
+
+class adler32_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        BEAST_EXPECT(adler32(1, "", 0) == 1);
+        BEAST_EXPECT(adler32(1, "Wikipedia", 9) == 0x11e60398);
+
+        // Long enough to need the modulo within a call
+        auto const s = corpus2(20000);
+        for(std::size_t n : {1, 100, 5552, 5553, 20000})
+            BEAST_EXPECT(adler32(1, s.data(), n) ==
+                ::adler32(1, (Bytef const*)s.data(), (uInt)n));
+        std::uint32_t adler = 1;
+        for(std::size_t i = 0; i < s.size(); i += 999)
+            adler = adler32(adler, &s[i], std::min<std::size_t>(
+                999, s.size() - i));
+        BEAST_EXPECT(adler == ::adler32(
+            1, (Bytef const*)s.data(), (uInt)s.size()));
+
+        for(std::size_t n : {0, 1, 5552, 19999, 20000})
+        {
+            auto const a1 = adler32(1, s.data(), n);
+            auto const a2 = adler32(1, s.data() + n, s.size() - n);
+            BEAST_EXPECT(adler32_combine(a1, a2, s.size() - n) ==
+                adler32(1, s.data(), s.size()));
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(adler32,zlib,beast);
+
+} // detail
+} // zlib
+} // beast
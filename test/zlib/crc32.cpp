@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/zlib/detail/crc32.hpp>
+
+#include "ztest.hpp"
+#include <beast/unit_test/suite.hpp>
+#include <algorithm>
+#include <string>
+
+namespace beast {
+namespace zlib {
+namespace detail {
+
+class crc32_test : public beast::unit_test::suite
+{
+public:
+    static
+    std::uint32_t
+    zlib_crc32(std::uint32_t crc, void const* data, std::size_t size)
+    {
+        return static_cast<std::uint32_t>(::crc32(crc,
+            static_cast<Bytef const*>(data),
+                static_cast<uInt>(size)));
+    }
+
+    void
+    testCrc()
+    {
+        BEAST_EXPECT(crc32(0, "", 0) == 0);
+        BEAST_EXPECT(crc32(0, "123456789", 9) == 0xcbf43926);
+
+        auto const s = corpus2(1000);
+        // Every alignment and every length of the tail
+        for(std::size_t i = 0; i < 8; ++i)
+            for(std::size_t n = 0; n < 80; ++n)
+                BEAST_EXPECT(crc32(0, &s[i], n) ==
+                    zlib_crc32(0, &s[i], n));
+        // Running checksum
+        std::uint32_t crc = 0;
+        for(std::size_t i = 0; i < s.size(); i += 37)
+            crc = crc32(crc, &s[i], std::min<std::size_t>(
+                37, s.size() - i));
+        BEAST_EXPECT(crc == zlib_crc32(0, s.data(), s.size()));
+    }
+
+    void
+    testCombine()
+    {
+        auto const s = corpus2(100000);
+        for(std::size_t n : {0, 1, 7, 8, 4096, 65536, 99999, 100000})
+        {
+            auto const crc1 = crc32(0, s.data(), n);
+            auto const crc2 = crc32(0, s.data() + n, s.size() - n);
+            BEAST_EXPECTS(crc32_combine(crc1, crc2, s.size() - n) ==
+                crc32(0, s.data(), s.size()), std::to_string(n));
+        }
+        BEAST_EXPECT(crc32_combine(0x12345678, 0x9abcdef0,
+            1000000007) == ::crc32_combine(0x12345678, 0x9abcdef0,
+                static_cast<z_off_t>(1000000007)));
+    }
+
+    void
+    run() override
+    {
+        testCrc();
+        testCombine();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(crc32,zlib,beast);
+
+} // detail
+} // zlib
+} // beast
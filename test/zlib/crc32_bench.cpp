@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/zlib/detail/crc32.hpp>
+
+#include "ztest.hpp"
+#include <beast/unit_test/suite.hpp>
+#include <chrono>
+
+namespace beast {
+namespace zlib {
+namespace detail {
+
+class crc32_bench_test : public beast::unit_test::suite
+{
+public:
+    static
+    std::uint32_t
+    zlib_crc32(std::uint32_t crc, void const* data, std::size_t size)
+    {
+        return static_cast<std::uint32_t>(::crc32(crc,
+            static_cast<Bytef const*>(data),
+                static_cast<uInt>(size)));
+    }
+
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        using clock_type = steady_clock;
+        auto const s = corpus2(1024 * 1024);
+        std::size_t const repeat = 50;
+        auto const report =
+            [&](char const* name, std::uint32_t(*f)(
+                std::uint32_t, void const*, std::size_t))
+            {
+                std::uint32_t crc = 0;
+                auto const t0 = clock_type::now();
+                for(std::size_t i = 0; i < repeat; ++i)
+                    crc = f(crc, s.data(), s.size());
+                auto const us = duration_cast<microseconds>(
+                    clock_type::now() - t0).count();
+                log << name << ": " << (us > 0 ? static_cast<double>(
+                    s.size() * repeat) / us : 0) << " MB/s" << std::endl;
+                return crc;
+            };
+        auto const b = report("beast", &crc32);
+        auto const z = report("zlib ", &zlib_crc32);
+        BEAST_EXPECT(b == z);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(crc32_bench,zlib,beast);
+
+} // detail
+} // zlib
+} // beast
@@ -10,6 +10,8 @@
 
 #include "ztest.hpp"
 #include <beast/unit_test/suite.hpp>
+#include <algorithm>
+#include <chrono>
 
 namespace beast {
 namespace zlib {
@@ -319,6 +321,160 @@ public:
         }
     }
 
+    // Compress with zlib, returns the compressed size
+    static
+    std::size_t
+    deflate_zlib(int level, std::string const& in, std::string& out)
+    {
+        ::z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+        zs.next_in = (Bytef*)in.data();
+        zs.avail_in = static_cast<uInt>(in.size());
+        zs.next_out = (Bytef*)out.data();
+        zs.avail_out = static_cast<uInt>(out.size());
+        deflate(&zs, Z_FINISH);
+        auto const n = zs.total_out;
+        deflateEnd(&zs);
+        return n;
+    }
+
+    // Compress with beast, returns the compressed size
+    static
+    std::size_t
+    deflate_beast(int level, std::string const& in, std::string& out)
+    {
+        z_params zs;
+        deflate_stream ds;
+        ds.reset(level, 15, 8, Strategy::normal);
+        out.resize(ds.upper_bound(static_cast<uLong>(in.size())));
+        zs.next_in = (Bytef*)in.data();
+        zs.avail_in = static_cast<uInt>(in.size());
+        zs.next_out = (Bytef*)out.data();
+        zs.avail_out = static_cast<uInt>(out.size());
+        error_code ec;
+        ds.write(zs, Flush::finish, ec);
+        return zs.total_out;
+    }
+
+    // Compress with beast, feeding the input in pieces
+    static
+    std::string
+    deflate_pieces(int level, std::string const& in, std::size_t piece)
+    {
+        deflate_stream ds;
+        ds.reset(level, 15, 8, Strategy::normal);
+        std::string out(ds.upper_bound(in.size()), 0);
+        z_params zs;
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        for(std::size_t i = 0; i < in.size(); i += piece)
+        {
+            zs.next_in = &in[i];
+            zs.avail_in = std::min(piece, in.size() - i);
+            ds.write(zs, Flush::none, ec);
+        }
+        zs.avail_in = 0;
+        ds.write(zs, Flush::finish, ec);
+        out.resize(zs.total_out);
+        return out;
+    }
+
+    // The input buffer is used as the window when all of it
+    // is compressed in one call, which must not change the output.
+    void
+    testOneShot()
+    {
+        for(std::size_t size : {0, 262, 263, 1000, 65536 + 300, 100000})
+        {
+            auto const in = corpus1(size);
+            std::string out;
+            for(int level = 1; level <= 9; ++level)
+            {
+                out.resize(deflate_beast(level, in, out));
+                BEAST_EXPECT(z_inflator{}(out) == in);
+                BEAST_EXPECTS(out == deflate_pieces(level, in, 1000),
+                    std::to_string(size) + " " + std::to_string(level));
+            }
+        }
+    }
+
+    // With the same hash as zlib the output is the same,
+    // except for level 1 which has its own algorithm.
+    void
+    testMatchZlib()
+    {
+        auto const in = corpus3(64 * 1024);
+        std::string b;
+        std::string z;
+        for(int level = 1; level <= 9; ++level)
+        {
+            b.resize(deflate_beast(level, in, b));
+            z.resize(deflate_zlib(level, in, z));
+            BEAST_EXPECT(z_inflator{}(b) == in);
+#if ! BEAST_ZLIB_CRC_HASH
+            if(level > 1)
+                BEAST_EXPECTS(b == z, std::to_string(level));
+#endif
+        }
+    }
+
+    // Level 1 uses deflate_quick. Compress a series of messages,
+    // flushing at the end of each and keeping the window as
+    // permessage-deflate does, then finish the stream. Each piece
+    // of output must inflate to the message it was made from.
+    void
+    testQuick()
+    {
+        auto const in = corpus3(20000);
+        std::size_t const sizes[] = {
+            0, 1, 7, 64, 258, 1000, 4096, 5000, 9000};
+        deflate_stream ds;
+        ds.reset(1, 15, 8, Strategy::normal);
+        ::z_stream zi;
+        std::memset(&zi, 0, sizeof(zi));
+        BEAST_EXPECT(inflateInit2(&zi, -15) == Z_OK);
+        auto const roundtrip =
+            [&](std::string const& msg, Flush flush)
+            {
+                std::string buf(ds.upper_bound(msg.size()) + 16, 0);
+                z_params zs;
+                zs.next_in = msg.data();
+                zs.avail_in = msg.size();
+                zs.next_out = &buf[0];
+                zs.avail_out = buf.size();
+                error_code ec;
+                ds.write(zs, flush, ec);
+                if(flush == Flush::finish)
+                    BEAST_EXPECT(ec == error::end_of_stream);
+                else
+                    BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(zs.avail_in == 0);
+                std::string out(msg.size() + 1, 0);
+                zi.next_in = (Bytef*)&buf[0];
+                zi.avail_in = static_cast<uInt>(zs.total_out);
+                zi.next_out = (Bytef*)&out[0];
+                zi.avail_out = static_cast<uInt>(out.size());
+                auto const result = inflate(&zi, Z_SYNC_FLUSH);
+                BEAST_EXPECT(result == Z_OK ||
+                    result == Z_STREAM_END || result == Z_BUF_ERROR);
+                BEAST_EXPECT(zi.avail_in == 0);
+                out.resize(out.size() - zi.avail_out);
+                BEAST_EXPECTS(out == msg,
+                    std::to_string(msg.size()));
+            };
+        std::size_t pos = 0;
+        for(auto size : sizes)
+        {
+            roundtrip(in.substr(pos, size), Flush::sync);
+            pos += size;
+        }
+        roundtrip(in.substr(pos, 500), Flush::finish);
+        inflateEnd(&zi);
+    }
+
     void
     run() override
     {
@@ -327,6 +483,9 @@ public:
             sizeof(deflate_stream) << std::endl;
 
         testDeflate();
+        testOneShot();
+        testMatchZlib();
+        testQuick();
     }
 };
 
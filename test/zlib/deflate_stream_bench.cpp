@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/zlib/deflate_stream.hpp>
+
+#include "ztest.hpp"
+#include <beast/unit_test/suite.hpp>
+#include <chrono>
+
+namespace beast {
+namespace zlib {
+
+class deflate_stream_bench_test : public beast::unit_test::suite
+{
+public:
+    // Compress with zlib, returns the compressed size
+    static
+    std::size_t
+    deflate_zlib(int level, std::string const& in, std::string& out)
+    {
+        ::z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+        zs.next_in = (Bytef*)in.data();
+        zs.avail_in = static_cast<uInt>(in.size());
+        zs.next_out = (Bytef*)out.data();
+        zs.avail_out = static_cast<uInt>(out.size());
+        deflate(&zs, Z_FINISH);
+        auto const n = zs.total_out;
+        deflateEnd(&zs);
+        return n;
+    }
+
+    // Compress with beast, returns the compressed size
+    static
+    std::size_t
+    deflate_beast(int level, std::string const& in, std::string& out)
+    {
+        z_params zs;
+        deflate_stream ds;
+        ds.reset(level, 15, 8, Strategy::normal);
+        out.resize(ds.upper_bound(static_cast<uLong>(in.size())));
+        zs.next_in = (Bytef*)in.data();
+        zs.avail_in = static_cast<uInt>(in.size());
+        zs.next_out = (Bytef*)out.data();
+        zs.avail_out = static_cast<uInt>(out.size());
+        error_code ec;
+        ds.write(zs, Flush::finish, ec);
+        return zs.total_out;
+    }
+
+    void
+    testSpeed()
+    {
+        using namespace std::chrono;
+        using clock_type = steady_clock;
+        std::size_t const size = 1024 * 1024;
+        auto const in = corpus3(size);
+        std::string out;
+        for(int level = 1; level <= 9; ++level)
+        {
+            auto const report =
+                [&](char const* name, std::size_t (*f)(
+                    int, std::string const&, std::string&))
+                {
+                    auto const t0 = clock_type::now();
+                    auto const n = f(level, in, out);
+                    auto const us = duration_cast<microseconds>(
+                        clock_type::now() - t0).count();
+                    out.resize(n);
+                    BEAST_EXPECT(z_inflator{}(out) == in);
+                    log <<
+                        "level " << level << " " << name << ": " <<
+                        (us > 0 ? static_cast<double>(size) / us : 0) <<
+                        " MB/s, " << n << " bytes" << std::endl;
+                };
+            report("beast", &deflate_beast);
+            report("zlib ", &deflate_zlib);
+        }
+    }
+
+    // Time to compress one message of each size, flushing at
+    // the end of each message and keeping the window, as
+    // permessage-deflate does.
+    void
+    testLatency()
+    {
+        using namespace std::chrono;
+        using clock_type = steady_clock;
+        auto const in = corpus3(1024 * 1024);
+        for(std::size_t size : {64, 256, 1024, 4096, 16384})
+        {
+            auto const count = in.size() / size;
+            auto const check = in.substr(0, count * size);
+            for(int level : {1, 2, 6})
+            {
+                deflate_stream ds;
+                ds.reset(level, 15, 8, Strategy::normal);
+                std::string buf(ds.upper_bound(size) + 16, 0);
+                std::string out;
+                auto const t0 = clock_type::now();
+                for(std::size_t i = 0; i < count; ++i)
+                {
+                    z_params zs;
+                    zs.next_in = &check[i * size];
+                    zs.avail_in = size;
+                    zs.next_out = &buf[0];
+                    zs.avail_out = buf.size();
+                    error_code ec;
+                    ds.write(zs, Flush::sync, ec);
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(zs.avail_in == 0);
+                    out.append(buf.data(), zs.total_out);
+                }
+                auto const ns = duration_cast<nanoseconds>(
+                    clock_type::now() - t0).count() / count;
+                BEAST_EXPECT(z_inflator{}(out) == check);
+                log <<
+                    size << " bytes, level " << level << ": " <<
+                    ns << " ns/message, " <<
+                    out.size() / count << " bytes" << std::endl;
+            }
+        }
+    }
+
+    void
+    run() override
+    {
+        testSpeed();
+        testLatency();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(deflate_stream_bench,zlib,beast);
+
+} // zlib
+} // beast
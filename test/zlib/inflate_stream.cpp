@@ -11,6 +11,7 @@
 #include "ztest.hpp"
 #include <beast/unit_test/suite.hpp>
 #include <chrono>
+#include <cstring>
 #include <random>
 
 namespace beast {
@@ -396,6 +397,40 @@ public:
 #endif
     }
 
+    // Decompress with beast in one call
+    static
+    void
+    inflate_beast(std::string const& in, std::string& out)
+    {
+        z_params zs;
+        inflate_stream is;
+        is.reset(15);
+        zs.next_in = in.data();
+        zs.avail_in = in.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        is.write(zs, Flush::sync, ec);
+        out.resize(zs.total_out);
+    }
+
+    // One call over a large input takes the inflate_fast path
+    // for nearly all of it, including the wide refill and the
+    // chunked match copies.
+    void
+    testRoundtrip()
+    {
+        std::size_t const size = 256 * 1024;
+        for(auto const& check :
+                {corpus1(size), corpus2(size), corpus3(size)})
+        {
+            auto const in = z_deflator{}(check);
+            std::string out(check.size(), 0);
+            inflate_beast(in, out);
+            BEAST_EXPECT(out == check);
+        }
+    }
+
     void
     run() override
     {
@@ -403,6 +438,7 @@ public:
             "sizeof(inflate_stream) == " <<
             sizeof(inflate_stream) << std::endl;
         testInflate();
+        testRoundtrip();
     }
 };
 
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/zlib/inflate_stream.hpp>
+
+#include "ztest.hpp"
+#include <beast/unit_test/suite.hpp>
+#include <chrono>
+#include <cstring>
+
+namespace beast {
+namespace zlib {
+
+class inflate_stream_bench_test : public beast::unit_test::suite
+{
+public:
+    // Decompress with zlib in one call
+    static
+    void
+    inflate_zlib(std::string const& in, std::string& out)
+    {
+        ::z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        inflateInit2(&zs, -15);
+        zs.next_in = (Bytef*)in.data();
+        zs.avail_in = static_cast<uInt>(in.size());
+        zs.next_out = (Bytef*)&out[0];
+        zs.avail_out = static_cast<uInt>(out.size());
+        inflate(&zs, Z_SYNC_FLUSH);
+        out.resize(zs.total_out);
+        inflateEnd(&zs);
+    }
+
+    // Decompress with beast in one call
+    static
+    void
+    inflate_beast(std::string const& in, std::string& out)
+    {
+        z_params zs;
+        inflate_stream is;
+        is.reset(15);
+        zs.next_in = in.data();
+        zs.avail_in = in.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        is.write(zs, Flush::sync, ec);
+        out.resize(zs.total_out);
+    }
+
+    void
+    testSpeed()
+    {
+        using namespace std::chrono;
+        using clock_type = steady_clock;
+        std::size_t const size = 1024 * 1024;
+        std::size_t const repeat = 20;
+        auto const run =
+            [&](char const* label, std::string const& check)
+            {
+                auto const in = z_deflator{}(check);
+                auto const report =
+                    [&](char const* name, void (*f)(
+                        std::string const&, std::string&))
+                    {
+                        std::string out;
+                        auto const t0 = clock_type::now();
+                        for(std::size_t i = 0; i < repeat; ++i)
+                        {
+                            out.assign(check.size(), 0);
+                            f(in, out);
+                        }
+                        auto const us = duration_cast<microseconds>(
+                            clock_type::now() - t0).count();
+                        BEAST_EXPECT(out == check);
+                        log <<
+                            label << " " << name << ": " <<
+                            (us > 0 ? static_cast<double>(
+                                size * repeat) / us : 0) <<
+                            " MB/s" << std::endl;
+                    };
+                report("beast", &inflate_beast);
+                report("zlib ", &inflate_zlib);
+            };
+        run("corpus1", corpus1(size));
+        run("corpus2", corpus2(size));
+        run("corpus3", corpus3(size));
+    }
+
+    void
+    run() override
+    {
+        testSpeed();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(inflate_stream_bench,zlib,beast);
+
+} // zlib
+} // beast
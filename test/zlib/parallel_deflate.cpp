@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Test that header file is self-contained.
+#include <beast/zlib/parallel_deflate.hpp>
+
+#include "ztest.hpp"
+#include <beast/core/to_string.hpp>
+#include <beast/core/streambuf.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/zlib/detail/adler32.hpp>
+#include <beast/zlib/detail/crc32.hpp>
+
+namespace beast {
+namespace zlib {
+
+class parallel_deflate_test : public beast::unit_test::suite
+{
+public:
+    void
+    check(parallel_deflate& pd, std::string const& s)
+    {
+        streambuf sb;
+        error_code ec;
+        pd.compress(s.data(), s.size(), sb, ec);
+        if(! BEAST_EXPECTS(! ec, ec.message()))
+            return;
+        z_inflator zi;
+        BEAST_EXPECT(zi(to_string(sb.data())) == s);
+        BEAST_EXPECT(pd.crc32() ==
+            detail::crc32(0, s.data(), s.size()));
+        BEAST_EXPECT(pd.adler32() ==
+            detail::adler32(1, s.data(), s.size()));
+    }
+
+    void
+    testCompress()
+    {
+        std::size_t const bs = 4096;
+        auto const s1 = corpus1(10 * bs + 123);
+        auto const s2 = corpus2(10 * bs + 123);
+        for(std::size_t threads : {1, 2, 4})
+        {
+            for(int level : {0, 1, 6, 9})
+            {
+                parallel_deflate pd{threads, level, bs};
+                BEAST_EXPECT(pd.threads() == threads);
+                for(std::size_t n : {
+                    std::size_t{0}, std::size_t{1},
+                    bs - 1, bs, bs + 1, 3 * bs, s1.size()})
+                {
+                    check(pd, s1.substr(0, n));
+                    check(pd, s2.substr(0, n));
+                }
+            }
+        }
+    }
+
+    void
+    testGzip()
+    {
+        // Frame the raw stream and inflate it with zlib
+        auto const s = corpus1(1000000);
+        parallel_deflate pd{4};
+        streambuf sb;
+        pd.compress(s.data(), s.size(), sb);
+        std::string in{
+            "\x1f\x8b\x08\x00" "\x00\x00\x00\x00" "\x00\x03", 10};
+        in.append(to_string(sb.data()));
+        auto const put =
+            [&](std::uint32_t v)
+            {
+                for(int i = 0; i < 4; ++i)
+                    in.push_back(static_cast<char>(
+                        (v >> (8 * i)) & 0xff));
+            };
+        put(pd.crc32());
+        put(static_cast<std::uint32_t>(s.size()));
+
+        std::string out;
+        out.resize(s.size() + 1);
+        ::z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        BEAST_EXPECT(inflateInit2(&zs, 31) == Z_OK);
+        zs.next_in = (Bytef*)&in[0];
+        zs.avail_in = static_cast<uInt>(in.size());
+        zs.next_out = (Bytef*)&out[0];
+        zs.avail_out = static_cast<uInt>(out.size());
+        BEAST_EXPECT(inflate(&zs, Z_FINISH) == Z_STREAM_END);
+        out.resize(zs.total_out);
+        inflateEnd(&zs);
+        BEAST_EXPECT(out == s);
+    }
+
+    void
+    run() override
+    {
+        testCompress();
+        testGzip();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(parallel_deflate,zlib,beast);
+
+} // zlib
+} // beast
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2013-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <beast/zlib/parallel_deflate.hpp>
+
+#include "ztest.hpp"
+#include <beast/core/streambuf.hpp>
+#include <beast/core/to_string.hpp>
+#include <beast/unit_test/suite.hpp>
+#include <beast/zlib/deflate_stream.hpp>
+#include <beast/zlib/inflate_stream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace beast {
+namespace zlib {
+
+/*  Speedup of parallel_deflate over deflate_stream.
+
+    Inputs of each power of two megabytes up to the largest
+    size, and the largest size itself, are compressed
+    with deflate_stream and with parallel_deflate using each
+    power of two number of threads, and each result is checked
+    by inflating it.
+
+    The largest size in megabytes defaults to a size suitable
+    for every test run. Pass a larger number as the argument
+    string, for example `--arg=256`.
+*/
+class parallel_deflate_bench_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t constexpr default_megabytes = 4;
+
+    static
+    std::size_t
+    elapsed(clock_type::time_point when)
+    {
+        return static_cast<std::size_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                clock_type::now() - when).count());
+    }
+
+    // Returns `true` if in decompresses to the first n bytes of s
+    static
+    bool
+    inflates_to(std::string const& in,
+        std::string const& s, std::size_t n)
+    {
+        std::string out;
+        out.resize(n + 1);
+        inflate_stream is;
+        is.reset(15);
+        z_params zs;
+        zs.next_in = in.data();
+        zs.avail_in = in.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        is.write(zs, Flush::sync, ec);
+        if(ec && ec != error::end_of_stream)
+            return false;
+        return zs.total_out == n &&
+            out.compare(0, n, s, 0, n) == 0;
+    }
+
+    void
+    measure(std::string const& s, std::size_t n)
+    {
+        testcase << (n / (1024 * 1024)) << "MB";
+        {
+            deflate_stream ds;
+            ds.reset(6, 15, 8, Strategy::normal);
+            std::string out;
+            out.resize(ds.upper_bound(n));
+            z_params zs;
+            zs.next_in = s.data();
+            zs.avail_in = n;
+            zs.next_out = &out[0];
+            zs.avail_out = out.size();
+            error_code ec;
+            auto const when = clock_type::now();
+            ds.write(zs, Flush::finish, ec);
+            auto const ms = elapsed(when);
+            BEAST_EXPECT(ec == error::end_of_stream);
+            out.resize(zs.total_out);
+            BEAST_EXPECT(inflates_to(out, s, n));
+            log <<
+                "deflate_stream: " << zs.total_out << " bytes, " <<
+                ms << "ms" << std::endl;
+        }
+        std::size_t const threads = (std::max)(1u,
+            std::thread::hardware_concurrency());
+        for(std::size_t i = 1; i <= threads; i *= 2)
+        {
+            parallel_deflate pd{i};
+            streambuf sb;
+            error_code ec;
+            auto const when = clock_type::now();
+            pd.compress(s.data(), n, sb, ec);
+            auto const ms = elapsed(when);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            BEAST_EXPECT(inflates_to(to_string(sb.data()), s, n));
+            log <<
+                "parallel_deflate, " << i << " threads: " <<
+                sb.size() << " bytes, " << ms << "ms" <<
+                std::endl;
+        }
+    }
+
+    void
+    run() override
+    {
+        std::size_t megabytes = default_megabytes;
+        if(! arg().empty())
+            megabytes = static_cast<std::size_t>(
+                std::strtoull(arg().c_str(), nullptr, 10));
+        if(megabytes == 0)
+            megabytes = default_megabytes;
+        auto const s = corpus1(megabytes * 1024 * 1024);
+        for(std::size_t n = 1; n < megabytes; n *= 2)
+            measure(s, n * 1024 * 1024);
+        measure(s, megabytes * 1024 * 1024);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(parallel_deflate_bench,zlib,beast);
+
+} // zlib
+} // beast
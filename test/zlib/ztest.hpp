@@ -10,7 +10,9 @@
 
 #include "zlib-1.2.8/zlib.h"
 #include <cstdint>
+#include <cstring>
 #include <random>
+#include <stdexcept>
 #include <string>
 
 class z_deflator
@@ -164,4 +166,35 @@ corpus2(std::size_t n)
     return s;
 }
 
+// Text, words from a small vocabulary
+inline
+std::string
+corpus3(std::size_t n)
+{
+    static char const* const words[] = {
+        "the", "of", "and", "to", "in", "is", "that", "for",
+        "it", "as", "was", "with", "be", "by", "on", "not",
+        "he", "this", "are", "or", "his", "from", "at", "which",
+        "but", "have", "an", "had", "they", "you", "were", "their",
+        "one", "all", "we", "can", "her", "has", "there", "been",
+        "message", "stream", "buffer", "socket", "handler", "request",
+        "response", "header", "field", "value", "connection", "server",
+        "client", "frame", "payload", "compress", "window", "length",
+        "{\"id\":", "\"name\":", "\"type\":", "\"data\":", "},", "\n"
+    };
+    std::size_t const count = sizeof(words) / sizeof(words[0]);
+    std::string s;
+    s.reserve(n + 32);
+    std::mt19937 g;
+    // Favor the first words, like real text
+    std::geometric_distribution<std::size_t> d0{0.08};
+    while(s.size() < n)
+    {
+        s.append(words[d0(g) % count]);
+        s.push_back(' ');
+    }
+    s.resize(n);
+    return s;
+}
+
 #endif